@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol.h"
+
+// ⏱️ LoRa time on air — Semtech SX1276 datasheet §4.1.1.6/7 (AN1200.13)
+//   Tsym      = 2^SF / BW
+//   Npayload  = 8 + max(ceil((8·PL − 4·SF + 28 + 16·CRC − 20·IH) / (4·(SF − 2·DE))) · (CR + 4), 0)
+//   T         = (Npreamble + 4.25 + Npayload) · Tsym
+// `cr` is the 4/x denominator (5..8) as passed to LoRa.setCodingRate4(), i.e. CR + 4.
+// Single-return constexpr so the ESP32 toolchain (gnu++11) folds it at compile time.
+
+constexpr uint32_t loraSymbolUs(int sf, long bw) {
+  return (uint32_t)((1000000ULL << sf) / (unsigned long long)bw);
+}
+
+// 🐢 Low data rate optimize — sandeepmistry/LoRa turns it on above 16 ms per symbol
+constexpr bool loraLowDataRate(int sf, long bw) {
+  return loraSymbolUs(sf, bw) > 16000;
+}
+
+constexpr int loraCeilPositive(int num, int den) {
+  return num > 0 ? (num + den - 1) / den : 0;
+}
+
+constexpr int loraPayloadSymbols(size_t len, int sf, long bw, int cr, bool crc, bool implicitHeader) {
+  return 8 + loraCeilPositive(8 * (int)len - 4 * sf + 28 + (crc ? 16 : 0) - (implicitHeader ? 20 : 0),
+                              4 * (sf - (loraLowDataRate(sf, bw) ? 2 : 0))) * cr;
+}
+
+// Whole frame in µs; preamble counted in quarter symbols to keep the 4.25 exact
+constexpr uint32_t loraAirtimeUs(size_t len, int sf, long bw, int cr, long preamble, bool crc = true,
+                                 bool implicitHeader = false) {
+  return (uint32_t)(((unsigned long long)(4 * preamble + 17 + 4 * loraPayloadSymbols(len, sf, bw, cr, crc, implicitHeader)) *
+                     (1000000ULL << sf)) / (4ULL * (unsigned long long)bw));
+}
+
+// 📏 Fixed-size frames without the LoRa header (protocol_implicit.h) — off until
+// the flight board is configured for it too
+#ifndef CMD_IMPLICIT_HEADER
+#define CMD_IMPLICIT_HEADER 0
+#endif
+
+// 📡 Airtime of one frame at the shared protocol.h radio settings (CRC on)
+constexpr uint32_t protoAirtimeUs(size_t len, bool implicitHeader = false) {
+  return loraAirtimeUs(len, PROTO_LORA_SF, PROTO_LORA_BANDWIDTH_HZ, PROTO_LORA_CR, PROTO_LORA_PREAMBLE, true,
+                       implicitHeader);
+}
+
+constexpr uint32_t LORA_CMD_AIRTIME_US = protoAirtimeUs(PROTO_CMD_PACKET_SIZE, CMD_IMPLICIT_HEADER);
+constexpr uint32_t LORA_TLM_AIRTIME_US = protoAirtimeUs(PROTO_TLM_PACKET_SIZE, CMD_IMPLICIT_HEADER);
+
+// 📒 Rolling one-second airtime ledger (LoRa_sendPacket() records, HUD / scheduler read)
+// Budget is the share of each second the ground may spend transmitting:
+// the rest of the channel belongs to telemetry. Use 10 (1 %) on EU868.
+#ifndef LORA_AIRTIME_BUDGET_PERMILLE
+#define LORA_AIRTIME_BUDGET_PERMILLE 500
+#endif
+#define LORA_AIRTIME_BUDGET_US (LORA_AIRTIME_BUDGET_PERMILLE * 1000UL)  // µs of TX per second
+#define AIRTIME_LEDGER_BUCKETS 10                                    // 100 ms resolution
+
+void airtimeRecord(uint32_t us);  // One transmitted frame
+uint32_t airtimeUsedUs();         // TX time over the last second
+uint32_t airtimeRemainingUs();    // Budget left over the last second (0 when over)
+void airtimeReset();              // Empty ledger (radioInit())
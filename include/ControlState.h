@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// 🎮 Pilot control state shared by the BT task (notify), loop() (throttle),
+// LoRaTask (loraLoop) and DisplayTask (drawFrame*).
+//
+// Published through a seqlock: readers copy a consistent snapshot without
+// ever blocking (they retry if a write overlapped), writers are serialized
+// by a tiny spinlock so notify() and loop() can both publish.
+//
+// Discrete commands are monotonic counters instead of one-shot flags, so the
+// LoRa side detects "new since last TX" without ever writing back. Trim is
+// kept once, as an absolute offset: one-shot steps are the difference from
+// what is already on air.
+struct ControlState {
+  uint16_t engine;          // 🚀 Raw throttle 0..PROTO_ENGINE_RAW_MAX (slider / R2)
+  uint8_t aileron;          // ↔️ Raw stick 0..255 (127 = center)
+  uint8_t rudder;           // ↔️ Raw stick 0..255
+  uint8_t elevators;        // ↕️ Raw stick 0..255
+  uint8_t flaps;            // 🪶 0..4
+  uint8_t stabilityAssist;  // 🛡️ L2 analog 0..255
+  bool emergencyStop;       // 🚨 Engine cut
+  bool airbrake;            // 🛑 Airbrake
+  bool acsEngage;           // 🤖 ACS autopilot engage
+  bool ecoMode;             // 🌿 Suppress duplicate packets
+  bool flightTimerRunning;  // ⏱️ Armed
+  uint8_t resetAileronCount;   // 🔄 L3 presses since boot
+  uint8_t resetElevatorCount;  // 🔄 R3 presses since boot
+  uint8_t hudPageCount;        // 🖥️ Options presses since boot (DisplayTask flips frames)
+  int8_t elevatorTrim;         // ⚖️ D-pad up/down steps since the last R3, clamped (protocol_trim.h)
+  int8_t aileronTrim;          // ⚖️ D-pad right/left steps since the last L3
+  uint32_t flightTimerStartMs;  // ⏱️ millis() when armed
+};
+
+void controlInit();                      // Publish the power-on defaults (STOP, sticks centered)
+ControlState controlSnapshot();          // Lock-free, consistent copy
+ControlState& controlBeginWrite();       // Serialize writers, open the write window
+void controlEndWrite();                  // Close the write window (publishes)
+uint32_t controlRetryCount();            // 📊 Reader retries caused by overlapping writes
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol_rate.h"
+
+// 📶 Adaptive data rate, ground side (protocol_rate.h), owned by LoRaTask
+// Every telemetry frame gives one link-margin sample, the worst of
+//   downlink SNR − demodulator floor (−7.5 dB at SF7, 2.5 dB lower per SF)
+//   downlink RSSI − sensitivity (−174 + 10·log10(BW) + noise figure + floor)
+//   uplink RSSI the air reports (tlm_rssi) − the same sensitivity
+// smoothed by an EWMA. A step up the ladder gives away sensitivity (2.5 dB
+// per SF, 3 dB per bandwidth doubling), so:
+//   up    when margin − that cost ≥ DATA_RATE_TARGET_MARGIN_DB + DATA_RATE_HYSTERESIS_DB
+//         on DATA_RATE_UP_FRAMES telemetry frames in a row
+//   down  when the smoothed margin < DATA_RATE_TARGET_MARGIN_DB
+// One switch in flight at a time; the radio retunes when the air acks it, and
+// the PROTO_RATE_FALLBACK_MS silence timer takes it back to profile 0. A
+// request that telemetry keeps coming back without acking (flight board
+// without ADR) is dropped and retried after DATA_RATE_RETRY_MS.
+// On a faster profile the command period and TDMA slots shrink with the
+// airtime, so the same channel share carries more commands.
+// Needs PROTO_BIDIRECTIONAL and reliable trailers (CMD_RELIABLE).
+
+#ifndef DATA_RATE_ADAPTIVE
+#define DATA_RATE_ADAPTIVE 0  // 📶 Off until the flight board follows PROTO_REL_OP_RATE
+#endif
+#ifndef DATA_RATE_TARGET_MARGIN_DB
+#define DATA_RATE_TARGET_MARGIN_DB 8.0f  // Fade margin kept on whatever profile is in use
+#endif
+#ifndef DATA_RATE_HYSTERESIS_DB
+#define DATA_RATE_HYSTERESIS_DB 4.0f  // Extra margin a step up must leave (no ping-pong)
+#endif
+#ifndef DATA_RATE_UP_FRAMES
+#define DATA_RATE_UP_FRAMES 20  // ~1 s of telemetry at PROTO_CMD_INTERVAL_MS
+#endif
+#ifndef DATA_RATE_UNACKED_FRAMES
+#define DATA_RATE_UNACKED_FRAMES 8  // Telemetry frames without the ack → the air ignores the op
+#endif
+#ifndef DATA_RATE_RETRY_MS
+#define DATA_RATE_RETRY_MS 5000
+#endif
+#define DATA_RATE_EWMA_ALPHA 0.25f
+#define DATA_RATE_NOISE_FIGURE_DB 6.0f  // SX1276 LNA
+
+struct DataRateStats {
+  uint32_t samples;       // Margin samples (telemetry frames)
+  uint32_t requests;      // Switches asked for
+  uint32_t upSwitches;    // Acked and retuned
+  uint32_t downSwitches;
+  uint32_t fallbacks;     // 🛟 Silence → profile 0
+  uint32_t unacked;       // Requests dropped: telemetry kept coming, no ack
+  uint32_t timeOnProfileMs[PROTO_RATE_MAX_PROFILES];
+};
+
+void dataRateReset(uint32_t nowMs);  // Profile 0, nothing pending (radio configured from protocol.h)
+void dataRateSetAdaptive(bool on);   // Build-time default DATA_RATE_ADAPTIVE
+bool dataRateAdaptive();
+
+// parseTelemetry(): ground-measured packet RSSI / SNR, air-reported uplink RSSI (≥ 0 = unknown)
+void dataRateOnTelemetry(int16_t rssi, float snr, int airRssi, uint32_t nowMs);
+void dataRateUpdate(uint32_t nowMs, bool canRequest);  // Every LoRaTask run: requests, fallback
+int dataRatePendingSwitch();                           // Profile to retune to now (−1 = none)
+void dataRateSwitched(uint32_t nowMs);                 // ...the radio is on it
+
+uint8_t dataRateProfileIndex();
+ProtoRateProfile dataRateProfile();  // Current
+float dataRateMarginDb();            // Smoothed, current profile (0 before any telemetry)
+float dataRateSensitivityDbm(const ProtoRateProfile& p);
+uint32_t dataRateAirtimeUs(size_t len, bool implicitHeader);  // On the current profile
+uint32_t dataRateTlmSlotUs(bool implicitHeader);              // 🗓️ TDMA_TLM_SLOT_US on the current profile
+uint32_t dataRateIntervalMs(uint32_t baseMs);  // Command period sized for profile 0 → current profile
+
+const DataRateStats& dataRateStats();
+void dataRatePrintReport();  // 📊 Profile, margin and switches over Serial
@@ -17,6 +17,7 @@ void drawFrame1(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int1
 // Besides the default fonts there will be a program to convert TrueType fonts into this format
 void drawFrame2(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int16_t y);
 
+// 🩺 Round-trip / latency diagnostics
 void drawFrame3(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int16_t y);
 
 // Demo for drawStringMaxWidth:
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "ControlState.h"
+
+// 🎚️ Noise-aware change detection (ECO mode, LoRaTask before constructMessage())
+// One LSB of stick / ADC noise changes the packet and defeats duplicate
+// suppression, so each analog axis is quantized first:
+//   center snap  |raw − center| ≤ INPUT_DEADBAND → exactly center
+//   end snap     within the hysteresis of either end → exactly 0 / full scale
+//   hysteresis   output holds until the input moves more than the band away
+// Real inputs pass through unchanged once they leave the band, so the output
+// never lags the stick by more than the band width.
+
+#ifndef INPUT_DEADBAND
+#define INPUT_DEADBAND 3  // 🎯 Raw stick units around center (127 / 128)
+#endif
+#ifndef INPUT_HYSTERESIS
+#define INPUT_HYSTERESIS 2  // 🎮 Raw stick / trigger units
+#endif
+#ifndef INPUT_ENGINE_HYSTERESIS
+#define INPUT_ENGINE_HYSTERESIS 24  // 🚀 Raw throttle units (12-bit slider ADC)
+#endif
+
+void inputFilterReset();
+void inputFilterApply(ControlState& cs);  // Quantize sticks, throttle and L2 in place
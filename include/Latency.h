@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ⏱️ Stick-to-antenna latency instrumentation
+// Timestamps (micros()) are taken at every hop of the control path:
+//   L2CAP data_ind → parsePacket → _event_callback → notify() → constructMessage() → LoRa_sendPacket()
+// and each hop lands in a fixed-bucket histogram (no heap, O(1) record).
+
+enum LatencyStage : uint8_t {
+  LAT_BT_TO_PARSE = 0,   // 🔵 L2CAP data indication → parser done
+  LAT_PARSE_TO_EVENT,    // 🔵 parser → ps5Controller event callback
+  LAT_EVENT_TO_NOTIFY,   // 🎮 event callback → notify() accepted the report
+  LAT_NOTIFY_TO_BUILD,   // 📦 notify() → constructMessage() picked it up
+  LAT_BUILD_TO_TX,       // 📡 constructMessage() → LoRa_sendPacket()
+  LAT_STICK_TO_AIR,      // 🛩️ end to end: L2CAP data indication → LoRa_sendPacket()
+  LAT_ESTOP_TO_AIR,      // 🚨 priority lane: Circle press report → first priority frame on air
+  LAT_ROUND_TRIP,        // 🔁 command sent → echoed in telemetry, air hold time removed (LinkQuality.h)
+  LAT_STAGE_COUNT
+};
+
+// Log-linear buckets: 4 sub-buckets per power of two → ≤25% bucket width,
+// covering 0 µs … 2^24 µs (~16.7 s); larger samples clamp into the last bucket.
+#define LAT_SUB_BUCKET_BITS 2
+#define LAT_MAX_EXPONENT 24
+#define LAT_BUCKETS ((LAT_MAX_EXPONENT - 1) << LAT_SUB_BUCKET_BITS)
+
+struct LatencyHistogram {
+  uint32_t buckets[LAT_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+};
+
+uint16_t latencyBucketIndex(uint32_t us);    // Sample → bucket
+uint32_t latencyBucketUpperUs(uint16_t idx);  // Bucket → inclusive upper bound (µs)
+
+void latencyRecord(LatencyStage stage, uint32_t us);
+uint32_t latencyPercentile(LatencyStage stage, uint8_t pct);  // Upper bound of the bucket holding pct
+const LatencyHistogram& latencyHistogram(LatencyStage stage);
+void latencyReset();
+
+// 🔗 Trace hooks along the control path
+void latencyMarkInput(uint32_t rxUs, uint32_t parseUs, uint32_t eventUs, uint32_t notifyUs, bool sticksMoved);
+void latencyMarkBuild();  // constructMessage()
+void latencyMarkSent();   // LoRa_sendPacket()
+void latencyMarkPriorityInput(uint32_t rxUs);  // notify(): e-stop / disarm press
+void latencyMarkPrioritySent();                // First priority-lane frame on air
+
+#define LATENCY_REPORT_INTERVAL_MS 5000  // 📊 Serial report cadence
+
+void latencyPrintReport();  // 📊 p50/p99/max per stage over Serial
+void latencyPrintCsv();     // 📄 stage,bucket_upper_us,count for every non-empty bucket (send 'c' on Serial)
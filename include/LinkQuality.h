@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+// 📶 Link quality estimator (both directions)
+// ProtoCmdPacket / ProtoTlmPacket carry no sequence counter, so each side
+// appends a small trailer after the protocol.h frame (LoRa CRC covers it):
+//   uplink    frame | upSeq                 (every frame LoRa_sendPacket() sends)
+//   telemetry frame | tlmSeq | echoed upSeq | echo age | ackId | ackMask
+//     echoed upSeq = last uplink frame the air heard
+//     echo age     = ms the air held it before this telemetry went out (0xFF = unknown)
+//     ackId/Mask   = 🔁 reliable-command acks (protocol_reliable.h, 0 / 0 = none)
+// The air side answers each uplink frame it hears with one telemetry frame
+// (TDMA), so between two telemetry frames:
+//   g = tlmSeq advance  → g − 1 telemetry frames lost, g uplink frames heard
+//   d = echo advance    → d uplink frames sent, d − g of them lost
+// Telemetry without the trailer still feeds the inter-arrival jitter.
+//
+// ⏱️ Round trip without clock sync: the ground remembers when it sent each
+// upSeq (micros()), so for every new echo
+//   RTT = telemetry arrival − upSeq sent − echo age
+// i.e. both times on air plus turnarounds, the air side's hold time removed.
+// Samples land in the LAT_ROUND_TRIP latency histogram.
+// Sequence numbers are 8 bit: gaps of 256+ frames alias (the link-lost
+// timeout covers those).
+
+#ifndef LINK_SEQ_TRAILER
+#define LINK_SEQ_TRAILER 0  // 📶 Append upSeq to uplink frames (flight board must strip it)
+#endif
+#define LINK_UP_TRAILER_SIZE 1
+#define LINK_TLM_TRAILER_SIZE 5
+#define LINK_ECHO_AGE_UNKNOWN 0xFF
+#define LINK_RTT_HISTORY 32  // Send times kept for echo matching (older echoes are dropped)
+
+#ifndef LINK_LOSS_EWMA_ALPHA
+#define LINK_LOSS_EWMA_ALPHA 0.05f  // ~20-frame memory
+#endif
+
+struct LinkDirection {
+  uint32_t received;
+  uint32_t lost;
+  float lossEwma;     // 0..1, per frame
+  uint16_t burst;     // Current run of consecutive losses
+  uint16_t maxBurst;  // Longest run since reset
+};
+
+struct LinkQuality {
+  LinkDirection down;       // Air → Ground telemetry
+  LinkDirection up;         // Ground → Air commands (from the echoed upSeq)
+  uint32_t meanIntervalUs;  // Telemetry inter-arrival (EWMA)
+  uint32_t jitterUs;        // EWMA |inter-arrival − mean|
+  bool sequenced;           // Telemetry carries the trailer
+  uint32_t lastRttUs;       // Latest round trip (0 = none yet)
+  uint8_t lastEchoAgeMs;    // Air-side hold time reported with it
+};
+
+void linkQualityReset();
+uint8_t linkUplinkSeq();  // Stamp for the next uplink frame
+void linkUplinkSent();    // That frame is on air (stamps its send time)
+// parseTelemetry()
+void linkOnTelemetry(uint32_t arrivalUs, bool sequenced, uint8_t tlmSeq, uint8_t echoSeq, uint8_t echoAgeMs);
+const LinkQuality& linkQuality();  // Word-sized fields, diagnostics only (HUD / Serial)
+void linkQualityPrintReport();     // 📊 Loss, bursts and jitter over Serial
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+
+// 📡 Half-duplex radio state machine (owned by LoRaTask)
+//   IDLE ──send──▶ TX ──DIO0 TX done──▶ RX_WINDOW (PROTO_BIDIRECTIONAL) / IDLE
+//   RX_WINDOW ──send──▶ TX            (listening is cut short, never a TX)
+// A send requested while TX is on air is deferred until TX done instead of
+// calling beginPacket(), which would put the SX1276 in standby mid-frame.
+
+enum class RadioState : uint8_t {
+  IDLE = 0,   // 💤 Standby
+  TX,         // 📡 Async TX on air, waiting for DIO0 TX done
+  RX_WINDOW,  // 📥 Continuous RX for telemetry
+  LBT,        // 👂 Frame held: CAD running or backing off before its TX
+};
+
+// 🔌 Direct SX1276 register access (SX1276.h): burst FIFO transfers and cached
+// config writes instead of the library's one transaction per register access.
+// setupRadio() picks the path; DIO0 dispatch stays with the library either way.
+#ifndef RADIO_DIRECT_SPI
+#define RADIO_DIRECT_SPI 0
+#endif
+
+// ⚡ The same driver on the ESP-IDF spi_master: FIFO loads / drains move by
+// DMA while LoRaTask carries on, and the driver owns DIO0 (implies RADIO_DIRECT_SPI)
+#ifndef RADIO_SPI_DMA
+#define RADIO_SPI_DMA 0
+#endif
+
+// 👂 Listen before talk: CAD before each uplink frame, random backoff (window
+// doubling from LBT_BACKOFF_MIN_US up to LBT_BACKOFF_MAX_US) while another
+// transmitter is on the channel. A frame is never held past LBT_MAX_DELAY_US
+// after LoRa_sendPacket(): at its deadline it goes out, busy or not. Priority-
+// lane frames skip it, and a burst starting during a hold sends the held frame
+// at once instead of waiting out the backoff.
+#ifndef RADIO_LBT
+#define RADIO_LBT 0
+#endif
+
+#ifndef LBT_MAX_DELAY_US
+#define LBT_MAX_DELAY_US 10000
+#endif
+
+#ifndef LBT_BACKOFF_MIN_US
+#define LBT_BACKOFF_MIN_US 1000
+#endif
+
+#ifndef LBT_BACKOFF_MAX_US
+#define LBT_BACKOFF_MAX_US 4000
+#endif
+
+#ifndef RADIO_TX_TIMEOUT_MS
+#define RADIO_TX_TIMEOUT_MS 500  // ⏱️ No TX done by then → DIO0 missed, recover to IDLE
+#endif
+
+struct RadioStats {
+  uint32_t txStarted;        // endPacket(true) issued
+  uint32_t txCompleted;      // DIO0 TX done while in TX
+  uint32_t txDeferred;       // Command slot hit an in-flight TX → sent on TX done
+  uint32_t slotDeferred;     // Command held back until the telemetry slot closed
+  uint32_t txMerged;         // Command tick while one was still pending: one frame carries both
+  uint32_t txTimeouts;       // TX done never arrived (RADIO_TX_TIMEOUT_MS)
+  uint32_t rxPreempted;      // RX window closed by a TX
+  uint32_t rxOutsideWindow;  // RX done while not listening (should stay 0)
+  uint32_t spuriousTxDone;   // TX done while not transmitting (should stay 0)
+  uint32_t priorityTx;       // 🚨 Priority-lane frames sent
+  uint32_t heartbeats;       // 💓 Keepalives sent in place of suppressed duplicates
+  uint32_t parityTx;         // 🧩 XOR parity frames sent (CMD_FEC_GROUP)
+  uint32_t implicitRejected; // 📏 Frames of another length refused in implicit-header mode
+  uint32_t aggSamples;       // 🧺 Older stick samples packed into command frames
+  uint32_t cadRuns;          // 👂 CAD before a TX (RADIO_LBT)
+  uint32_t cadBusy;          // ... that detected another transmitter
+  uint32_t lbtHeld;          // Frames that waited for the channel
+  uint32_t lbtForced;        // ... and went out at their deadline, channel still busy
+  uint32_t lbtCutShort;      // ... or at once, ahead of a priority burst
+  uint32_t lbtDelayMaxUs;    // Longest LoRa_sendPacket() → TX
+};
+
+void radioInit();                 // Attach DIO0 handlers, reset state (setupRadio())
+RadioState radioState();
+const RadioStats& radioStats();
+const char* radioStateName(RadioState s);
+// 📏 Implicit-header framing (CMD_IMPLICIT_HEADER, switchable for tests): every
+// uplink frame is PROTO_CMD_PACKET_SIZE, delta / parity / reliable trailers pause
+void radioSetImplicitHeader(bool on);
+bool radioImplicitHeader();
+// 🔌 RADIO_DIRECT_SPI, switchable for tests (takes effect at the next setupRadio())
+void radioSetDirectSpi(bool on);
+bool radioDirectSpi();
+// ⚡ RADIO_SPI_DMA, same (on → direct SPI too, radioSetDirectSpi(false) → off)
+void radioSetSpiDma(bool on);
+bool radioSpiDma();
+// 👂 RADIO_LBT, switchable for tests
+void radioSetListenBeforeTalk(bool on);
+bool radioListenBeforeTalk();
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "ControlState.h"
+#include "protocol.h"
+
+// 🌿 Adaptive command rate (ECO mode)
+// Instead of a fixed PROTO_CMD_INTERVAL_MS, LoRaTask asks the controller for
+// the next command period on every TX tick:
+//   stick activity = Σ |Δaxis| per second over aileron / elevators / rudder / throttle,
+//                    fast attack, exponential decay (RATE_DECAY_MS) once the sticks settle
+//   period         = RATE_MAX_INTERVAL_MS at rest → RATE_MIN_INTERVAL_MS at RATE_ACTIVITY_FULL
+// A discrete command (trim, reset, flaps, switches) counts as full activity so
+// it goes out at the fast rate. The period never drops below what the airtime
+// budget (and the TDMA frame) allows, and it stretches when the ledger runs low.
+// Shrinking is immediate, growing is limited to RATE_GROW_PERCENT per tick.
+// With ECO off the period stays at PROTO_CMD_INTERVAL_MS.
+
+#ifndef RATE_MIN_INTERVAL_MS
+#define RATE_MIN_INTERVAL_MS (PROTO_CMD_INTERVAL_MS / 2)  // ⚡ Maneuvering (clamped to the floor below)
+#endif
+#ifndef RATE_MAX_INTERVAL_MS
+#define RATE_MAX_INTERVAL_MS (PROTO_CMD_INTERVAL_MS * 4)  // 🌿 Cruise — keep well inside the air failsafe
+#endif
+#ifndef RATE_ACTIVITY_FULL
+#define RATE_ACTIVITY_FULL 400  // 🎮 Raw stick units/s that earn the fastest rate
+#endif
+#ifndef RATE_DECAY_MS
+#define RATE_DECAY_MS 400  // ⏱️ Activity time constant once the sticks settle
+#endif
+#ifndef RATE_GROW_PERCENT
+#define RATE_GROW_PERCENT 25  // 📈 Max period growth per tick (smooth slow-down)
+#endif
+
+void rateControlReset(uint32_t nowMs);
+// Next command period from one controller snapshot and the ledger's headroom
+uint32_t rateControlUpdate(const ControlState& cs, uint32_t nowMs, uint32_t airtimeLeftUs);
+uint32_t rateControlIntervalMs();  // Period picked by the last update
+uint32_t rateControlActivity();    // Smoothed stick activity (units/s)
+uint32_t rateControlFloorMs();     // Fastest period the airtime budget / TDMA frame allow
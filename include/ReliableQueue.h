@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ControlState.h"
+#include "protocol_reliable.h"
+
+// 🔁 Reliable discrete-command queue (protocol_reliable.h), owned by LoRaTask
+// One slot per op (no heap, bounded by PROTO_REL_OP_COUNT): a newer value of
+// an op replaces the queued one, so a burst of presses never overflows and the
+// air side always converges on the latest state. Each command frame carries
+// the oldest op that is unsent or past RELIABLE_ACK_TIMEOUT_MS; acks from the
+// telemetry trailer retire ops whose latest send came back. Needs
+// PROTO_BIDIRECTIONAL: without telemetry nothing is ever acked.
+// reliableTrack() derives the pilot-state ops from ControlState; link-control
+// ops (📶 PROTO_REL_OP_RATE) are queued directly by their owner.
+
+#define RELIABLE_STATE_OPS PROTO_REL_OP_FLAPS  // Ops 1..this come from ControlState
+
+#ifndef RELIABLE_ACK_TIMEOUT_MS
+#define RELIABLE_ACK_TIMEOUT_MS (PROTO_CMD_INTERVAL_MS + PROTO_CMD_INTERVAL_MS / 2)  // ⏱️ TLM slot missed → resend
+#endif
+
+struct ReliableStats {
+  uint32_t queued;    // Ops (re)queued by a state change
+  uint32_t sent;      // Trailers sent, first tries
+  uint32_t resent;    // Trailers sent again after the ack timeout
+  uint32_t acked;     // Ops retired by an ack
+  uint32_t maxAckMs;  // Longest queue → ack time
+};
+
+void reliableReset();
+void reliableTrack(const ControlState& cs, uint32_t nowMs);  // Queue ops whose state changed
+void reliableQueueOp(uint8_t op, uint8_t arg, uint32_t nowMs);  // Link-control op, replaces a queued one
+void reliableCancel(uint8_t op);                              // Stop sending it (no ack expected any more)
+bool reliableOpPending(uint8_t op);                           // Queued, not acked yet
+bool reliableDue(uint32_t nowMs);                             // An op wants to go out with the next frame
+size_t reliableTrailer(uint8_t* out, uint32_t nowMs);         // Next trailer (0 = none)
+void reliableTrailerSent(uint32_t nowMs);                     // ...and it made it on air
+void reliableOnAck(uint8_t ackId, uint8_t ackMask, uint32_t nowMs);  // Telemetry trailer
+uint8_t reliablePendingCount();
+const ReliableStats& reliableStats();
+void reliablePrintReport();  // 📊 Queue / resend / ack latency over Serial
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 📡 Thin SX1276 register driver (TTGO LoRa32 V2.1: LORA_CS / LORA_RST on VSPI, common.h)
+// The sandeepmistry library costs one SPI transaction per register access: a
+// 12-byte TX is ~25 transactions (a FIFO write per byte, read-modify-writes
+// for the header mode) and draining telemetry 3 per byte. This driver moves
+// the FIFO in one burst each way and keeps a copy of every mode / config
+// register it wrote, so a write of the value already there is skipped and
+// read-modify-writes need no read. Registers the chip changes on its own
+// (IRQ flags, FIFO pointers, packet status, OP_MODE after TX done) are never
+// cached.
+// DIO0 stays with the library: LoRa.onTxDone() / onReceive() attach the ISR,
+// which reads the IRQ flags and points the FIFO at the received frame before
+// calling back (RADIO_DIRECT_SPI, RadioState.h). LoRaTask only.
+//
+// ⚡ sx1276BeginDma() runs the same driver on the ESP-IDF spi_master instead
+// (RADIO_SPI_DMA): writes and FIFO transfers are queued and move by DMA while
+// the caller carries on — sx1276Transmit() returns before the frame is in the
+// FIFO, sx1276ReadPacket() before it is out — and register reads first wait
+// for the queue (IDF: no polling behind queued transactions). The library's
+// ISR would use Arduino SPI on the same host, so the driver owns DIO0 there:
+// sx1276AttachDio0() + sx1276ServiceDio0().
+
+// Registers (SX1276 datasheet, LoRa mode)
+#define SX1276_REG_FIFO              0x00
+#define SX1276_REG_OP_MODE           0x01
+#define SX1276_REG_FRF_MSB           0x06
+#define SX1276_REG_PA_CONFIG         0x09
+#define SX1276_REG_OCP               0x0B
+#define SX1276_REG_LNA               0x0C
+#define SX1276_REG_FIFO_ADDR_PTR     0x0D
+#define SX1276_REG_FIFO_TX_BASE_ADDR 0x0E
+#define SX1276_REG_FIFO_RX_BASE_ADDR 0x0F
+#define SX1276_REG_FIFO_RX_CURRENT_ADDR 0x10
+#define SX1276_REG_IRQ_FLAGS         0x12
+#define SX1276_REG_RX_NB_BYTES       0x13
+#define SX1276_REG_PKT_SNR_VALUE     0x19
+#define SX1276_REG_PKT_RSSI_VALUE    0x1A
+#define SX1276_REG_MODEM_CONFIG_1    0x1D
+#define SX1276_REG_MODEM_CONFIG_2    0x1E
+#define SX1276_REG_PREAMBLE_MSB      0x20
+#define SX1276_REG_PAYLOAD_LENGTH    0x22
+#define SX1276_REG_MODEM_CONFIG_3    0x26
+#define SX1276_REG_DETECTION_OPTIMIZE 0x31
+#define SX1276_REG_DETECTION_THRESHOLD 0x37
+#define SX1276_REG_SYNC_WORD         0x39
+#define SX1276_REG_DIO_MAPPING_1     0x40
+#define SX1276_REG_VERSION           0x42
+#define SX1276_REG_PA_DAC            0x4D
+
+#define SX1276_MODE_LONG_RANGE 0x80
+#define SX1276_MODE_SLEEP      0x00
+#define SX1276_MODE_STDBY      0x01
+#define SX1276_MODE_TX         0x03
+#define SX1276_MODE_RX_CONT    0x05
+#define SX1276_MODE_CAD        0x07
+
+#define SX1276_IRQ_CAD_DETECTED 0x01  // REG_IRQ_FLAGS
+#define SX1276_IRQ_CAD_DONE  0x04
+#define SX1276_IRQ_TX_DONE   0x08
+#define SX1276_IRQ_CRC_ERROR 0x20
+#define SX1276_IRQ_RX_DONE   0x40
+
+#define SX1276_DIO0_RX_DONE 0x00  // REG_DIO_MAPPING_1
+#define SX1276_DIO0_TX_DONE 0x40
+#define SX1276_DIO0_CAD_DONE 0x80
+
+#define SX1276_SPI_HZ 8000000  // Same clock as the library
+
+#ifndef SX1276_QUEUE_DEPTH
+#define SX1276_QUEUE_DEPTH 12  // ⚡ DMA transactions in flight: a whole TX (7) plus the RX window (5)
+#endif
+
+// ⚡ sx1276OnSpiDone() ops — ISR context, last transaction of the group done
+#define SX1276_OP_TX_LOADED 1  // Frame in the FIFO, TX started
+#define SX1276_OP_RX_READ   2  // sx1276ReadPacket() data and status in place
+
+// ⚙️ setupRadio() parameters (protocol.h PROTO_LORA_*)
+struct Sx1276Config {
+  long frequencyHz;
+  uint8_t spreadingFactor;  // 6..12
+  long bandwidthHz;
+  uint8_t codingRate4;      // 5..8 → 4/5..4/8
+  uint16_t preamble;
+  uint8_t syncWord;
+  int8_t txPowerDbm;        // PA_BOOST, 2..20
+  bool crc;
+};
+
+struct Sx1276Stats {
+  uint32_t transactions;   // CS low → high
+  uint32_t bytes;          // On the bus, address bytes included
+  uint32_t fifoBursts;     // Whole frames moved in one transaction
+  uint32_t writesSkipped;  // Register already held the value
+  uint32_t queued;         // ⚡ Handed to DMA (counted in transactions / bytes too)
+  uint32_t queuedBytes;
+  uint32_t blockedUs;      // Caller waiting on the bus: polled transfers, full / draining queue
+};
+
+bool sx1276Begin(uint8_t csPin, int8_t resetPin);  // Reset, probe, LoRa standby; false = no chip
+// ⚡ Same on the ESP-IDF spi_master (VSPI, DMA); CS driven by the SPI hardware
+bool sx1276BeginDma(uint8_t csPin, int8_t resetPin, uint8_t sck, uint8_t miso, uint8_t mosi);
+void sx1276Configure(const Sx1276Config& c);      // Only registers that change are written
+void sx1276SetSpreadingFactor(uint8_t sf);
+void sx1276SetBandwidth(long hz);
+void sx1276SetTxPower(int8_t dbm);
+
+void sx1276Standby();
+void sx1276Receive(uint8_t implicitLen);  // Continuous RX; 0 = explicit header
+// 📡 frame + tail (e.g. 📶 upSeq) in one FIFO burst, then TX (DIO0 → TX done)
+void sx1276Transmit(const uint8_t* frame, size_t len, const uint8_t* tail, size_t tailLen, bool implicitHeader);
+void sx1276StartCad();  // 👂 Channel activity detection (DIO0 → CAD done, flags say whether it saw a preamble)
+// 📥 Received frame (after DIO0 RX done) and its packet status, one burst each.
+// True when both are already in place; false = queued, wait for SX1276_OP_RX_READ.
+bool sx1276ReadPacket(uint8_t* out, size_t len);
+void sx1276PacketStatus(int16_t* rssi, float* snr);  // Of the last sx1276ReadPacket()
+
+// ⚡ DMA backend
+void sx1276AttachDio0(uint8_t pin, void (*isr)());    // Rising edge; the ISR should only wake LoRaTask
+uint8_t sx1276ServiceDio0(uint8_t* rxLen);           // Flags read + cleared; RX done → FIFO at the frame, *rxLen
+void sx1276OnSpiDone(void (*callback)(uint8_t op));  // ISR context
+void sx1276Flush();                                  // Wait for every queued transaction
+
+uint8_t sx1276ReadReg(uint8_t reg);  // Always from the chip
+void sx1276WriteReg(uint8_t reg, uint8_t value);  // Skipped if cached and equal
+
+const Sx1276Stats& sx1276Stats();
+void sx1276ResetStats();
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "protocol.h"
+
+// 📊 Telemetry RX ring (Air → Ground)
+// LoRaTask copies each received frame out of the SX1276 FIFO into the next free
+// slot right after the DIO0 RX-done interrupt, then parseTelemetry() consumes
+// the slots in order. Single producer / single consumer, fixed size, no heap.
+
+#define TLM_RING_SIZE 8  // Power of two
+
+struct TlmRxEntry {
+  union {
+    ProtoTlmPacket pkt;                // 📊 Decoded view
+    uint8_t raw[PROTO_RX_BUF_SIZE];  // 📥 FIFO bytes as received
+  };
+  uint8_t len;         // Bytes received (may differ from PROTO_TLM_PACKET_SIZE)
+  uint32_t arrivalUs;  // ⏱️ micros() at the DIO0 RX-done interrupt
+  int16_t rssi;        // 📶 Ground-side packet RSSI (dBm)
+  float snr;           // 📶 Ground-side packet SNR (dB)
+};
+
+TlmRxEntry* tlmRingReserve();      // Next free slot, NULL when full (frame dropped)
+void tlmRingCommit();              // Publish the reserved slot
+const TlmRxEntry* tlmRingPeek();   // Oldest entry, NULL when empty
+void tlmRingPop();                 // Release the oldest entry
+void tlmRingReset();
+uint32_t tlmRingDropped();         // 📊 Frames lost to a full ring
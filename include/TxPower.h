@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "protocol.h"
+
+// 🔋 Closed-loop uplink TX power, owned by LoRaTask
+// Every telemetry frame gives one uplink-margin sample, the worst of
+//   uplink RSSI the air reports (tlm_rssi) − sensitivity of the current profile
+//   downlink RSSI + (our power − PROTO_LORA_TX_POWER) − the same sensitivity
+//     (reciprocal path: the air sends at PROTO_LORA_TX_POWER)
+// smoothed by an EWMA, held between TX_POWER_TARGET_MARGIN_DB and
+// TX_POWER_TARGET_MARGIN_DB + TX_POWER_HYSTERESIS_DB:
+//   down  TX_POWER_STEP_DB after TX_POWER_DOWN_FRAMES samples above the band
+//   up    TX_POWER_STEP_DB as soon as the smoothed margin is below target
+// 🚨 TX_POWER_LOSS_BURST uplink frames in a row without telemetry back (TDMA:
+// every frame the air hears gets an answer) clamp straight to TX_POWER_MAX_DBM.
+// Never above PROTO_LORA_TX_POWER. Adaptive data rate (DataRate.h) is fed the
+// margin it would have at full power, so it keeps picking the fastest profile
+// and this loop only trims the excess.
+// Needs PROTO_BIDIRECTIONAL (margin comes from telemetry); otherwise stays at max.
+
+#ifndef TX_POWER_CONTROL
+#define TX_POWER_CONTROL 0  // 🔋 Off: always PROTO_LORA_TX_POWER
+#endif
+#ifndef TX_POWER_TARGET_MARGIN_DB
+#define TX_POWER_TARGET_MARGIN_DB 10.0f  // Fade margin kept on the uplink
+#endif
+#ifndef TX_POWER_HYSTERESIS_DB
+#define TX_POWER_HYSTERESIS_DB 4.0f  // Extra margin before stepping down
+#endif
+#ifndef TX_POWER_STEP_DB
+#define TX_POWER_STEP_DB 2
+#endif
+#ifndef TX_POWER_MIN_DBM
+#define TX_POWER_MIN_DBM 2  // SX1276 PA_BOOST floor
+#endif
+#ifndef TX_POWER_MAX_DBM
+#define TX_POWER_MAX_DBM PROTO_LORA_TX_POWER
+#endif
+#ifndef TX_POWER_DOWN_FRAMES
+#define TX_POWER_DOWN_FRAMES 10  // Samples at one level before the next step down
+#endif
+#ifndef TX_POWER_LOSS_BURST
+#define TX_POWER_LOSS_BURST 3  // Unanswered uplink frames → max power
+#endif
+#define TX_POWER_EWMA_ALPHA 0.25f
+
+struct TxPowerStats {
+  uint32_t samples;    // Margin samples (telemetry frames)
+  uint32_t stepsDown;
+  uint32_t stepsUp;
+  uint32_t clamps;     // 🚨 Loss burst → max
+  uint32_t frames;     // Uplink frames sent
+  float mwSum;         // Σ PA output per frame (mean = mwSum / frames)
+  int8_t minDbm;       // Lowest level used
+};
+
+void txPowerReset();  // Max power, nothing pending (setupRadio() configured PROTO_LORA_TX_POWER)
+void txPowerSetControl(bool on);  // Build-time default TX_POWER_CONTROL
+bool txPowerControl();
+
+// parseTelemetry(): ground-measured packet RSSI, air-reported uplink RSSI (≥ 0 = unknown),
+// sensitivity of the profile in use (DataRate.h)
+void txPowerOnTelemetry(int16_t rssi, int airRssi, float sensitivityDbm);
+void txPowerOnUplink();      // An uplink frame is off the air
+int txPowerPendingDbm();     // Level to apply now (−1 = none)
+void txPowerApplied();       // ...the radio is on it
+
+int8_t txPowerDbm();         // Current
+int txPowerHeadroomDb();     // TX_POWER_MAX_DBM − current
+float txPowerMarginDb();     // Smoothed uplink margin (0 before any telemetry)
+
+const TxPowerStats& txPowerStats();
+void txPowerPrintReport();  // 📊 Level, margin and steps over Serial
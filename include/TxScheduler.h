@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "Airtime.h"
+#include "LinkQuality.h"
+#include "RateControl.h"
+
+// ⏰ Event-driven LoRaTask scheduling
+// An esp_timer ticks every command period (PROTO_CMD_INTERVAL_MS, or the
+// RateControl.h period in ECO mode) and DIO0 fires on TX done /
+// RX done. Each posts an event bit and notifies LoRaTask, which sleeps in
+// ulTaskNotifyTake() until there is work instead of waking every 1 ms.
+
+#define LORA_EVT_TX_TICK (1u << 0)  // ⏰ Command slot due
+#define LORA_EVT_TX_DONE (1u << 1)  // 📡 DIO0: async TX finished
+#define LORA_EVT_RX_DONE (1u << 2)  // 📥 DIO0: telemetry frame in the FIFO
+#define LORA_EVT_SLOT_END (1u << 3) // ⏰ Reserved telemetry slot closed
+#define LORA_EVT_PRIORITY (1u << 4) // 🚨 Safety-critical command (e-stop / disarm)
+#define LORA_EVT_SAMPLE (1u << 5)   // 🧺 Stick sample due (CMD_AGGREGATE_SAMPLES)
+#define LORA_EVT_DIO0 (1u << 6)     // ⚡ DIO0 rose, flags not read yet (RADIO_SPI_DMA)
+#define LORA_EVT_SPI_DONE (1u << 7) // ⚡ Queued FIFO drain finished (RADIO_SPI_DMA)
+#define LORA_EVT_CAD_DONE (1u << 8) // 👂 DIO0: channel activity detection finished (RADIO_LBT)
+#define LORA_EVT_LBT (1u << 9)      // 👂 Backoff over, or the held frame's deadline
+
+// 🚨 Priority lane: an e-stop / disarm is sent as soon as the channel is ours
+// (no waiting for the TX tick, no ECO suppression, always a full keyframe) and
+// repeated PRIORITY_REPEAT_COUNT times. It still never aborts a TX on air and
+// never talks over the telemetry slot — the air side could not hear it then.
+#ifndef PRIORITY_REPEAT_COUNT
+#define PRIORITY_REPEAT_COUNT 3
+#endif
+
+// 💓 Keepalive (protocol_heartbeat.h): while ECO suppresses duplicates, the TX
+// tick nearest this long after the last frame sends a heartbeat instead
+#ifndef HEARTBEAT_INTERVAL_MS
+#define HEARTBEAT_INTERVAL_MS (RATE_MAX_INTERVAL_MS * 2)
+#endif
+
+// 🗓️ TDMA frame (PROTO_BIDIRECTIONAL), one per PROTO_CMD_INTERVAL_MS:
+//   | command slot: ground TX | telemetry slot: air TX | free |
+//   ^ timer tick             ^ DIO0 TX done
+// The air side answers each command TDMA_TURNAROUND_US after it arrives; the
+// ground holds any further TX until the telemetry slot closes (or telemetry
+// arrives early). Slot sizes come from the PROTO_LORA_* airtime model, in the
+// header mode the radio runs (radioImplicitHeader(); the constants below are
+// the CMD_IMPLICIT_HEADER build default).
+#ifndef TDMA_TURNAROUND_US
+#define TDMA_TURNAROUND_US 2000  // ⏱️ Air RX done → TX start (mode switch + MCU)
+#endif
+#ifndef TDMA_GUARD_US
+#define TDMA_GUARD_US 1000  // ⏱️ Clock / ISR latency margin
+#endif
+
+#define TDMA_TLM_FRAME_SIZE (PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE)  // 📶 Longest telemetry: with the link trailer
+
+// 📏 Telemetry length in implicit-header mode. Whether the air side appends
+// the link trailer is its build's choice, not LINK_SEQ_TRAILER (that is ours,
+// on the uplink), so it gets a setting of its own.
+#ifndef TLM_IMPLICIT_TRAILER
+#define TLM_IMPLICIT_TRAILER 0
+#endif
+#define TLM_IMPLICIT_SIZE (PROTO_TLM_PACKET_SIZE + (TLM_IMPLICIT_TRAILER ? LINK_TLM_TRAILER_SIZE : 0))
+
+constexpr uint32_t tdmaCmdSlotUs(size_t frameLen, bool implicitHeader) {  // frameLen: loraCommandFrameMaxSize()
+  return protoAirtimeUs(frameLen, implicitHeader);
+}
+constexpr uint32_t tdmaTlmSlotUs(bool implicitHeader) {  // Implicit: exactly the length the RX window expects
+  return TDMA_TURNAROUND_US + protoAirtimeUs(implicitHeader ? TLM_IMPLICIT_SIZE : TDMA_TLM_FRAME_SIZE, implicitHeader) +
+         TDMA_GUARD_US;
+}
+constexpr uint32_t TDMA_CMD_SLOT_US = tdmaCmdSlotUs(PROTO_CMD_PACKET_SIZE, CMD_IMPLICIT_HEADER);  // Plain command
+constexpr uint32_t TDMA_TLM_SLOT_US = tdmaTlmSlotUs(CMD_IMPLICIT_HEADER);
+constexpr bool TDMA_FITS_INTERVAL = TDMA_CMD_SLOT_US + TDMA_TLM_SLOT_US <= PROTO_CMD_INTERVAL_MS * 1000UL;
+
+#define TX_SCHED_WINDOW_MS 1000  // 📊 Stats window
+
+// 📊 One completed stats window (written by LoRaTask, read by loop() for printing)
+struct TxSchedulerStats {
+  uint32_t windowMs;      // Window length
+  uint32_t wakeups;       // loraLoop() runs
+  uint32_t slots;         // TX ticks serviced
+  uint32_t txDone;        // DIO0 TX-done interrupts
+  uint32_t rxDone;        // DIO0 RX-done interrupts (telemetry frames)
+  uint32_t busyUs;        // Time spent inside loraLoop() → CPU load
+  uint32_t jitterMeanUs;  // Mean |slot interval − armed period|
+  uint32_t jitterMaxUs;   // Worst |slot interval − armed period|
+};
+
+void loraStartScheduler(TaskHandle_t task);  // Start the TX timer + DIO0 TX-done hook, notifying task
+void loraRequestPriority();                  // 🚨 notify(): safety state published, send it now
+size_t loraCommandFrameMaxSize();            // 📏 Longest uplink frame the current settings send
+const TxSchedulerStats& txSchedulerStats();  // Last completed window
+void txSchedulerPrintReport();               // 📊 Wakeups, CPU load and jitter over Serial
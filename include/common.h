@@ -1,3 +1,4 @@
+#include "ControlState.h"
 #include "OLEDDisplayUi.h"
 #include "SSD1306Wire.h"
 
@@ -12,6 +13,9 @@
 #define LORA_RST 23   // Reset pin
 #define LORA_DIO0 26  // DIO0 (IRQ - RX/TX done)
 // SPI uses default VSPI: SCK=5, MISO=19, MOSI=27
+#define LORA_SCK 5
+#define LORA_MISO 19
+#define LORA_MOSI 27
 
 // PS5 Controller 🎮
 #define PS5_MAC_ADDRESS "ac:36:1b:41:ac:ed"
@@ -20,29 +24,11 @@ extern OLEDDisplayUi display;  // 🖥️ Display UI
 
 extern OverlayCallback allOverlays[];  // 📱 Display overlays
 
-// 🎮 Controller input variables
-extern int sendingEngineMessage;        // 🚀 Engine throttle
-extern byte sendingAileronMessage;      // ↔️ Aileron control
-extern byte sendingRudderMessage;       // ↔️ Rudder control
-extern byte sendingElevatorsMessage;    // ↕️ Elevator control
-extern int sendingElevatorTrimMessage;  // ⚖️ Elevator trim
-extern int sendingAileronTrimMessage;   // ⚖️ Aileron trim
-extern int sendingFlapsMessage;         // 🪶 Flaps position
-extern bool resetAileronTrim;           // 🔄 Reset aileron trim
-extern bool resetElevatorTrim;          // 🔄 Reset elevator trim
-
-extern bool isEmergencyStopEnabled;  // 🚨 Emergency stop status
-extern bool airbrakeEnabled;         // 🛑 Airbrake status
-extern bool acsEngageEnabled;        // 🤖 ACS autopilot engage
-extern uint8_t stabilityAssistValue;  // 🛡️ Stability assist L2 analog 0-255
-extern bool ecoModeEnabled;           // 🌿 ECO mode: suppress duplicate packets (default ON)
+// 🎮 Controller inputs, arm state, ECO mode and flight timer live in ControlState
+// (ControlState.h) — read with controlSnapshot(), publish with controlBeginWrite()/controlEndWrite().
 
 extern uint8_t batteryPercentage;  // 🔋 Battery level
 
-// ⏱️ Flight timer (armed time)
-extern unsigned long flightTimerStartMs;  // millis() when armed (0 = not armed)
-extern bool flightTimerRunning;           // true while armed
-
 // 🎮 Expo/Rates Configuration
 // Expo: 0.0 = linear, 1.0 = maximum curve (fine near center, sharp at edges)
 // Rate: 0.0–1.0 = fraction of full servo travel (1.0 = full 0-180)
@@ -14,16 +14,16 @@ void printDeviceAddress();   // 📱 Print device MAC
 
 // Display 🖥️
 #include "Display.h"
-int frameCount = 1;     // 🖼️ Number of display frames
+int frameCount = 3;     // 🖼️ Number of display frames (⚙️ Options cycles them)
 int overlaysCount = 1;  // 📱 Number of display overlays
 void setupDisplay();    // 🖥️ Initialize OLED display
+void hudServicePaging(OLEDDisplayUi& ui, uint8_t& shownPage);  // ⚙️ Options → nextFrame() (DisplayTask)
 
 // LoRa Communication 📡 (parameters from protocol.h)
 #include <LoRa.h>
-boolean runEvery(unsigned long interval);               // ⏰ Timer function
 void setupRadio();                                      // 📡 Initialize LoRa radio
-void loraLoop();                                        // 📡 Main LoRa communication loop
-void LoRa_sendPacket(const uint8_t* data, size_t len);  // 📡 Send binary LoRa packet
+void loraLoop();                                        // 📡 LoRaTask body (one run per wakeup)
+bool LoRa_sendPacket(const uint8_t* data, size_t len);  // 📡 Send binary LoRa packet (false if radio busy)
 
 extern bool lora_initialized;  // 📡 LoRa init status
 
@@ -35,4 +35,6 @@ extern float tlm_gforce;
 extern float tlm_temperature;
 extern float tlm_verticalSpeed;
 extern bool tlm_valid;
-extern unsigned long tlm_lastReceived;
\ No newline at end of file
+extern unsigned long tlm_lastReceived;
+extern int tlm_linkRssi;     // 📶 Ground-side RSSI of the last telemetry frame
+extern float tlm_linkSnr;    // 📶 Ground-side SNR of the last telemetry frame
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "protocol.h"
+#include "protocol_trim.h"
+
+// 🧺 Multi-sample command frames (Ground → Air)
+// The ground samples the sticks several times per command period and packs
+// the older samples, compact, in front of the newest full command:
+//
+//   magic | n | n−1 × (age | engine | ailerons | rudder | elevators) | newest ProtoCmdPacket | checksum
+//     n   = samples in the frame (newest included), 2..PROTO_AGG_MAX_SAMPLES
+//     age = ms the sample was taken before the newest one (oldest first)
+//
+// The preamble + header cost is paid once for n stick updates. The air side
+// applies the newest command as usual, or replays all n at their original
+// spacing, a fixed delay behind. Older samples carry only the four axes: the
+// rest (trims, flaps, flags) belongs to the newest command, and one-shot
+// fields (trim steps, reset flags) are applied once, with it. Header-only and
+// C-compatible like protocol.h (candidate for lib/lora-protocol).
+
+#define PROTO_AGG_MAGIC ((uint8_t)(PROTO_CMD_MAGIC ^ 0xC3))
+#define PROTO_AGG_MAX_SAMPLES 4
+#define PROTO_AGG_SAMPLE_SIZE 5
+#define PROTO_AGG_SIZE(n) (2 + PROTO_AGG_SAMPLE_SIZE * ((n) - 1) + PROTO_CMD_PACKET_SIZE + 1)
+#define PROTO_AGG_MAX_SIZE PROTO_AGG_SIZE(PROTO_AGG_MAX_SAMPLES)
+
+typedef struct {
+  uint8_t ageMs;  // Before the newest sample
+  uint8_t engine;
+  uint8_t ailerons;
+  uint8_t rudder;
+  uint8_t elevators;
+} ProtoAggSample;
+
+// 📦 older[] oldest first (olderCount ≤ PROTO_AGG_MAX_SAMPLES − 1); returns PROTO_AGG_SIZE(olderCount + 1)
+static inline size_t proto_agg_encode(const ProtoCmdPacket* newest, const ProtoAggSample* older, uint8_t olderCount,
+                                      uint8_t* out) {
+  size_t n = 0;
+  out[n++] = PROTO_AGG_MAGIC;
+  out[n++] = (uint8_t)(olderCount + 1);
+  for (uint8_t i = 0; i < olderCount; i++) {
+    out[n++] = older[i].ageMs;
+    out[n++] = older[i].engine;
+    out[n++] = older[i].ailerons;
+    out[n++] = older[i].rudder;
+    out[n++] = older[i].elevators;
+  }
+  memcpy(out + n, newest, PROTO_CMD_PACKET_SIZE);
+  n += PROTO_CMD_PACKET_SIZE;
+  out[n] = proto_checksum(out, n);
+  return n + 1;
+}
+
+// 🛩️ Air side: every sample as a full command, oldest first (out[count − 1] is
+// the newest, exactly as sent). Older ones inherit the newest command's
+// discrete state without its one-shot trim steps / reset flags. ages[i] = ms
+// before the newest. False on a bad frame.
+static inline bool proto_agg_decode(const uint8_t* frame, size_t len, ProtoCmdPacket* out, uint8_t* ages,
+                                    uint8_t* count) {
+  if (len < PROTO_AGG_SIZE(2) || frame[0] != PROTO_AGG_MAGIC)
+    return false;
+  uint8_t n = frame[1];
+  if (n < 2 || n > PROTO_AGG_MAX_SAMPLES || len != PROTO_AGG_SIZE(n) || frame[len - 1] != proto_checksum(frame, len - 1))
+    return false;
+
+  const uint8_t* newest = frame + 2 + PROTO_AGG_SAMPLE_SIZE * (n - 1);
+  memcpy(&out[n - 1], newest, PROTO_CMD_PACKET_SIZE);
+  if (out[n - 1].magic != PROTO_CMD_MAGIC ||
+      out[n - 1].checksum != proto_checksum(newest, PROTO_CMD_PACKET_SIZE - 1))
+    return false;
+  ages[n - 1] = 0;
+
+  for (uint8_t i = 0; i + 1 < n; i++) {
+    const uint8_t* s = frame + 2 + PROTO_AGG_SAMPLE_SIZE * i;
+    ProtoCmdPacket* p = &out[i];
+    *p = out[n - 1];
+    ages[i] = s[0];
+    p->engine = s[1];
+    p->ailerons = s[2];
+    p->rudder = s[3];
+    p->elevators = s[4];
+    p->flags &= (uint8_t) ~(PROTO_FLAG_RESET_AIL | PROTO_FLAG_RESET_ELEV);
+    if (!(p->flags & PROTO_FLAG_ABS_TRIM)) {  // ⚖️ Absolute trim is state, steps are one-shot
+      p->elevatorTrim = 0;
+      p->aileronTrim = 0;
+    }
+    p->checksum = proto_checksum((const uint8_t*)p, PROTO_CMD_PACKET_SIZE - 1);
+  }
+  *count = n;
+  return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol.h"
+#include "protocol_trim.h"
+
+// 🔺 Delta command frames (Ground → Air)
+// Header-only and C-compatible like protocol.h so the flight board can share it
+// (candidate for lib/lora-protocol).
+//
+//   keyframe : ProtoCmdPacket, unchanged (PROTO_CMD_MAGIC)
+//   delta    : magic | base (2, LE) | mask | changed field groups, ProtoCmdPacket order | checksum
+//
+//   base = CRC-16 of the whole keyframe the delta is relative to. A receiver
+//          that missed that keyframe rejects the delta and waits for the next.
+//          Not the keyframe's XOR checksum: keyframes a few stick counts apart
+//          share it, and a delta would rebuild on the wrong one.
+//   mask = bit n set → field group n follows (PROTO_DELTA_F_*)
+//
+// Deltas are relative to the last keyframe, not the previous frame, so a lost
+// delta never corrupts the receiver's state. One-shot fields (trim steps,
+// reset flags) are never inherited from the keyframe: absent means 0. With
+// PROTO_FLAG_ABS_TRIM (protocol_trim.h) the trims are state like the sticks
+// and are inherited.
+
+#define PROTO_DELTA_MAGIC ((uint8_t)(PROTO_CMD_MAGIC ^ 0x0F))
+#define PROTO_DELTA_HEADER_SIZE 4  // magic + base + mask
+#define PROTO_DELTA_MASK_INDEX 3
+#define PROTO_DELTA_MAX_SIZE (PROTO_DELTA_HEADER_SIZE + 9 + 1)
+
+#ifndef PROTO_DELTA_KEYFRAME_INTERVAL
+#define PROTO_DELTA_KEYFRAME_INTERVAL 10  // 🔑 Full frame every N frames (resync)
+#endif
+
+// Field groups (bit index = position in the delta payload order)
+#define PROTO_DELTA_F_ENGINE    0x01
+#define PROTO_DELTA_F_AILERONS  0x02
+#define PROTO_DELTA_F_RUDDER    0x04
+#define PROTO_DELTA_F_ELEVATORS 0x08
+#define PROTO_DELTA_F_TRIM      0x10  // elevatorTrim + aileronTrim (2 bytes)
+#define PROTO_DELTA_F_FLAPS     0x20
+#define PROTO_DELTA_F_FLAGS     0x40
+#define PROTO_DELTA_F_STABILITY 0x80
+
+#define PROTO_DELTA_ONESHOT_FLAGS (PROTO_FLAG_RESET_AIL | PROTO_FLAG_RESET_ELEV)
+
+// 🔑 CRC-16/CCITT (poly 0x1021, init 0xFFFF) over the whole keyframe
+static inline uint16_t proto_delta_base(const ProtoCmdPacket* key) {
+  const uint8_t* b = (const uint8_t*)key;
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < PROTO_CMD_PACKET_SIZE; i++) {
+    crc ^= (uint16_t)(b[i] << 8);
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (uint16_t)((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+  }
+  return crc;
+}
+
+static inline size_t proto_delta_size(uint8_t mask) {
+  size_t n = PROTO_DELTA_HEADER_SIZE + 1;  // + checksum
+  for (uint8_t m = mask; m; m &= (uint8_t)(m - 1))
+    n++;
+  return (mask & PROTO_DELTA_F_TRIM) ? n + 1 : n;
+}
+
+// 📦 Encode cur relative to key; returns the frame length (≤ PROTO_DELTA_MAX_SIZE)
+static inline size_t proto_delta_encode(const ProtoCmdPacket* key, const ProtoCmdPacket* cur, uint8_t* out) {
+  const bool absTrim = (cur->flags & PROTO_FLAG_ABS_TRIM) != 0;
+  const bool trimChanged = cur->elevatorTrim != key->elevatorTrim || cur->aileronTrim != key->aileronTrim;
+  uint8_t mask = 0;
+  if (cur->engine != key->engine)                                     mask |= PROTO_DELTA_F_ENGINE;
+  if (cur->ailerons != key->ailerons)                                 mask |= PROTO_DELTA_F_AILERONS;
+  if (cur->rudder != key->rudder)                                     mask |= PROTO_DELTA_F_RUDDER;
+  if (cur->elevators != key->elevators)                               mask |= PROTO_DELTA_F_ELEVATORS;
+  if (absTrim ? trimChanged : (cur->elevatorTrim || cur->aileronTrim)) mask |= PROTO_DELTA_F_TRIM;
+  if (cur->flaps != key->flaps)                                       mask |= PROTO_DELTA_F_FLAPS;
+  if (cur->flags != (uint8_t)(key->flags & ~PROTO_DELTA_ONESHOT_FLAGS)) mask |= PROTO_DELTA_F_FLAGS;
+  if (cur->stabilityAssist != key->stabilityAssist)                   mask |= PROTO_DELTA_F_STABILITY;
+
+  const uint16_t base = proto_delta_base(key);
+  size_t n = 0;
+  out[n++] = PROTO_DELTA_MAGIC;
+  out[n++] = (uint8_t)base;
+  out[n++] = (uint8_t)(base >> 8);
+  out[n++] = mask;
+  if (mask & PROTO_DELTA_F_ENGINE)    out[n++] = cur->engine;
+  if (mask & PROTO_DELTA_F_AILERONS)  out[n++] = cur->ailerons;
+  if (mask & PROTO_DELTA_F_RUDDER)    out[n++] = cur->rudder;
+  if (mask & PROTO_DELTA_F_ELEVATORS) out[n++] = cur->elevators;
+  if (mask & PROTO_DELTA_F_TRIM) {
+    out[n++] = (uint8_t)cur->elevatorTrim;
+    out[n++] = (uint8_t)cur->aileronTrim;
+  }
+  if (mask & PROTO_DELTA_F_FLAPS)     out[n++] = cur->flaps;
+  if (mask & PROTO_DELTA_F_FLAGS)     out[n++] = cur->flags;
+  if (mask & PROTO_DELTA_F_STABILITY) out[n++] = cur->stabilityAssist;
+  out[n] = proto_checksum(out, n);
+  return n + 1;
+}
+
+// 📥 Rebuild the full packet (checksum included) from key + delta frame.
+// False on a bad checksum, wrong length or a delta relative to another keyframe.
+static inline bool proto_delta_decode(const ProtoCmdPacket* key, const uint8_t* frame, size_t len, ProtoCmdPacket* out) {
+  if (len < PROTO_DELTA_HEADER_SIZE + 1 || frame[0] != PROTO_DELTA_MAGIC)
+    return false;
+  uint8_t mask = frame[PROTO_DELTA_MASK_INDEX];
+  if (len != proto_delta_size(mask) || frame[len - 1] != proto_checksum(frame, len - 1))
+    return false;
+  if ((uint16_t)(frame[1] | frame[2] << 8) != proto_delta_base(key))
+    return false;  // 🔑 Missed the keyframe this delta builds on
+
+  *out = *key;
+  out->flags &= (uint8_t)~PROTO_DELTA_ONESHOT_FLAGS;
+
+  size_t n = PROTO_DELTA_HEADER_SIZE;
+  if (mask & PROTO_DELTA_F_ENGINE)    out->engine = frame[n++];
+  if (mask & PROTO_DELTA_F_AILERONS)  out->ailerons = frame[n++];
+  if (mask & PROTO_DELTA_F_RUDDER)    out->rudder = frame[n++];
+  if (mask & PROTO_DELTA_F_ELEVATORS) out->elevators = frame[n++];
+  if (mask & PROTO_DELTA_F_TRIM) {
+    out->elevatorTrim = (int8_t)frame[n++];
+    out->aileronTrim = (int8_t)frame[n++];
+  }
+  if (mask & PROTO_DELTA_F_FLAPS)     out->flaps = frame[n++];
+  if (mask & PROTO_DELTA_F_FLAGS)     out->flags = frame[n++];
+  if (mask & PROTO_DELTA_F_STABILITY) out->stabilityAssist = frame[n++];
+  if (!(mask & PROTO_DELTA_F_TRIM) && !(out->flags & PROTO_FLAG_ABS_TRIM)) {
+    out->elevatorTrim = 0;  // One-shot steps: absent means none
+    out->aileronTrim = 0;
+  }
+  out->checksum = proto_checksum((const uint8_t*)out, PROTO_CMD_PACKET_SIZE - 1);
+  return true;
+}
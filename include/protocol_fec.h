@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "protocol.h"
+
+// 🧩 XOR parity frames (Ground → Air)
+// After every K command frames the ground sends one parity frame, so the air
+// side can rebuild any single command it missed out of those K without a
+// retransmit. Header-only and C-compatible like protocol.h (candidate for
+// lib/lora-protocol).
+//
+//   magic | K | tag of each covered command (K bytes) | XOR of the K full commands | checksum
+//
+// The parity covers the full ProtoCmdPacket the air side ends up with, so it
+// works the same whether the commands went out as keyframes or deltas. The
+// tag list (CRC-8 of each command — the XOR checksum collides too easily for
+// neighbouring stick values) identifies the group without a sequence number:
+// the air looks each tag up in the commands it holds, newest first, and if
+// exactly one is missing, XORing the others out of the parity yields it
+// (verified against its listed tag and its own checksum).
+//
+// A rebuilt command is older than the frames heard after it: the air side
+// should apply its one-shot fields (trim steps, reset flags) and take its
+// sticks only if nothing newer arrived since.
+
+#define PROTO_FEC_MAGIC ((uint8_t)(PROTO_CMD_MAGIC ^ 0x3C))
+#define PROTO_FEC_MAX_GROUP 8
+#define PROTO_FEC_SIZE(k) (2 + (k) + PROTO_CMD_PACKET_SIZE + 1)
+#define PROTO_FEC_MAX_SIZE PROTO_FEC_SIZE(PROTO_FEC_MAX_GROUP)
+
+typedef struct {
+  uint8_t count;
+  uint8_t tags[PROTO_FEC_MAX_GROUP];
+  uint8_t parity[PROTO_CMD_PACKET_SIZE];
+} ProtoFecGroup;
+
+// 🏷️ CRC-8 (poly 0x07) over the whole command
+static inline uint8_t proto_fec_tag(const ProtoCmdPacket* cmd) {
+  const uint8_t* b = (const uint8_t*)cmd;
+  uint8_t crc = 0;
+  for (size_t i = 0; i < PROTO_CMD_PACKET_SIZE; i++) {
+    crc ^= b[i];
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+  }
+  return crc;
+}
+
+static inline void proto_fec_reset(ProtoFecGroup* g) {
+  memset(g, 0, sizeof(*g));
+}
+
+// ➕ One more command on air (ignored once the group is full)
+static inline void proto_fec_add(ProtoFecGroup* g, const ProtoCmdPacket* cmd) {
+  if (g->count >= PROTO_FEC_MAX_GROUP)
+    return;
+  const uint8_t* b = (const uint8_t*)cmd;
+  for (size_t i = 0; i < PROTO_CMD_PACKET_SIZE; i++)
+    g->parity[i] ^= b[i];
+  g->tags[g->count++] = proto_fec_tag(cmd);
+}
+
+// 📦 Parity frame for the group; returns PROTO_FEC_SIZE(count)
+static inline size_t proto_fec_encode(const ProtoFecGroup* g, uint8_t* out) {
+  size_t n = 0;
+  out[n++] = PROTO_FEC_MAGIC;
+  out[n++] = g->count;
+  memcpy(out + n, g->tags, g->count);
+  n += g->count;
+  memcpy(out + n, g->parity, PROTO_CMD_PACKET_SIZE);
+  n += PROTO_CMD_PACKET_SIZE;
+  out[n] = proto_checksum(out, n);
+  return n + 1;
+}
+
+// 🛩️ Air side: rebuild the one command of the group missing from held[]
+// (oldest first, as received). False on a bad frame, nothing missing, or more
+// than one missing.
+static inline bool proto_fec_recover(const uint8_t* frame, size_t len, const ProtoCmdPacket* held, size_t heldCount,
+                                     ProtoCmdPacket* out) {
+  if (len < PROTO_FEC_SIZE(1) || frame[0] != PROTO_FEC_MAGIC)
+    return false;
+  uint8_t k = frame[1];
+  if (k == 0 || k > PROTO_FEC_MAX_GROUP || len != PROTO_FEC_SIZE(k) ||
+      frame[len - 1] != proto_checksum(frame, len - 1))
+    return false;
+
+  uint8_t x[PROTO_CMD_PACKET_SIZE];
+  memcpy(x, frame + 2 + k, PROTO_CMD_PACKET_SIZE);
+  int missing = -1;
+  for (uint8_t i = 0; i < k; i++) {
+    const ProtoCmdPacket* found = NULL;
+    for (size_t h = heldCount; h-- > 0 && !found;) {
+      if (proto_fec_tag(&held[h]) == frame[2 + i])
+        found = &held[h];
+    }
+    if (!found) {
+      if (missing >= 0)
+        return false;  // Two or more lost — XOR can't separate them
+      missing = i;
+      continue;
+    }
+    const uint8_t* b = (const uint8_t*)found;
+    for (size_t j = 0; j < PROTO_CMD_PACKET_SIZE; j++)
+      x[j] ^= b[j];
+  }
+  if (missing < 0)
+    return false;  // Whole group heard
+
+  memcpy(out, x, PROTO_CMD_PACKET_SIZE);
+  return out->magic == PROTO_CMD_MAGIC && proto_fec_tag(out) == frame[2 + missing] &&
+         out->checksum == proto_checksum((const uint8_t*)out, PROTO_CMD_PACKET_SIZE - 1);
+}
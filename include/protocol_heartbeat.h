@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol.h"
+
+// 💓 Keepalive heartbeat (Ground → Air)
+// Sent instead of silence while ECO mode suppresses duplicate commands, so the
+// flight board can tell "idle pilot" from "lost link". Header-only and
+// C-compatible like protocol.h (candidate for lib/lora-protocol).
+//
+//   magic | seq | base | flags | checksum
+//
+//   seq   = heartbeat counter (wraps) — gaps show lost heartbeats
+//   base  = checksum byte of the full command the air side should be holding;
+//           a mismatch means it missed the last change and should fail safe
+//   flags = PROTO_FLAG_* state bits of that command (one-shot bits cleared)
+
+#define PROTO_HEARTBEAT_MAGIC ((uint8_t)(PROTO_CMD_MAGIC ^ 0xF0))
+#define PROTO_HEARTBEAT_SIZE 5
+
+typedef struct __attribute__((packed)) {
+  uint8_t magic;
+  uint8_t seq;
+  uint8_t base;
+  uint8_t flags;
+  uint8_t checksum;
+} ProtoHeartbeatPacket;
+
+static inline void proto_heartbeat_build(ProtoHeartbeatPacket* hb, uint8_t seq, const ProtoCmdPacket* holding) {
+  hb->magic = PROTO_HEARTBEAT_MAGIC;
+  hb->seq = seq;
+  hb->base = holding->checksum;
+  hb->flags = (uint8_t)(holding->flags & ~(PROTO_FLAG_RESET_AIL | PROTO_FLAG_RESET_ELEV));
+  hb->checksum = proto_checksum((const uint8_t*)hb, PROTO_HEARTBEAT_SIZE - 1);
+}
+
+// 🛩️ Air side: true for a valid heartbeat that confirms the held command
+static inline bool proto_heartbeat_check(const uint8_t* frame, size_t len, const ProtoCmdPacket* holding) {
+  if (len != PROTO_HEARTBEAT_SIZE || frame[0] != PROTO_HEARTBEAT_MAGIC)
+    return false;
+  if (frame[PROTO_HEARTBEAT_SIZE - 1] != proto_checksum(frame, PROTO_HEARTBEAT_SIZE - 1))
+    return false;
+  return frame[2] == holding->checksum;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "protocol.h"
+
+// 📏 Implicit-header command link (Ground ↔ Air)
+// Every uplink frame is a full PROTO_CMD_PACKET_SIZE command and every
+// downlink frame a fixed-size telemetry packet, so the explicit LoRa header
+// (length, coding rate, CRC-on) tells the receiver nothing it doesn't know.
+// In implicit mode both radios are configured with the lengths up front and
+// the header symbols are left out of every frame (see loraAirtimeUs()).
+//
+// Both ends must switch together: a radio in the other mode decodes nothing.
+// Frames of the implicit protocol revision carry PROTO_FLAG_IMPLICIT_HDR, so
+// the flight board can check it is talking to a matching ground build.
+// Header-only and C-compatible like protocol.h (candidate for lib/lora-protocol).
+
+#define PROTO_FLAG_IMPLICIT_HDR 0x40
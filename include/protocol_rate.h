@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "protocol.h"
+#include "protocol_reliable.h"
+
+// 📶 Adaptive data rate (Ground ↔ Air)
+// Header-only and C-compatible like protocol.h (candidate for lib/lora-protocol).
+//
+// Both ends boot on profile 0, the PROTO_LORA_* settings. Profile k + 1 halves
+// the symbol time of profile k: spreading factor down to 7 first, then the
+// bandwidth doubled up to PROTO_RATE_MAX_BW_HZ. Only SF and bandwidth change;
+// frequency, coding rate, preamble, sync word and CRC stay as in protocol.h.
+//
+// Switch handshake, on the reliable-command trailer (protocol_reliable.h):
+//   ground → PROTO_REL_OP_RATE, arg = profile (resent until acked, like any op)
+//   air    → acks it in its next telemetry frame, sent on the old profile,
+//            then retunes
+//   ground → retunes when that ack arrives
+// 🛟 Fallback: an end on any profile but 0 that hears nothing valid from the
+// other for PROTO_RATE_FALLBACK_MS drops back to profile 0. A lost request or
+// ack leaves the two ends on different profiles; both go quiet, both fall
+// back, and they meet again on profile 0.
+
+#ifndef PROTO_RATE_MAX_BW_HZ
+#define PROTO_RATE_MAX_BW_HZ 500000L  // US915 (EU868: 250000)
+#endif
+#ifndef PROTO_RATE_FALLBACK_MS
+#define PROTO_RATE_FALLBACK_MS (10 * PROTO_CMD_INTERVAL_MS)  // Both ends must agree
+#endif
+#define PROTO_RATE_MAX_PROFILES 4
+
+typedef struct {
+  uint8_t sf;
+  long bandwidthHz;
+} ProtoRateProfile;
+
+// Next step up the ladder; false = p is already the fastest
+static inline bool proto_rate_step_up(ProtoRateProfile* p) {
+  if (p->sf > 7) {
+    p->sf--;
+    return true;
+  }
+  if (p->bandwidthHz >= 125000 && p->bandwidthHz * 2 <= PROTO_RATE_MAX_BW_HZ) {
+    p->bandwidthHz *= 2;
+    return true;
+  }
+  return false;
+}
+
+static inline uint8_t proto_rate_profile_count(void) {
+  ProtoRateProfile p = {PROTO_LORA_SF, PROTO_LORA_BANDWIDTH_HZ};
+  uint8_t n = 1;
+  while (n < PROTO_RATE_MAX_PROFILES && proto_rate_step_up(&p))
+    n++;
+  return n;
+}
+
+// Profile k (past the fastest one: the fastest)
+static inline ProtoRateProfile proto_rate_profile(uint8_t k) {
+  ProtoRateProfile p = {PROTO_LORA_SF, PROTO_LORA_BANDWIDTH_HZ};
+  for (uint8_t i = 0; i < k && i + 1 < PROTO_RATE_MAX_PROFILES; i++) {
+    if (!proto_rate_step_up(&p))
+      break;
+  }
+  return p;
+}
+
+// 🛩️ Air side
+typedef struct {
+  uint8_t profile;       // Radio tuned to it
+  uint8_t next;          // Requested, taken once the telemetry acking it is out
+  uint32_t lastHeardMs;  // Last valid uplink frame
+} ProtoRateAir;
+
+static inline void proto_rate_air_init(ProtoRateAir* s, uint32_t nowMs) {
+  s->profile = 0;
+  s->next = 0;
+  s->lastHeardMs = nowMs;
+}
+
+// 🛩️ Valid uplink frame; op / arg from its reliable trailer (op 0 = none)
+static inline void proto_rate_air_heard(ProtoRateAir* s, uint8_t op, uint8_t arg, uint32_t nowMs) {
+  s->lastHeardMs = nowMs;
+  if (op == PROTO_REL_OP_RATE && arg < proto_rate_profile_count())
+    s->next = arg;
+}
+
+// 🛩️ Telemetry frame is off the air. True → retune to proto_rate_profile(s->profile)
+static inline bool proto_rate_air_tlm_sent(ProtoRateAir* s, uint32_t nowMs) {
+  if (s->next == s->profile)
+    return false;
+  s->profile = s->next;
+  s->lastHeardMs = nowMs;  // A full fallback window on the new profile
+  return true;
+}
+
+// 🛩️ Periodic check. True → fell back to profile 0, retune
+static inline bool proto_rate_air_poll(ProtoRateAir* s, uint32_t nowMs) {
+  if (s->profile == 0 || nowMs - s->lastHeardMs < PROTO_RATE_FALLBACK_MS)
+    return false;
+  proto_rate_air_init(s, nowMs);
+  return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol.h"
+
+// 🔁 Reliable discrete commands (Ground → Air, acked Air → Ground)
+// Header-only and C-compatible like protocol.h (candidate for lib/lora-protocol).
+//
+// A command frame (keyframe or delta) may carry one reliable-command trailer
+// before the optional 📶 upSeq byte:
+//   frame | id | op | arg | check | [upSeq]
+//     id    = rolling send id, new on every (re)send
+//     op    = PROTO_REL_OP_*, arg = its absolute value (see below)
+//     check = proto_rel_check(id, op, arg)
+// The air side acks in its telemetry trailer (LinkQuality.h):
+//   ackId   = newest reliable id it heard
+//   ackMask = bit n set → id (ackId − n) heard too (0 = nothing heard yet)
+//
+// Every op carries absolute state, so applying one twice is harmless and a
+// resend can take a fresh id: the ground resends each unacked op until the id
+// of its latest send comes back, the stick stream stays best effort.
+
+#define PROTO_REL_TRAILER_SIZE 4
+
+#define PROTO_REL_OP_RESET_AIL  1  // arg = L3 press count (reset when it changes)
+#define PROTO_REL_OP_RESET_ELEV 2  // arg = R3 press count
+#define PROTO_REL_OP_TRIM_AIL   3  // arg = absolute aileron trim (int8, protocol_trim.h)
+#define PROTO_REL_OP_TRIM_ELEV  4  // arg = absolute elevator trim (int8)
+#define PROTO_REL_OP_AIRBRAKE   5  // arg = 0 / 1
+#define PROTO_REL_OP_ACS        6  // arg = 0 / 1
+#define PROTO_REL_OP_FLAPS      7  // arg = 0..4
+#define PROTO_REL_OP_RATE       8  // arg = 📶 data-rate profile (protocol_rate.h), link control, not pilot state
+#define PROTO_REL_OP_COUNT      8
+
+static inline uint8_t proto_rel_check(uint8_t id, uint8_t op, uint8_t arg) {
+  return (uint8_t)(id ^ op ^ arg ^ 0xA5);
+}
+
+static inline void proto_rel_encode(uint8_t id, uint8_t op, uint8_t arg, uint8_t* out) {
+  out[0] = id;
+  out[1] = op;
+  out[2] = arg;
+  out[3] = proto_rel_check(id, op, arg);
+}
+
+// 🛩️ Air side: parse the trailer (bytes after the command frame, upSeq stripped)
+static inline bool proto_rel_decode(const uint8_t* t, size_t len, uint8_t* id, uint8_t* op, uint8_t* arg) {
+  if (len != PROTO_REL_TRAILER_SIZE || t[1] == 0 || t[1] > PROTO_REL_OP_COUNT ||
+      t[3] != proto_rel_check(t[0], t[1], t[2]))
+    return false;
+  *id = t[0];
+  *op = t[1];
+  *arg = t[2];
+  return true;
+}
+
+// 🛩️ Air side: ack window over the last 8 ids. True if id is new (apply it).
+static inline bool proto_rel_ack_window_add(uint8_t* ackId, uint8_t* ackMask, uint8_t id) {
+  if (*ackMask == 0) {
+    *ackId = id;
+    *ackMask = 1;
+    return true;
+  }
+  int8_t d = (int8_t)(id - *ackId);
+  if (d > 0) {
+    *ackMask = d >= 8 ? 1 : (uint8_t)((*ackMask << d) | 1);
+    *ackId = id;
+    return true;
+  }
+  if (-d >= 8 || (*ackMask & (1u << -d)))
+    return false;  // Too old to track, or already heard
+  *ackMask |= (uint8_t)(1u << -d);
+  return true;
+}
+
+// Ground side: was id acked by (ackId, ackMask)?
+static inline bool proto_rel_acked(uint8_t ackId, uint8_t ackMask, uint8_t id) {
+  uint8_t n = (uint8_t)(ackId - id);
+  return n < 8 && (ackMask & (1u << n));
+}
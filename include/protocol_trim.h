@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "protocol.h"
+
+// ⚖️ Absolute trim (Ground → Air)
+// With PROTO_FLAG_ABS_TRIM set in flags, elevatorTrim / aileronTrim carry the
+// trim offset itself (steps from neutral, ±PROTO_TRIM_ABS_MAX) instead of a
+// one-shot ±1 step, and the reset flags are never set: L3 / R3 zero the
+// offset on the ground. Every frame restates the whole discrete state (trims,
+// flaps, switches), so a lost frame loses nothing, repeats are idempotent and
+// ECO can deduplicate around a trim press. Header-only and C-compatible like
+// protocol.h (candidate for lib/lora-protocol).
+
+#define PROTO_FLAG_ABS_TRIM 0x80
+#define PROTO_TRIM_ABS_MAX 100  // Steps either side of neutral
+
+// ➕ One D-pad step on an absolute offset, clamped
+static inline int8_t proto_trim_step(int8_t trim, int8_t dir) {
+  int t = trim + dir;
+  if (t > PROTO_TRIM_ABS_MAX)
+    t = PROTO_TRIM_ABS_MAX;
+  if (t < -PROTO_TRIM_ABS_MAX)
+    t = -PROTO_TRIM_ABS_MAX;
+  return (int8_t)t;
+}
@@ -0,0 +1,118 @@
+// 💻 NativeHAL — host stand-in for the ESP32 Arduino core
+// Only the subset used by src/ is provided. Time is simulated: millis()/micros()
+// advance only through hal_setMillis()/hal_advanceMillis(), so tests are deterministic.
+#pragma once
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "binary.h"
+#include "freertos/FreeRTOS.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define RISING 0x01
+#define FALLING 0x02
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define BUILTIN_LED 25  // 💡 TTGO LoRa32 V2.1 green LED
+#define LED_BUILTIN BUILTIN_LED
+
+#define F(s) (s)
+
+using std::max;
+using std::min;
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+long random(long howbig);  // Deterministic sequence (randomSeed() restarts it)
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ⏱️ Simulated clock
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void hal_setMillis(unsigned long ms);
+void hal_advanceMillis(unsigned long ms);
+void hal_advanceMicros(unsigned long us);
+
+// 📌 GPIO / ADC
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void hal_setAnalog(uint8_t pin, int value);
+
+// ⚡ GPIO interrupts: ISRs run synchronously when a fake raises the pin
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+bool hal_interruptAttached(int pin);  // 🧪
+void hal_raiseInterrupt(int pin);     // 🧪 Rising edge on pin
+
+// 🔤 Minimal Arduino String
+class String {
+ public:
+  String() {}
+  String(const char* s) : str(s ? s : "") {}
+  String(const std::string& s) : str(s) {}
+  String(int val) : str(std::to_string(val)) {}
+  String(unsigned int val) : str(std::to_string(val)) {}
+  String(long val) : str(std::to_string(val)) {}
+  String(unsigned long val) : str(std::to_string(val)) {}
+  String(unsigned char val) : str(std::to_string(val)) {}
+
+  String operator+(const String& other) const { return String(str + other.str); }
+  String operator+(const char* s) const { return String(str + s); }
+  String& operator+=(const String& other) {
+    str += other.str;
+    return *this;
+  }
+
+  const char* c_str() const { return str.c_str(); }
+  size_t length() const { return str.length(); }
+
+ private:
+  std::string str;
+};
+
+// 📊 Serial — writes to stdout unless muted (benchmarks mute it) or captured (tests)
+class HardwareSerial {
+ public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t print(const char* s);
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(int v);
+  size_t println(const char* s = "");
+  size_t println(const String& s) { return println(s.c_str()); }
+  size_t println(int v);
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  int available() { return (int)input.size(); }
+  int read();
+
+  bool muted = false;     // 🔇 Suppress output (set by tests)
+  bool capture = false;   // 📝 Append output to captured instead of stdout (wins over muted)
+  std::string captured;
+  std::string input;      // ⌨️ Bytes the next read() calls return (set by tests)
+
+ private:
+  size_t emit(const char* s, size_t n);
+};
+
+extern HardwareSerial Serial;
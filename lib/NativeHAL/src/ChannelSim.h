@@ -0,0 +1,224 @@
+#pragma once
+
+// 📡 Channel simulator for the host link suites (data rate, TX power)
+// The real LoRaTask next to a simulated flight board over a path-loss
+// channel. A frame is heard only if the receiver is tuned to the SF /
+// bandwidth it went out on and its SNR (RSSI − thermal noise in that
+// bandwidth, ± fading) clears the demodulator floor of that SF. Uplink RSSI
+// uses the power each frame went out with (LoRa.sent[].txPower); the air
+// always answers at PROTO_LORA_TX_POWER, in its TDMA slot, with trailered
+// telemetry (sequence, echo, reliable acks). Time on air follows the modem
+// settings. Header-only: one copy per suite.
+
+#include <LoRa.h>
+#include <SPI.h>
+
+#include <math.h>
+#include <string.h>
+
+#include "Airtime.h"
+#include "DataRate.h"
+#include "LinkQuality.h"
+#include "RadioState.h"
+#include "SX1276.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_rate.h"
+#include "protocol_reliable.h"
+
+#ifdef PROTO_BIDIRECTIONAL  // The air answers in telemetry
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#define SIM_STEP_US 100
+#define SIM_FADE_DB 3.0f  // ± uniform, per frame and direction
+#define SIM_SNR_REPORT_MAX 10.0f
+
+// 📡 Channel
+static float pathLossDb = 100.0f;
+static uint32_t rng = 1;
+
+static float fade() {
+  rng = rng * 1103515245u + 12345u;
+  return ((rng >> 16) % 1000 / 999.0f * 2.0f - 1.0f) * SIM_FADE_DB;
+}
+
+static float noiseFloorDbm(long bw) {
+  return -174.0f + 10.0f * log10f((float)bw) + DATA_RATE_NOISE_FIGURE_DB;
+}
+
+static bool decodes(int sf, long bw, float rssi) {
+  return rssi - noiseFloorDbm(bw) >= -7.5f - 2.5f * (sf - 7);
+}
+
+static unsigned long airtimeOf(size_t len, int sf, long bw) {
+  return loraAirtimeUs(len, sf, bw, PROTO_LORA_CR, PROTO_LORA_PREAMBLE, true, false);
+}
+
+static unsigned long fakeAirtime(size_t len) {
+  return airtimeOf(len, LoRa.spreadingFactor, LoRa.bandwidth);
+}
+
+// 🛩️ Flight board: reliable acks, uplink RSSI report + the protocol_rate.h air side
+struct AirNode {
+  ProtoRateAir rate;
+  bool adr;           // false = firmware without PROTO_REL_OP_RATE (rejects the op, never acks it)
+  bool reportsRssi;   // false = firmware that leaves ProtoTlmPacket.rssi at 0
+  bool dropRateAck;   // 🧪 Lose the telemetry that acks the next switch
+  uint8_t ackId;
+  uint8_t ackMask;
+  uint8_t tlmSeq;
+  uint8_t echo;
+  int8_t upRssi;
+  bool replyPending;
+  unsigned long replyEndUs;
+};
+
+struct SimStats {
+  uint32_t cmdSent;
+  uint32_t cmdHeard;        // Command frames the air decoded
+  uint32_t cmdLost;         // ...below its sensitivity
+  uint32_t maxLossRun;
+  uint32_t lossRun;
+  uint32_t tlmHeard;        // Telemetry frames the ground decoded
+  uint32_t profileMismatch; // Frames sent while the ends were tuned apart
+  unsigned long maxCmdGapUs;
+};
+
+static AirNode air;
+static SimStats sim;
+static size_t seen = 0;
+static unsigned long lastHeardUs = 0;
+
+static ProtoRateProfile airProfile() {
+  return proto_rate_profile(air.rate.profile);
+}
+
+static void airOnFrame(const FakeLoRaFrame& f) {
+  const ProtoRateProfile p = airProfile();
+  if (f.data[0] != PROTO_CMD_MAGIC)
+    return;
+  sim.cmdSent++;
+  if (f.spreadingFactor != p.sf || f.bandwidth != p.bandwidthHz) {
+    sim.profileMismatch++;
+    return;
+  }
+  float rssi = f.txPower - pathLossDb + fade();
+  if (!decodes(p.sf, p.bandwidthHz, rssi)) {
+    sim.cmdLost++;
+    if (++sim.lossRun > sim.maxLossRun)
+      sim.maxLossRun = sim.lossRun;
+    return;
+  }
+  sim.lossRun = 0;
+
+  uint8_t id, op = 0, arg = 0;
+  const uint8_t* t = f.data.data() + PROTO_CMD_PACKET_SIZE;
+  size_t tLen = f.data.size() - PROTO_CMD_PACKET_SIZE;
+  if (proto_rel_decode(t, tLen, &id, &op, &arg) && (air.adr || op != PROTO_REL_OP_RATE)) {
+    if (!proto_rel_ack_window_add(&air.ackId, &air.ackMask, id))
+      op = 0;  // Heard before
+  } else {
+    op = 0;
+  }
+  proto_rate_air_heard(&air.rate, op, arg, millis());
+
+  sim.cmdHeard++;
+  if (lastHeardUs && f.atUs - lastHeardUs > sim.maxCmdGapUs)
+    sim.maxCmdGapUs = f.atUs - lastHeardUs;
+  lastHeardUs = f.atUs;
+  air.upRssi = (int8_t)lroundf(rssi);
+  air.echo++;
+  air.replyEndUs = f.atUs + airtimeOf(f.data.size(), p.sf, p.bandwidthHz) + TDMA_TURNAROUND_US +
+                   airtimeOf(PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE, p.sf, p.bandwidthHz);
+  air.replyPending = true;
+}
+
+static void airSendTelemetry() {
+  air.replyPending = false;
+  const ProtoRateProfile p = airProfile();
+  const bool acksSwitch = air.rate.next != air.rate.profile;
+
+  uint8_t tlm[PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE] = {};
+  ProtoTlmPacket pkt = {};
+  pkt.magic = PROTO_TLM_MAGIC;
+  pkt.rssi = air.reportsRssi ? air.upRssi : 0;
+  pkt.checksum = proto_checksum((const uint8_t*)&pkt, PROTO_TLM_PACKET_SIZE - 1);
+  memcpy(tlm, &pkt, PROTO_TLM_PACKET_SIZE);
+  uint8_t* trailer = tlm + PROTO_TLM_PACKET_SIZE;
+  trailer[0] = air.tlmSeq++;
+  trailer[1] = air.echo;
+  trailer[2] = LINK_ECHO_AGE_UNKNOWN;
+  trailer[3] = air.ackId;
+  trailer[4] = air.ackMask;
+
+  float rssi = PROTO_LORA_TX_POWER - pathLossDb + fade();
+  bool lost = acksSwitch && air.dropRateAck;
+  if (acksSwitch)
+    air.dropRateAck = false;
+  if (!lost && LoRa.spreadingFactor == p.sf && LoRa.bandwidth == p.bandwidthHz && decodes(p.sf, p.bandwidthHz, rssi)) {
+    float snr = rssi - noiseFloorDbm(p.bandwidthHz);
+    size_t before = LoRa.missedRx;
+    LoRa.injectRx(tlm, sizeof(tlm), (int)lroundf(rssi), snr > SIM_SNR_REPORT_MAX ? SIM_SNR_REPORT_MAX : snr);
+    sim.tlmHeard += LoRa.missedRx == before;
+  }
+  proto_rate_air_tlm_sent(&air.rate, millis());  // 📶 Retunes after the frame that acked it
+}
+
+static void runFor(unsigned long ms) {
+  const unsigned long endUs = micros() + ms * 1000UL;
+  while (micros() < endUs) {
+    hal_advanceMicros(SIM_STEP_US);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+    for (; seen < LoRa.sent.size(); seen++)
+      airOnFrame(LoRa.sent[seen]);
+    if (air.replyPending && micros() >= air.replyEndUs)
+      airSendTelemetry();
+    proto_rate_air_poll(&air.rate, millis());
+  }
+}
+
+static void startSession(bool direct) {
+  while (LoRa.txOnAir)
+    hal_advanceMicros(SIM_STEP_US);  // Last session's frame finishes before the chip is set up again
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  radioSetDirectSpi(direct);
+  setupRadio();
+  loraStartScheduler(NULL);
+  memset(&air, 0, sizeof(air));
+  air.adr = true;
+  air.reportsRssi = true;
+  proto_rate_air_init(&air.rate, millis());
+  sim = SimStats();
+  seen = LoRa.sent.size();
+  lastHeardUs = 0;
+}
+
+// setUp() / tearDown() halves every suite shares; each adds the feature it tests
+static void channelSimSetUp() {
+  LoRa.setPins(LORA_CS, LORA_RST, LORA_DIO0);
+  LoRa.txDurationFor = fakeAirtime;
+  Serial.muted = true;
+  rng = 1;
+  pathLossDb = 100.0f;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+}
+
+static void channelSimTearDown() {
+  for (int t = 0; t < 100 && LoRa.txOnAir; t++)
+    runFor(1);
+  sx1276Flush();
+  radioSetDirectSpi(false);
+  LoRa.txDurationFor = nullptr;
+  Serial.muted = false;
+}
+
+#endif
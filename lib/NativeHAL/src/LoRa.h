@@ -0,0 +1,129 @@
+// 💻 NativeHAL — fake sandeepmistry LoRa (SX1276) radio
+// Records every transmitted frame with its simulated timestamp and serves
+// injected frames back through parsePacket()/read(), so Lora.cpp runs unmodified.
+// An async endPacket() raises the DIO0 TX-done callback txDurationUs later on
+// the simulated clock. With onReceive() attached, injectRx() behaves like the
+// air: the frame lands (and DIO0 fires) only while the radio is in receive().
+// 📏 receive(size) models implicit-header RX: only frames of exactly that
+// length decode, anything else fails CRC.
+// 👂 channelActivityDetection() reports channelBusy(micros()) cadDurationUs
+// later through onCadDone() (or DIO0 with the CAD-done mapping).
+// 📶 Frames carry the SF / bandwidth (and TX power) they were sent or received
+// with; the mock chip's MODEM_CONFIG / PA_CONFIG registers (SPI.h) set the same
+// fields.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+#include "esp_timer.h"
+
+struct FakeLoRaFrame {
+  std::vector<uint8_t> data;
+  unsigned long atMs;  // ⏱️ Simulated millis() when sent / injected
+  unsigned long atUs;  // ⏱️ Same, micros()
+  int rssi;
+  float snr;
+  bool implicitHeader;  // 📏 Sent with beginPacket(true)
+  int spreadingFactor;  // 📶 Modem settings at the time
+  long bandwidth;
+  int txPower;  // 🔋 dBm, sent frames
+};
+
+class LoRaClass {
+ public:
+  int begin(long frequency);
+  void end() {}
+  void setPins(int ss, int reset, int dio0);
+
+  int beginPacket(int implicitHeader = false);
+  int endPacket(bool async = false);
+  size_t write(uint8_t b);
+  size_t write(const uint8_t* buffer, size_t size);
+
+  int parsePacket(int size = 0);
+  int available();
+  int read();
+  int peek();
+  int packetRssi() { return rxRssi; }
+  float packetSnr() { return rxSnr; }
+
+  void onTxDone(void (*callback)());  // The library's DIO0 ISR replaces whatever was attached to the pin
+  void onReceive(void (*callback)(int));
+  void onCadDone(void (*callback)(bool));
+  void channelActivityDetection();  // Standby → CAD → standby
+
+  void idle() { changeMode(false); }
+  void sleep() { changeMode(false); }
+  void receive(int size = 0) {
+    rxImplicitSize = size;  // 0 = explicit header
+    changeMode(true);
+  }
+
+  void setTxPower(int level, int outputPin = 1) {
+    (void)outputPin;
+    txPower = level;
+  }
+  void setFrequency(long f) { frequency = f; }
+  void setSpreadingFactor(int sf) { spreadingFactor = sf; }
+  void setSignalBandwidth(long sbw) { bandwidth = sbw; }
+  void setCodingRate4(int denominator) { codingRate = denominator; }
+  void setPreambleLength(long length) { preamble = length; }
+  void setSyncWord(int sw) { syncWord = sw; }
+  void enableCrc() { crc = true; }
+  void disableCrc() { crc = false; }
+
+  // 🧪 Test hooks
+  void reset();                                          // Clear logs, keep beginOk, callbacks and a TX on air
+  void injectRx(const uint8_t* data, size_t len, int rssi = -60, float snr = 9.5f);
+
+  bool beginOk = true;           // begin() result
+  std::vector<FakeLoRaFrame> sent;  // Every completed TX, oldest first
+  std::deque<FakeLoRaFrame> rxQueue;
+  unsigned long parseCalls = 0;  // SPI-poll counter (parsePacket invocations)
+  unsigned long txDurationUs = 0;  // Simulated time on air before DIO0 TX-done
+  unsigned long (*txDurationFor)(size_t len) = nullptr;  // ⏱️ Per frame (e.g. from the modem settings), overrides it
+  bool receiving = false;          // In continuous RX (receive() called, no TX since)
+  bool txOnAir = false;            // Async TX between endPacket() and TX done
+  bool txDoneIrq = true;           // false = DIO0 TX-done edge gets lost
+  unsigned long missedRx = 0;      // Frames that arrived while not receiving
+  unsigned long txAborts = 0;      // Mode changes that cut an on-air TX short
+  int rxImplicitSize = 0;          // 📏 Payload length of the last receive(size), 0 = explicit
+  unsigned long rxCrcErrors = 0;   // Implicit RX of a frame with another length
+  bool (*channelBusy)(unsigned long us) = nullptr;  // 👂 Other users of the channel, nullptr = always clear
+  unsigned long cadDurationUs = 1000;               // ~2 symbols at SF7 / 250 kHz
+  unsigned long cadRuns = 0;
+  bool cadActive = false;
+
+  long frequency = 0;
+  int spreadingFactor = 7;
+  long bandwidth = 125000;
+  int codingRate = 5;
+  long preamble = 8;
+  int syncWord = 0x12;
+  int txPower = 17;
+  bool crc = false;
+  int pinSS = -1, pinReset = -1, pinDio0 = -1;
+
+ private:
+  static void txDoneTimer(void* arg);
+  static void cadDoneTimer(void* arg);
+  void changeMode(bool rx);
+
+  std::vector<uint8_t> txBuf;
+  bool txImplicit = false;
+  void (*txDoneCallback)() = nullptr;
+  void (*rxDoneCallback)(int) = nullptr;
+  void (*cadDoneCallback)(bool) = nullptr;
+  esp_timer_handle_t txTimer = nullptr;
+  esp_timer_handle_t cadTimer = nullptr;
+  FakeLoRaFrame rxFrame;
+  size_t rxPos = 0;
+  int rxRssi = 0;
+  float rxSnr = 0.0f;
+};
+
+extern LoRaClass LoRa;
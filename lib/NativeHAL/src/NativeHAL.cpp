@@ -0,0 +1,810 @@
+// 💻 NativeHAL — definitions for the host fakes
+#include <LoRa.h>
+#include <OLEDDisplayUi.h>
+#include <SPI.h>
+#include <driver/spi_master.h>
+#include <ps5Controller.h>
+#include <string.h>
+#include <map>
+
+#include "Arduino.h"
+#include "esp_bt_device.h"
+#include "esp_gap_bt_api.h"
+#include "esp_timer.h"
+
+// ⏱️ Simulated clock (microsecond resolution)
+static unsigned long long simMicros = 0;
+
+// ⏰ esp_timer instances, fired in deadline order as the clock advances
+struct HalTimer {
+  esp_timer_cb_t callback;
+  void* arg;
+  unsigned long long dueUs;
+  unsigned long long periodUs;  // 0 = one-shot
+  bool armed;
+};
+static std::vector<HalTimer*> timers;
+
+static void advanceTo(unsigned long long targetUs) {
+  while (true) {
+    HalTimer* next = NULL;
+    for (HalTimer* t : timers) {
+      if (t->armed && t->dueUs <= targetUs && (!next || t->dueUs < next->dueUs))
+        next = t;
+    }
+    if (!next)
+      break;
+    if (next->dueUs > simMicros)
+      simMicros = next->dueUs;
+    if (next->periodUs)
+      next->dueUs += next->periodUs;
+    else
+      next->armed = false;
+    next->callback(next->arg);
+  }
+  simMicros = targetUs;
+}
+
+unsigned long millis() {
+  return (unsigned long)(simMicros / 1000ULL);
+}
+
+unsigned long micros() {
+  return (unsigned long)simMicros;
+}
+
+void delay(unsigned long ms) {
+  advanceTo(simMicros + (unsigned long long)ms * 1000ULL);
+}
+
+void hal_setMillis(unsigned long ms) {
+  simMicros = (unsigned long long)ms * 1000ULL;
+}
+
+void hal_advanceMillis(unsigned long ms) {
+  advanceTo(simMicros + (unsigned long long)ms * 1000ULL);
+}
+
+void hal_advanceMicros(unsigned long us) {
+  advanceTo(simMicros + us);
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out_handle) {
+  if (!args || !args->callback || !out_handle)
+    return ESP_ERR_INVALID_ARG;
+  HalTimer* t = new HalTimer{args->callback, args->arg, 0, 0, false};
+  timers.push_back(t);
+  *out_handle = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+  if (timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->periodUs = period_us;
+  timer->dueUs = simMicros + period_us;
+  timer->armed = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  if (timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->periodUs = 0;
+  timer->dueUs = simMicros + timeout_us;
+  timer->armed = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->armed = false;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void) {
+  return (int64_t)simMicros;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+static uint32_t randomState = 1;
+
+void randomSeed(unsigned long seed) {
+  randomState = seed ? (uint32_t)seed : 1;
+}
+
+long random(long howbig) {
+  if (howbig <= 0)
+    return 0;
+  randomState ^= randomState << 13;  // xorshift32
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return (long)(randomState % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// 📌 GPIO / ADC
+static uint8_t pinLevels[64];
+static int analogLevels[64];
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < 64)
+    pinLevels[pin] = val;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < 64 ? pinLevels[pin] : 0;
+}
+
+int analogRead(uint8_t pin) {
+  return pin < 64 ? analogLevels[pin] : 0;
+}
+
+void hal_setAnalog(uint8_t pin, int value) {
+  if (pin < 64)
+    analogLevels[pin] = value;
+}
+
+// ⚡ GPIO interrupts
+static void (*pinIsrs[64])(void);
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+  (void)mode;
+  if (pin < 64)
+    pinIsrs[pin] = isr;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < 64)
+    pinIsrs[pin] = NULL;
+}
+
+bool hal_interruptAttached(int pin) {
+  return pin >= 0 && pin < 64 && pinIsrs[pin];
+}
+
+void hal_raiseInterrupt(int pin) {
+  if (hal_interruptAttached(pin))
+    pinIsrs[pin]();
+}
+
+// 📊 Serial
+HardwareSerial Serial;
+
+size_t HardwareSerial::emit(const char* s, size_t n) {
+  if (capture) {
+    captured.append(s, n);
+    return n;
+  }
+  return muted ? 0 : fwrite(s, 1, n, stdout);
+}
+
+size_t HardwareSerial::print(const char* s) {
+  return emit(s, strlen(s));
+}
+
+size_t HardwareSerial::print(int v) {
+  return printf("%d", v);
+}
+
+size_t HardwareSerial::println(const char* s) {
+  return printf("%s\n", s);
+}
+
+size_t HardwareSerial::println(int v) {
+  return printf("%d\n", v);
+}
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+  if (muted && !capture)
+    return 0;
+  char buf[512];
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (n < 0)
+    return 0;
+  return emit(buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+int HardwareSerial::read() {
+  if (input.empty())
+    return -1;
+  int c = (unsigned char)input[0];
+  input.erase(0, 1);
+  return c;
+}
+
+// 🧵 FreeRTOS — tasks are not scheduled on the host
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* params,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+  if (handle)
+    *handle = (TaskHandle_t)fn;
+  return pdPASS;
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)millis();
+}
+
+void vTaskDelay(TickType_t ticks) {
+  hal_advanceMillis(ticks);
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+  *previousWakeTime += increment;
+  int32_t ahead = (int32_t)(*previousWakeTime - (TickType_t)millis());
+  if (ahead > 0)
+    hal_advanceMillis((unsigned long)ahead);
+}
+
+static std::map<TaskHandle_t, uint32_t> notifyCounts;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return NULL;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  notifyCounts[task]++;
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+  notifyCounts[task]++;
+  if (higherPriorityTaskWoken)
+    *higherPriorityTaskWoken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+  uint32_t& count = notifyCounts[xTaskGetCurrentTaskHandle()];
+  uint32_t value = count;
+  if (value)
+    count = clearCountOnExit ? 0 : value - 1;
+  return value;
+}
+
+uint32_t hal_takeNotify(TaskHandle_t task) {
+  uint32_t value = notifyCounts[task];
+  notifyCounts[task] = 0;
+  return value;
+}
+
+// 🔌 Mock SX1276 on VSPI (LoRa-mode registers the driver touches)
+#define MOCK_REG_FIFO 0x00
+#define MOCK_REG_OP_MODE 0x01
+#define MOCK_REG_PA_CONFIG 0x09
+#define MOCK_REG_FIFO_ADDR_PTR 0x0D
+#define MOCK_REG_FIFO_TX_BASE 0x0E
+#define MOCK_REG_FIFO_RX_BASE 0x0F
+#define MOCK_REG_FIFO_RX_CURRENT 0x10
+#define MOCK_REG_IRQ_FLAGS 0x12
+#define MOCK_REG_RX_NB_BYTES 0x13
+#define MOCK_REG_PKT_SNR 0x19
+#define MOCK_REG_PKT_RSSI 0x1A
+#define MOCK_REG_MODEM_CONFIG_1 0x1D
+#define MOCK_REG_MODEM_CONFIG_2 0x1E
+#define MOCK_REG_PAYLOAD_LENGTH 0x22
+#define MOCK_REG_DIO_MAPPING_1 0x40
+#define MOCK_REG_PA_DAC 0x4D
+#define MOCK_MODE_TX 0x03
+#define MOCK_MODE_RX_CONT 0x05
+#define MOCK_IRQ_RX_DONE 0x40
+#define MOCK_IRQ_TX_DONE 0x08
+#define MOCK_IRQ_CAD_DONE 0x04
+#define MOCK_IRQ_CAD_DETECTED 0x01
+#define MOCK_MODE_CAD 0x07
+
+// 📡 Fake LoRa radio
+LoRaClass LoRa;
+SPIClass SPI;
+
+int LoRaClass::begin(long f) {
+  frequency = f;
+  receiving = false;  // 🔄 Chip reset: nothing on air
+  txOnAir = false;
+  cadActive = false;
+  if (txTimer)
+    esp_timer_stop(txTimer);
+  if (cadTimer)
+    esp_timer_stop(cadTimer);
+  return beginOk ? 1 : 0;
+}
+
+void LoRaClass::setPins(int ss, int reset, int dio0) {
+  pinSS = ss;
+  pinReset = reset;
+  pinDio0 = dio0;
+}
+
+void LoRaClass::onTxDone(void (*callback)()) {
+  txDoneCallback = callback;
+  if (callback && pinDio0 >= 0)
+    detachInterrupt((uint8_t)pinDio0);
+}
+
+void LoRaClass::onReceive(void (*callback)(int)) {
+  rxDoneCallback = callback;
+  if (callback && pinDio0 >= 0)
+    detachInterrupt((uint8_t)pinDio0);
+}
+
+void LoRaClass::onCadDone(void (*callback)(bool)) {
+  cadDoneCallback = callback;
+  if (callback && pinDio0 >= 0)
+    detachInterrupt((uint8_t)pinDio0);
+}
+
+void LoRaClass::channelActivityDetection() {
+  changeMode(false);
+  if (!cadTimer) {
+    esp_timer_create_args_t args = {&LoRaClass::cadDoneTimer, this, ESP_TIMER_TASK, "lora_cad", false};
+    esp_timer_create(&args, &cadTimer);
+  }
+  cadRuns++;
+  cadActive = true;
+  esp_timer_start_once(cadTimer, cadDurationUs);
+}
+
+void LoRaClass::cadDoneTimer(void* arg) {
+  LoRaClass* radio = (LoRaClass*)arg;
+  radio->cadActive = false;
+  bool detected = radio->channelBusy && radio->channelBusy(micros());
+  if (radio->cadDoneCallback)
+    radio->cadDoneCallback(detected);
+  if (SPI.raiseIrq(MOCK_IRQ_CAD_DONE | (detected ? MOCK_IRQ_CAD_DETECTED : 0)))
+    hal_raiseInterrupt(radio->pinDio0);
+}
+
+void LoRaClass::changeMode(bool rx) {
+  if (cadActive) {
+    cadActive = false;  // 👂 Mode change ends CAD without a result
+    esp_timer_stop(cadTimer);
+  }
+  if (txOnAir) {
+    txAborts++;  // 🚨 SX1276 leaves TX mid-frame
+    txOnAir = false;
+    esp_timer_stop(txTimer);
+  }
+  receiving = rx;
+}
+
+int LoRaClass::beginPacket(int implicitHeader) {
+  changeMode(false);  // Standby, like the SX1276
+  txBuf.clear();
+  txImplicit = implicitHeader;
+  return 1;
+}
+
+int LoRaClass::endPacket(bool async) {
+  unsigned long durationUs = txDurationFor ? txDurationFor(txBuf.size()) : txDurationUs;
+  sent.push_back({txBuf, millis(), micros(), 0, 0.0f, txImplicit, spreadingFactor, bandwidth, txPower});
+  txBuf.clear();
+  if (async && (txDoneCallback || hal_interruptAttached(pinDio0))) {
+    if (!txTimer) {
+      esp_timer_create_args_t args = {&LoRaClass::txDoneTimer, this, ESP_TIMER_TASK, "lora_txdone", false};
+      esp_timer_create(&args, &txTimer);
+    }
+    txOnAir = true;
+    esp_timer_start_once(txTimer, durationUs);
+  }
+  return 1;
+}
+
+void LoRaClass::txDoneTimer(void* arg) {
+  LoRaClass* radio = (LoRaClass*)arg;
+  radio->txOnAir = false;
+  if (!radio->txDoneIrq)
+    return;
+  if (radio->txDoneCallback)
+    radio->txDoneCallback();
+  if (SPI.raiseIrq(MOCK_IRQ_TX_DONE))
+    hal_raiseInterrupt(radio->pinDio0);  // 🔌 Register driver owns DIO0
+}
+
+size_t LoRaClass::write(uint8_t b) {
+  txBuf.push_back(b);
+  return 1;
+}
+
+size_t LoRaClass::write(const uint8_t* buffer, size_t size) {
+  txBuf.insert(txBuf.end(), buffer, buffer + size);
+  return size;
+}
+
+int LoRaClass::parsePacket(int size) {
+  parseCalls++;
+  if (rxQueue.empty())
+    return 0;
+  rxFrame = rxQueue.front();
+  rxQueue.pop_front();
+  rxPos = 0;
+  rxRssi = rxFrame.rssi;
+  rxSnr = rxFrame.snr;
+  return (int)rxFrame.data.size();
+}
+
+int LoRaClass::available() {
+  return (int)(rxFrame.data.size() - rxPos);
+}
+
+int LoRaClass::read() {
+  return rxPos < rxFrame.data.size() ? rxFrame.data[rxPos++] : -1;
+}
+
+int LoRaClass::peek() {
+  return rxPos < rxFrame.data.size() ? rxFrame.data[rxPos] : -1;
+}
+
+void LoRaClass::reset() {
+  sent.clear();
+  rxQueue.clear();
+  rxFrame = FakeLoRaFrame();
+  rxPos = 0;
+  parseCalls = 0;
+  missedRx = 0;
+  txAborts = 0;
+  rxCrcErrors = 0;
+  txDoneIrq = true;
+}
+
+void LoRaClass::injectRx(const uint8_t* data, size_t len, int rssi, float snr) {
+  FakeLoRaFrame frame = {std::vector<uint8_t>(data, data + len), millis(), micros(), rssi, snr, false, spreadingFactor,
+                         bandwidth};
+  if (!rxDoneCallback && !hal_interruptAttached(pinDio0)) {
+    rxQueue.push_back(frame);  // Polled mode: parsePacket() picks it up
+    return;
+  }
+  if (!receiving) {
+    missedRx++;  // 📡 Half duplex: nobody listening
+    return;
+  }
+  if (rxImplicitSize && len != (size_t)rxImplicitSize) {
+    rxCrcErrors++;  // 📏 Implicit header: the radio reads the wrong length
+    return;
+  }
+  rxFrame = frame;  // Lands in the FIFO, DIO0 rises
+  rxPos = 0;
+  rxRssi = rssi;
+  rxSnr = snr;
+  SPI.loadRxFrame(data, len, rssi, snr);  // 🔌 Same frame for direct register access
+  if (rxDoneCallback)
+    rxDoneCallback((int)len);
+  if (SPI.raiseIrq(MOCK_IRQ_RX_DONE))
+    hal_raiseInterrupt(pinDio0);
+}
+
+void SPIClass::reset() {
+  memset(regs, 0, sizeof(regs));
+  memset(fifo, 0, sizeof(fifo));
+  regs[0x01] = 0x09;  // FSK standby
+  regs[0x06] = 0x6C;  // 434 MHz
+  regs[0x07] = 0x80;
+  regs[0x09] = 0x4F;
+  regs[0x0B] = 0x2B;
+  regs[0x0C] = 0x20;
+  regs[MOCK_REG_FIFO_TX_BASE] = 0x80;
+  regs[MOCK_REG_MODEM_CONFIG_1] = 0x72;
+  regs[0x1E] = 0x70;
+  regs[0x21] = 0x08;  // Preamble LSB
+  regs[MOCK_REG_PAYLOAD_LENGTH] = 0x01;
+  regs[0x31] = 0xC3;
+  regs[0x37] = 0x0A;
+  regs[0x39] = 0x12;  // Sync word
+  regs[0x42] = 0x12;  // Version
+  regs[0x4D] = 0x84;
+  transactions = 0;
+  bytes = 0;
+  csErrors = 0;
+  inTransaction = false;
+}
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  (void)settings;
+  inTransaction = true;
+  addressNext = true;
+  transactions++;
+}
+
+void SPIClass::endTransaction() {
+  inTransaction = false;
+}
+
+uint8_t SPIClass::exchange(uint8_t out) {
+  bytes++;
+  if (csPin >= 0 && digitalRead((uint8_t)csPin) != LOW)
+    csErrors++;
+  if (!inTransaction)
+    return 0xFF;
+  if (addressNext) {
+    addressNext = false;
+    writing = out & 0x80;
+    address = out & 0x7F;
+    return 0;
+  }
+  if (address == MOCK_REG_FIFO) {  // Pointer advances, address stays
+    uint8_t& ptr = regs[MOCK_REG_FIFO_ADDR_PTR];
+    uint8_t in = fifo[ptr];
+    if (writing)
+      fifo[ptr] = out;
+    ptr++;
+    return writing ? 0 : in;
+  }
+  uint8_t reg = address;
+  address = (address + 1) & 0x7F;
+  if (writing) {
+    writeReg(reg, out);
+    return 0;
+  }
+  if (reg == MOCK_REG_OP_MODE && (regs[reg] & 0x07) == MOCK_MODE_TX && !LoRa.txOnAir)
+    regs[reg] = (regs[reg] & 0xF8) | 0x01;  // TX done → standby by itself
+  return regs[reg];
+}
+
+void SPIClass::writeReg(uint8_t reg, uint8_t value) {
+  if (reg == MOCK_REG_IRQ_FLAGS) {
+    regs[reg] &= (uint8_t)~value;  // Write 1 to clear
+    return;
+  }
+  regs[reg] = value;
+  if (reg == MOCK_REG_MODEM_CONFIG_1) {
+    static const long bandwidths[] = {7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000};
+    LoRa.bandwidth = bandwidths[(value >> 4) % 10];  // 📶 Same modem the fake radio models
+  } else if (reg == MOCK_REG_MODEM_CONFIG_2) {
+    LoRa.spreadingFactor = value >> 4;
+  } else if (reg == MOCK_REG_PA_CONFIG) {
+    LoRa.txPower = (regs[MOCK_REG_PA_DAC] == 0x87 ? 5 : 2) + (value & 0x0F);  // 🔋 PA_BOOST, high-power DAC +3 dB
+  }
+  if (reg != MOCK_REG_OP_MODE)
+    return;
+  bool implicitHeader = regs[MOCK_REG_MODEM_CONFIG_1] & 0x01;
+  switch (value & 0x07) {
+    case MOCK_MODE_TX: {
+      uint8_t frame[256];
+      uint8_t len = regs[MOCK_REG_PAYLOAD_LENGTH];
+      for (uint8_t i = 0; i < len; i++)
+        frame[i] = fifo[(uint8_t)(regs[MOCK_REG_FIFO_TX_BASE] + i)];
+      LoRa.beginPacket(implicitHeader);
+      LoRa.write(frame, len);
+      LoRa.endPacket(true);
+      break;
+    }
+    case MOCK_MODE_RX_CONT:
+      LoRa.receive(implicitHeader ? regs[MOCK_REG_PAYLOAD_LENGTH] : 0);
+      break;
+    case MOCK_MODE_CAD:
+      LoRa.channelActivityDetection();
+      break;
+    default:
+      LoRa.idle();
+      break;
+  }
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  return exchange(data);
+}
+
+void SPIClass::transfer(void* data, uint32_t size) {
+  uint8_t* p = (uint8_t*)data;
+  for (uint32_t i = 0; i < size; i++)
+    p[i] = exchange(p[i]);
+}
+
+void SPIClass::writeBytes(const uint8_t* data, uint32_t size) {
+  for (uint32_t i = 0; i < size; i++)
+    exchange(data[i]);
+}
+
+void SPIClass::loadRxFrame(const uint8_t* data, size_t len, int rssi, float snr) {
+  uint8_t base = regs[MOCK_REG_FIFO_RX_BASE];
+  for (size_t i = 0; i < len && i < sizeof(fifo); i++)
+    fifo[(uint8_t)(base + i)] = data[i];
+  regs[MOCK_REG_FIFO_RX_CURRENT] = base;
+  regs[MOCK_REG_RX_NB_BYTES] = (uint8_t)len;
+  regs[MOCK_REG_PKT_SNR] = (uint8_t)(int8_t)lroundf(snr * 4);
+  regs[MOCK_REG_PKT_RSSI] = (uint8_t)constrain(rssi + (LoRa.frequency && LoRa.frequency < 525000000L ? 164 : 157), 0, 255);
+  regs[MOCK_REG_FIFO_ADDR_PTR] = base;  // What the library's DIO0 ISR does before onReceive()
+}
+
+bool SPIClass::raiseIrq(uint8_t flags) {
+  regs[MOCK_REG_IRQ_FLAGS] |= flags;
+  switch (regs[MOCK_REG_DIO_MAPPING_1] & 0xC0) {
+    case 0x00: return flags & MOCK_IRQ_RX_DONE;
+    case 0x40: return flags & MOCK_IRQ_TX_DONE;
+    case 0x80: return flags & MOCK_IRQ_CAD_DONE;
+    default:   return false;
+  }
+}
+
+// 🔌 ESP-IDF spi_master on the same mock bus
+struct HalSpiDevice {
+  spi_device_interface_config_t config;
+  std::deque<spi_transaction_t*> queued;  // Head is on the bus
+  std::deque<spi_transaction_t*> done;
+  esp_timer_handle_t timer;
+  unsigned long long dueUs;  // Head finishes
+};
+
+static unsigned long busTimeUs(const HalSpiDevice* dev, const spi_transaction_t* t) {
+  unsigned long long bits = dev->config.address_bits + t->length;
+  return (unsigned long)((bits * 1000000ULL + dev->config.clock_speed_hz - 1) / dev->config.clock_speed_hz);
+}
+
+static void runTransaction(HalSpiDevice* dev, spi_transaction_t* t) {
+  const uint8_t* tx = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : (const uint8_t*)t->tx_buffer;
+  uint8_t* rx = (t->flags & SPI_TRANS_USE_RXDATA) ? t->rx_data : (uint8_t*)t->rx_buffer;
+  SPI.beginTransaction(SPISettings(dev->config.clock_speed_hz, MSBFIRST, dev->config.mode));
+  digitalWrite(dev->config.spics_io_num, LOW);  // Hardware CS
+  SPI.transfer((uint8_t)t->addr);
+  for (size_t i = 0; i < t->length / 8; i++) {
+    uint8_t in = SPI.transfer(tx ? tx[i] : 0);
+    if (rx)
+      rx[i] = in;
+  }
+  digitalWrite(dev->config.spics_io_num, HIGH);
+  SPI.endTransaction();
+}
+
+static void startNext(HalSpiDevice* dev) {
+  if (dev->queued.empty())
+    return;
+  unsigned long us = busTimeUs(dev, dev->queued.front());
+  dev->dueUs = simMicros + us;
+  esp_timer_start_once(dev->timer, us);
+}
+
+static void spiDmaDone(void* arg) {
+  HalSpiDevice* dev = (HalSpiDevice*)arg;
+  spi_transaction_t* t = dev->queued.front();
+  dev->queued.pop_front();
+  runTransaction(dev, t);  // Data moves as the transaction completes
+  dev->done.push_back(t);
+  if (dev->config.post_cb)
+    dev->config.post_cb(t);
+  startNext(dev);
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* bus, spi_dma_chan_t dma) {
+  (void)host;
+  (void)bus;
+  (void)dma;
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* config,
+                             spi_device_handle_t* handle) {
+  (void)host;
+  if (!config->clock_speed_hz || config->address_bits != 8 || config->queue_size <= 0)
+    return ESP_ERR_INVALID_ARG;
+  HalSpiDevice* dev = new HalSpiDevice();
+  dev->config = *config;
+  esp_timer_create_args_t args = {&spiDmaDone, dev, ESP_TIMER_TASK, "spi_dma", false};
+  esp_timer_create(&args, &dev->timer);
+  *handle = dev;
+  return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t dev, spi_transaction_t* trans, TickType_t ticksToWait) {
+  (void)ticksToWait;
+  if (dev->queued.size() + dev->done.size() >= (size_t)dev->config.queue_size)
+    return ESP_ERR_TIMEOUT;  // Results must be collected first
+  dev->queued.push_back(trans);
+  if (dev->queued.size() == 1)
+    startNext(dev);
+  return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t dev, spi_transaction_t** trans, TickType_t ticksToWait) {
+  while (dev->done.empty()) {
+    if (dev->queued.empty() || ticksToWait == 0)
+      return ESP_ERR_TIMEOUT;
+    hal_advanceMicros((unsigned long)(dev->dueUs - simMicros));  // ⏳ Caller blocks until the bus finishes
+  }
+  *trans = dev->done.front();
+  dev->done.pop_front();
+  return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t dev, spi_transaction_t* trans) {
+  if (!dev->queued.empty())
+    return ESP_ERR_INVALID_STATE;  // IDF: no polling while queued transactions are pending
+  hal_advanceMicros(busTimeUs(dev, trans));  // 🔁 The CPU spins for the whole transfer
+  runTransaction(dev, trans);
+  if (dev->config.post_cb)
+    dev->config.post_cb(trans);
+  return ESP_OK;
+}
+
+// 🖥️ Fake OLED
+const uint8_t ArialMT_Plain_10[] = {0x0A};
+const uint8_t ArialMT_Plain_16[] = {0x10};
+const uint8_t ArialMT_Plain_24[] = {0x18};
+
+void OLEDDisplay::clear() {
+  strings.clear();
+}
+
+void OLEDDisplay::drawString(int16_t x, int16_t y, const String& text) {
+  drawCalls++;
+  strings.emplace_back(text.c_str());
+}
+
+void OLEDDisplay::drawStringMaxWidth(int16_t x, int16_t y, uint16_t maxLineWidth, const String& text) {
+  drawString(x, y, text);
+}
+
+uint16_t OLEDDisplay::getStringWidth(const char* text) {
+  return (uint16_t)(strlen(text) * 6);  // ~ArialMT_Plain_10 average advance
+}
+
+bool OLEDDisplay::hasText(const char* needle) const {
+  for (const std::string& s : strings) {
+    if (s.find(needle) != std::string::npos)
+      return true;
+  }
+  return false;
+}
+
+int16_t OLEDDisplayUi::update() {
+  display->clear();
+  if (frames && frameCount)
+    frames[state.currentFrame % frameCount](display, &state, 0, 0);
+  for (uint8_t i = 0; i < overlayCount; i++)
+    overlays[i](display, &state);
+  display->display();
+  return (int16_t)(1000 / targetFPS);
+}
+
+// 🎮 Fake PS5 controller
+ps5Controller ps5;
+
+void ps5Controller::injectReport(const FakePs5Report& r, uint32_t parseDelayUs, uint32_t eventDelayUs) {
+  rxMicros = micros();
+  hal_advanceMicros(parseDelayUs);
+  parseMicros = micros();
+  hal_advanceMicros(eventDelayUs);
+  eventMicros = micros();
+  report = r;
+  if (connected && _callback_event)
+    _callback_event();
+}
+
+void ps5Controller::setConnected(bool isConnected) {
+  if (isConnected == connected)
+    return;
+  connected = isConnected;
+  if (connected && _callback_connect)
+    _callback_connect();
+  else if (!connected && _callback_disconnect)
+    _callback_disconnect();
+}
+
+// 🔵 Bluetooth stubs
+static const uint8_t fakeBtAddress[6] = {0x24, 0x0a, 0xc4, 0x00, 0x00, 0x01};
+
+const uint8_t* esp_bt_dev_get_address(void) {
+  return fakeBtAddress;
+}
+
+int esp_bt_gap_get_bond_device_num(void) {
+  return 0;
+}
+
+esp_err_t esp_bt_gap_get_bond_device_list(int* dev_num, esp_bd_addr_t* dev_list) {
+  *dev_num = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_bt_gap_remove_bond_device(esp_bd_addr_t bd_addr) {
+  return ESP_OK;
+}
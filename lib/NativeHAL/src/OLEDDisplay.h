@@ -0,0 +1,55 @@
+// 💻 NativeHAL — fake ThingPulse OLEDDisplay
+// Draw calls are counted and drawn strings are kept, so HUD frames can be
+// profiled and asserted on without a 128x64 framebuffer.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+enum OLEDDISPLAY_COLOR { BLACK = 0, WHITE = 1, INVERSE = 2 };
+
+enum OLEDDISPLAY_TEXT_ALIGNMENT {
+  TEXT_ALIGN_LEFT = 0,
+  TEXT_ALIGN_RIGHT = 1,
+  TEXT_ALIGN_CENTER = 2,
+  TEXT_ALIGN_CENTER_BOTH = 3
+};
+
+extern const uint8_t ArialMT_Plain_10[];
+extern const uint8_t ArialMT_Plain_16[];
+extern const uint8_t ArialMT_Plain_24[];
+
+class OLEDDisplay {
+ public:
+  virtual ~OLEDDisplay() {}
+
+  bool init() { return true; }
+  void clear();
+  void display() {}
+  void flipScreenVertically() {}
+
+  void setColor(OLEDDISPLAY_COLOR c) { color = c; }
+  void setFont(const uint8_t* f) { font = f; }
+  void setTextAlignment(OLEDDISPLAY_TEXT_ALIGNMENT a) { alignment = a; }
+
+  void drawString(int16_t x, int16_t y, const String& text);
+  void drawStringMaxWidth(int16_t x, int16_t y, uint16_t maxLineWidth, const String& text);
+  uint16_t getStringWidth(const char* text);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h) { drawCalls++; }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h) { drawCalls++; }
+  void drawProgressBar(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t progress) { drawCalls++; }
+  void drawXbm(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* xbm) { drawCalls++; }
+
+  // 🧪 Test hooks
+  bool hasText(const char* needle) const;  // Any drawn string contains needle
+
+  unsigned long drawCalls = 0;
+  std::vector<std::string> strings;  // Strings drawn since last clear()
+  OLEDDISPLAY_COLOR color = WHITE;
+  OLEDDISPLAY_TEXT_ALIGNMENT alignment = TEXT_ALIGN_LEFT;
+  const uint8_t* font = nullptr;
+};
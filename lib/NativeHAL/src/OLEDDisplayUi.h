@@ -0,0 +1,54 @@
+// 💻 NativeHAL — fake ThingPulse OLEDDisplayUi
+// update() renders the current frame plus overlays once per call; there is no
+// transition animation, which keeps per-frame cost comparable between runs.
+#pragma once
+
+#include "OLEDDisplay.h"
+
+enum AnimationDirection { SLIDE_UP, SLIDE_DOWN, SLIDE_LEFT, SLIDE_RIGHT };
+enum IndicatorPosition { TOP, RIGHT, BOTTOM, LEFT };
+enum IndicatorDirection { LEFT_RIGHT, RIGHT_LEFT };
+
+struct OLEDDisplayUiState {
+  uint8_t currentFrame = 0;
+  void* userData = nullptr;
+};
+
+typedef void (*FrameCallback)(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int16_t y);
+typedef void (*OverlayCallback)(OLEDDisplay* display, OLEDDisplayUiState* state);
+
+class OLEDDisplayUi {
+ public:
+  explicit OLEDDisplayUi(OLEDDisplay* display) : display(display) {}
+
+  void init() { display->init(); }
+  void setTargetFPS(uint8_t fps) { targetFPS = fps; }
+  void setActiveSymbol(const uint8_t* symbol) {}
+  void setInactiveSymbol(const uint8_t* symbol) {}
+  void setIndicatorPosition(IndicatorPosition pos) {}
+  void setIndicatorDirection(IndicatorDirection dir) {}
+  void setFrameAnimation(AnimationDirection dir) {}
+  void disableAutoTransition() {}
+  void disableAllIndicators() {}
+
+  void setFrames(FrameCallback* frameFunctions, uint8_t count) {
+    frames = frameFunctions;
+    frameCount = count;
+  }
+  void setOverlays(OverlayCallback* overlayFunctions, uint8_t count) {
+    overlays = overlayFunctions;
+    overlayCount = count;
+  }
+  void switchToFrame(uint8_t frame) { state.currentFrame = frame; }
+  void nextFrame() { state.currentFrame = frameCount ? (state.currentFrame + 1) % frameCount : 0; }
+
+  int16_t update();  // Render once; returns ms left in the frame budget
+
+  OLEDDisplay* display;
+  OLEDDisplayUiState state;
+  FrameCallback* frames = nullptr;
+  uint8_t frameCount = 0;
+  OverlayCallback* overlays = nullptr;
+  uint8_t overlayCount = 0;
+  uint8_t targetFPS = 60;
+};
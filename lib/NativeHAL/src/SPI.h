@@ -0,0 +1,64 @@
+// 💻 NativeHAL — mock VSPI bus with an SX1276 behind it
+// Counts every transaction (beginTransaction() … endTransaction()) and byte,
+// and answers like the SX1276 in LoRa mode: the first byte is the register
+// address (bit 7 = write), further bytes auto-increment through the register
+// file, except REG_FIFO which reads / writes the FIFO at REG_FIFO_ADDR_PTR.
+// The chip is the same one the fake LoRa radio models: an OP_MODE write of TX
+// hands the FIFO frame to it (LoRa.sent, DIO0 TX done), RX continuous / standby
+// switch its receive state, MODEM_CONFIG_1 / 2 writes set its bandwidth / SF,
+// PA_CONFIG (after PA_DAC) its TX power, and every frame it receives lands in
+// this FIFO with packet RSSI / SNR, the way the library's DIO0 ISR leaves it.
+// TX / RX / CAD done also set REG_IRQ_FLAGS and, when REG_DIO_MAPPING_1 routes
+// them there, raise the DIO0 pin interrupt (attachInterrupt(), LoRa.setPins()).
+// driver/spi_master.h runs ESP-IDF transactions on this same bus.
+// Nothing here runs for code that only uses the LoRa library (no transactions).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SPI_MODE0 0
+
+class SPISettings {
+ public:
+  SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = 1, uint8_t dataMode = SPI_MODE0)
+      : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+class SPIClass {
+ public:
+  SPIClass() { reset(); }
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings settings);
+  void endTransaction();
+  uint8_t transfer(uint8_t data);
+  void transfer(void* data, uint32_t size);  // In place, like the ESP32 core
+  void writeBytes(const uint8_t* data, uint32_t size);
+
+  // 🧪 Test hooks
+  void reset();  // Power-on registers, counters cleared
+  void loadRxFrame(const uint8_t* data, size_t len, int rssi, float snr);  // Fake radio → FIFO
+  bool raiseIrq(uint8_t flags);  // Sets REG_IRQ_FLAGS; true when REG_DIO_MAPPING_1 routes them to DIO0
+
+  unsigned long transactions = 0;
+  unsigned long bytes = 0;        // Address bytes included
+  unsigned long csErrors = 0;     // Bytes clocked while csPin was high
+  int csPin = -1;                 // Checked when ≥ 0
+  uint8_t regs[0x80] = {};
+  uint8_t fifo[256] = {};
+
+ private:
+  uint8_t exchange(uint8_t out);
+  void writeReg(uint8_t reg, uint8_t value);
+
+  bool inTransaction = false;
+  bool addressNext = false;
+  bool writing = false;
+  uint8_t address = 0;
+};
+
+extern SPIClass SPI;
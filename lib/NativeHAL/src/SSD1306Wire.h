@@ -0,0 +1,14 @@
+// 💻 NativeHAL — fake SSD1306 I2C panel
+#pragma once
+
+#include "OLEDDisplay.h"
+
+class SSD1306Wire : public OLEDDisplay {
+ public:
+  SSD1306Wire(uint8_t address, int sda = -1, int scl = -1) : address(address) {
+    (void)sda;
+    (void)scl;
+  }
+
+  uint8_t address;
+};
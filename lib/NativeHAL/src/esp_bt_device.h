@@ -0,0 +1,6 @@
+// 💻 NativeHAL — esp_bt_device.h subset
+#pragma once
+
+#include <stdint.h>
+
+const uint8_t* esp_bt_dev_get_address(void);
@@ -0,0 +1,2 @@
+// 💻 NativeHAL — esp_bt_main.h placeholder
+#pragma once
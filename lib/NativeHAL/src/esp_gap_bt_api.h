@@ -0,0 +1,12 @@
+// 💻 NativeHAL — esp_gap_bt_api.h subset (bond list is always empty)
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef uint8_t esp_bd_addr_t[6];
+
+int esp_bt_gap_get_bond_device_num(void);
+esp_err_t esp_bt_gap_get_bond_device_list(int* dev_num, esp_bd_addr_t* dev_list);
+esp_err_t esp_bt_gap_remove_bond_device(esp_bd_addr_t bd_addr);
@@ -0,0 +1,92 @@
+// 💻 NativeHAL — fake ps5Controller
+// Mirrors the accessor surface of lib/PS5Library so PS5Joystick.cpp builds
+// unchanged. injectReport() plays the role of the Bluetooth task: it stores
+// the report and fires the attached notify() callback.
+#ifndef ps5Controller_h
+#define ps5Controller_h
+
+#include "Arduino.h"
+
+struct FakePs5Report {
+  bool up, down, left, right;
+  bool square, cross, circle, triangle;
+  bool l1, r1, l2, r2;
+  bool share, options, l3, r3;
+  bool ps, touchpad;
+  int8_t lx, ly, rx, ry;
+  uint8_t l2Value, r2Value;
+};
+
+class ps5Controller {
+ public:
+  typedef void (*callback_t)();
+
+  bool begin() { return true; }
+  bool begin(const char* mac) {
+    (void)mac;
+    return true;
+  }
+  void end() {}
+
+  bool isConnected() { return connected; }
+
+  void attach(callback_t callback) { _callback_event = callback; }
+  void attachOnConnect(callback_t callback) { _callback_connect = callback; }
+  void attachOnDisconnect(callback_t callback) { _callback_disconnect = callback; }
+
+  bool Right() { return report.right; }
+  bool Down() { return report.down; }
+  bool Up() { return report.up; }
+  bool Left() { return report.left; }
+
+  bool Square() { return report.square; }
+  bool Cross() { return report.cross; }
+  bool Circle() { return report.circle; }
+  bool Triangle() { return report.triangle; }
+
+  bool L1() { return report.l1; }
+  bool R1() { return report.r1; }
+  bool L2() { return report.l2; }
+  bool R2() { return report.r2; }
+
+  bool Share() { return report.share; }
+  bool Options() { return report.options; }
+  bool L3() { return report.l3; }
+  bool R3() { return report.r3; }
+
+  bool PSButton() { return report.ps; }
+  bool Touchpad() { return report.touchpad; }
+
+  uint8_t L2Value() { return report.l2Value; }
+  uint8_t R2Value() { return report.r2Value; }
+
+  int8_t LStickX() { return report.lx; }
+  int8_t LStickY() { return report.ly; }
+  int8_t RStickX() { return report.rx; }
+  int8_t RStickY() { return report.ry; }
+
+  uint32_t RxMicros() { return rxMicros; }
+  uint32_t ParseMicros() { return parseMicros; }
+  uint32_t EventMicros() { return eventMicros; }
+
+  // 🧪 Test hooks
+  // Store report + fire notify(); the simulated clock advances by the BT stage delays
+  void injectReport(const FakePs5Report& r, uint32_t parseDelayUs = 0, uint32_t eventDelayUs = 0);
+  void setConnected(bool isConnected);        // Fire connect/disconnect callbacks
+
+  FakePs5Report report = {};
+  bool connected = false;
+
+ private:
+  uint32_t rxMicros = 0;
+  uint32_t parseMicros = 0;
+  uint32_t eventMicros = 0;
+
+  callback_t _callback_event = nullptr;
+  callback_t _callback_connect = nullptr;
+  callback_t _callback_disconnect = nullptr;
+};
+
+extern ps5Controller ps5;
+
+#endif
@@ -120,6 +120,8 @@ typedef struct {
   ps5_status_t status;
   ps5_sensor_t sensor;
   uint8_t* latestPacket;
+  uint32_t rxMicros;     // esp_timer time of the L2CAP data indication
+  uint32_t parseMicros;  // esp_timer time parsePacket() finished decoding
 } ps5_t;
 
 /***************************/
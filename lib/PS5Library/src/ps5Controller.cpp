@@ -104,6 +104,7 @@ void ps5Controller::_event_callback(
 
   memcpy(&This->data, &data, sizeof(ps5_t));
   memcpy(&This->event, &event, sizeof(ps5_event_t));
+  This->eventMicros = micros();
 
   if (This->_callback_event) {
     This->_callback_event();
@@ -36,6 +36,11 @@ class ps5Controller {
 
   uint8_t* LatestPacket() { return data.latestPacket; }
 
+  // Latency timestamps (micros()) of the report currently in `data`
+  uint32_t RxMicros() { return data.rxMicros; }
+  uint32_t ParseMicros() { return data.parseMicros; }
+  uint32_t EventMicros() { return eventMicros; }
+
  public:
   bool Right() { return data.button.right; }
   bool Down() { return data.button.down; }
@@ -77,6 +82,8 @@ class ps5Controller {
   static void _event_callback(void* object, ps5_t data, ps5_event_t event);
   static void _connection_callback(void* object, uint8_t isConnected);
 
+  uint32_t eventMicros = 0;
+
   callback_t _callback_event = nullptr;
   callback_t _callback_connect = nullptr;
   callback_t _callback_disconnect = nullptr;
@@ -103,6 +103,7 @@ void ps5PacketEvent(ps5_t ps5, ps5_event_t event);
 /********************************************************************************/
 
 void parsePacket(uint8_t* packet);
+void parserSetRxTimestamp(uint32_t rx_us);
 void parsePacketWithLength(uint8_t* packet, uint16_t length);
 
 /********************************************************************************/
@@ -4,6 +4,7 @@
 #include "ps5.h"
 #include "ps5_int.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_bt.h"
 #include "esp_bt_main.h"
 #include "esp_gap_bt_api.h"
@@ -349,6 +350,7 @@ static void ps5_l2cap_disconnect_cfm_cback(uint16_t l2cap_cid, uint16_t result)
 *******************************************************************************/
 static void ps5_l2cap_data_ind_cback(uint16_t l2cap_cid, BT_HDR *p_buf) {
     if (p_buf->length > 2) {
+        parserSetRxTimestamp((uint32_t)esp_timer_get_time());
         parsePacket(p_buf->data);
     }
 
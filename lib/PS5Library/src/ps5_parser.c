@@ -1,4 +1,5 @@
 #include <esp_system.h>
+#include <esp_timer.h>
 #include <stdlib.h>
 
 #include "ps5.h"
@@ -72,6 +73,7 @@ ps5_event_t parseEvent(ps5_t prev, ps5_t cur);
 
 static ps5_t ps5;
 static ps5_event_callback_t ps5_event_cb = NULL;
+static uint32_t rx_timestamp_us = 0;
 
 /********************************************************************************/
 /*                      P U B L I C    F U N C T I O N S */
@@ -80,6 +82,10 @@ void parserSetEventCb(ps5_event_callback_t cb) {
   ps5_event_cb = cb;
 }
 
+void parserSetRxTimestamp(uint32_t rx_us) {
+  rx_timestamp_us = rx_us;
+}
+
 void parsePacket(uint8_t* packet) {
   ps5_t prev_ps5 = ps5;
 
@@ -87,6 +93,8 @@ void parsePacket(uint8_t* packet) {
   ps5.analog.stick = parsePacketAnalogStick(packet);
   ps5.analog.button = parsePacketAnalogButton(packet);
   ps5.latestPacket = packet;
+  ps5.rxMicros = rx_timestamp_us;
+  ps5.parseMicros = (uint32_t)esp_timer_get_time();
 
   ps5_event_t ps5Event = parseEvent(prev_ps5, ps5);
 
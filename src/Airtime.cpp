@@ -0,0 +1,44 @@
+#include "Airtime.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+
+// 📒 Ring of 100 ms buckets tagged with their absolute slot number, so readers
+// (DisplayTask) can skip stale buckets without the writer (LoRaTask) expiring them.
+#define AIRTIME_BUCKET_MS (1000 / AIRTIME_LEDGER_BUCKETS)
+
+static std::atomic<uint32_t> bucketUs[AIRTIME_LEDGER_BUCKETS];
+static std::atomic<uint32_t> bucketSlot[AIRTIME_LEDGER_BUCKETS];
+
+void airtimeRecord(uint32_t us) {
+  uint32_t slot = millis() / AIRTIME_BUCKET_MS;
+  uint8_t i = slot % AIRTIME_LEDGER_BUCKETS;
+  if (bucketSlot[i].load(std::memory_order_relaxed) != slot) {  // Bucket left over from an older second
+    bucketUs[i].store(0, std::memory_order_relaxed);
+    bucketSlot[i].store(slot, std::memory_order_relaxed);
+  }
+  bucketUs[i].fetch_add(us, std::memory_order_relaxed);
+}
+
+uint32_t airtimeUsedUs() {
+  uint32_t now = millis() / AIRTIME_BUCKET_MS;
+  uint32_t used = 0;
+  for (uint8_t i = 0; i < AIRTIME_LEDGER_BUCKETS; i++) {
+    if (now - bucketSlot[i].load(std::memory_order_relaxed) < AIRTIME_LEDGER_BUCKETS)
+      used += bucketUs[i].load(std::memory_order_relaxed);
+  }
+  return used;
+}
+
+uint32_t airtimeRemainingUs() {
+  uint32_t used = airtimeUsedUs();
+  return used >= LORA_AIRTIME_BUDGET_US ? 0 : LORA_AIRTIME_BUDGET_US - used;
+}
+
+void airtimeReset() {
+  for (uint8_t i = 0; i < AIRTIME_LEDGER_BUCKETS; i++) {
+    bucketUs[i].store(0);
+    bucketSlot[i].store(UINT32_MAX - AIRTIME_LEDGER_BUCKETS);  // Never "recent"
+  }
+}
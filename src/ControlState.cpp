@@ -0,0 +1,76 @@
+#include "ControlState.h"
+
+#include <string.h>
+
+#include <atomic>
+
+// Seqlock storage: the struct lives in relaxed atomic words, so a reader
+// racing a writer sees torn words at worst — and the sequence check discards those.
+#define CONTROL_WORDS ((sizeof(ControlState) + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+
+static std::atomic<uint32_t> sequence(0);           // Odd while a write is in progress
+static std::atomic<uint32_t> words[CONTROL_WORDS];  // Published state
+static std::atomic_flag writerLock = ATOMIC_FLAG_INIT;
+static std::atomic<uint32_t> retries(0);
+
+static ControlState writeBuffer;  // Writer-private working copy (guarded by writerLock)
+
+static void publish(const ControlState& s) {
+  uint32_t raw[CONTROL_WORDS] = {0};
+  memcpy(raw, &s, sizeof(ControlState));
+  for (size_t i = 0; i < CONTROL_WORDS; i++)
+    words[i].store(raw[i], std::memory_order_relaxed);
+}
+
+void controlInit() {
+  ControlState& s = controlBeginWrite();
+  memset(&s, 0, sizeof(s));
+  s.aileron = 127;
+  s.rudder = 127;
+  s.elevators = 127;
+  s.emergencyStop = true;  // 🚨 Power up disarmed
+  s.ecoMode = true;        // 🌿 Default ON
+  controlEndWrite();
+}
+
+ControlState controlSnapshot() {
+  uint32_t raw[CONTROL_WORDS];
+  uint32_t before, after;
+
+  while (true) {
+    before = sequence.load(std::memory_order_acquire);
+    if (!(before & 1)) {
+      for (size_t i = 0; i < CONTROL_WORDS; i++)
+        raw[i] = words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence.load(std::memory_order_relaxed);
+      if (before == after)
+        break;
+    }
+    retries.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ControlState s;
+  memcpy(&s, raw, sizeof(ControlState));
+  return s;
+}
+
+ControlState& controlBeginWrite() {
+  while (writerLock.test_and_set(std::memory_order_acquire)) {
+  }
+  // writeBuffer already mirrors the published state: only writers touch it
+  return writeBuffer;
+}
+
+void controlEndWrite() {
+  uint32_t seq = sequence.load(std::memory_order_relaxed);
+  sequence.store(seq + 1, std::memory_order_relaxed);  // Odd: write in progress
+  std::atomic_thread_fence(std::memory_order_release);
+  publish(writeBuffer);
+  sequence.store(seq + 2, std::memory_order_release);  // Even: published
+  writerLock.clear(std::memory_order_release);
+}
+
+uint32_t controlRetryCount() {
+  return retries.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,210 @@
+#include "DataRate.h"
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "ReliableQueue.h"
+#include "TxScheduler.h"
+
+// Owned by LoRaTask
+static bool adaptive = DATA_RATE_ADAPTIVE;
+static uint8_t current = 0;
+static int pendingSwitch = -1;  // Acked (or fallback), radio not retuned yet
+static bool fallingBack = false;
+static int requested = -1;      // PROTO_REL_OP_RATE in the reliable queue
+static uint8_t tlmSinceRequest = 0;
+static uint32_t retryAfterMs = 0;
+static uint32_t lastTlmMs = 0;
+static uint32_t lastUpdateMs = 0;
+static float marginEwma = 0.0f;
+static bool haveMargin = false;
+static uint16_t upStreak = 0;
+static DataRateStats stats;
+
+void dataRateReset(uint32_t nowMs) {
+  current = 0;
+  pendingSwitch = -1;
+  fallingBack = false;
+  requested = -1;
+  tlmSinceRequest = 0;
+  retryAfterMs = nowMs;
+  lastTlmMs = nowMs;
+  lastUpdateMs = nowMs;
+  haveMargin = false;
+  upStreak = 0;
+  stats = DataRateStats();
+}
+
+void dataRateSetAdaptive(bool on) {
+  adaptive = on;
+}
+
+bool dataRateAdaptive() {
+  return adaptive;
+}
+
+// 📡 Demodulator SNR floor (SX1276 datasheet table 13)
+static float demodFloorDb(uint8_t sf) {
+  return -7.5f - 2.5f * (sf - 7);
+}
+
+float dataRateSensitivityDbm(const ProtoRateProfile& p) {
+  return -174.0f + 10.0f * log10f((float)p.bandwidthHz) + DATA_RATE_NOISE_FIGURE_DB + demodFloorDb(p.sf);
+}
+
+// Sensitivity given away by moving from profile a to b (negative = gained)
+static float switchCostDb(uint8_t a, uint8_t b) {
+  return dataRateSensitivityDbm(proto_rate_profile(b)) - dataRateSensitivityDbm(proto_rate_profile(a));
+}
+
+void dataRateOnTelemetry(int16_t rssi, float snr, int airRssi, uint32_t nowMs) {
+  lastTlmMs = nowMs;
+  stats.samples++;
+
+  // 🔁 Ack of the request: the air retuned right after sending this frame
+  if (requested >= 0) {
+    if (!reliableOpPending(PROTO_REL_OP_RATE)) {
+      pendingSwitch = requested;
+      requested = -1;
+    } else {
+      tlmSinceRequest++;
+    }
+  }
+
+  const ProtoRateProfile p = proto_rate_profile(current);
+  const float sensitivity = dataRateSensitivityDbm(p);
+  float margin = snr - demodFloorDb(p.sf);
+  if (rssi - sensitivity < margin)
+    margin = rssi - sensitivity;
+  if (airRssi < 0 && airRssi - sensitivity < margin)
+    margin = airRssi - sensitivity;
+
+  marginEwma = haveMargin ? marginEwma + DATA_RATE_EWMA_ALPHA * (margin - marginEwma) : margin;
+  haveMargin = true;
+
+  const uint8_t next = current + 1;
+  if (next < proto_rate_profile_count() &&
+      margin - switchCostDb(current, next) >= DATA_RATE_TARGET_MARGIN_DB + DATA_RATE_HYSTERESIS_DB)
+    upStreak++;
+  else
+    upStreak = 0;
+}
+
+static void request(uint8_t profile, uint32_t nowMs) {
+  reliableQueueOp(PROTO_REL_OP_RATE, profile, nowMs);
+  requested = profile;
+  tlmSinceRequest = 0;
+  upStreak = 0;
+  stats.requests++;
+}
+
+void dataRateUpdate(uint32_t nowMs, bool canRequest) {
+  stats.timeOnProfileMs[current] += nowMs - lastUpdateMs;
+  lastUpdateMs = nowMs;
+
+  // 🛟 Nothing from the air for a whole window: meet it on profile 0
+  if (current != 0 && pendingSwitch < 0 && nowMs - lastTlmMs >= PROTO_RATE_FALLBACK_MS) {
+    if (requested >= 0)
+      reliableCancel(PROTO_REL_OP_RATE);
+    requested = -1;
+    pendingSwitch = 0;
+    fallingBack = true;
+    return;
+  }
+
+  if (requested >= 0) {
+    if (tlmSinceRequest >= DATA_RATE_UNACKED_FRAMES) {
+      reliableCancel(PROTO_REL_OP_RATE);  // Heard, never acked: the air doesn't know the op
+      requested = -1;
+      retryAfterMs = nowMs + DATA_RATE_RETRY_MS;
+      stats.unacked++;
+    }
+    return;
+  }
+  if (!adaptive || !canRequest || pendingSwitch >= 0 || !haveMargin || (int32_t)(nowMs - retryAfterMs) < 0)
+    return;
+
+  if (current > 0 && marginEwma < DATA_RATE_TARGET_MARGIN_DB)
+    request(current - 1, nowMs);
+  else if (upStreak >= DATA_RATE_UP_FRAMES)
+    request(current + 1, nowMs);
+}
+
+int dataRatePendingSwitch() {
+  return pendingSwitch;
+}
+
+void dataRateSwitched(uint32_t nowMs) {
+  if (pendingSwitch < 0)
+    return;
+  const uint8_t to = (uint8_t)pendingSwitch;
+  if (fallingBack)
+    stats.fallbacks++;
+  else if (to > current)
+    stats.upSwitches++;
+  else if (to < current)
+    stats.downSwitches++;
+  marginEwma -= switchCostDb(current, to);  // Same link, seen through the new profile
+  if (fallingBack)
+    haveMargin = false;  // Old samples say nothing about why the link went quiet
+  current = to;
+  pendingSwitch = -1;
+  fallingBack = false;
+  upStreak = 0;
+  lastTlmMs = nowMs;  // A full fallback window on the new profile
+}
+
+uint8_t dataRateProfileIndex() {
+  return current;
+}
+
+ProtoRateProfile dataRateProfile() {
+  return proto_rate_profile(current);
+}
+
+float dataRateMarginDb() {
+  return haveMargin ? marginEwma : 0.0f;
+}
+
+uint32_t dataRateAirtimeUs(size_t len, bool implicitHeader) {
+  const ProtoRateProfile p = proto_rate_profile(current);
+  return loraAirtimeUs(len, p.sf, p.bandwidthHz, PROTO_LORA_CR, PROTO_LORA_PREAMBLE, true, implicitHeader);
+}
+
+uint32_t dataRateTlmSlotUs(bool implicitHeader) {
+  const size_t len = implicitHeader ? TLM_IMPLICIT_SIZE : TDMA_TLM_FRAME_SIZE;
+  return TDMA_TURNAROUND_US + dataRateAirtimeUs(len, implicitHeader) + TDMA_GUARD_US;
+}
+
+uint32_t dataRateIntervalMs(uint32_t baseMs) {
+  if (current == 0)
+    return baseMs;
+  const bool implicitHeader = radioImplicitHeader();
+  const size_t frameLen = loraCommandFrameMaxSize();  // 🧺 / 🔁 Longest frame, not the bare command
+  const uint32_t cmdUs = dataRateAirtimeUs(frameLen, implicitHeader);
+  uint32_t ms = (uint32_t)((uint64_t)baseMs * cmdUs / protoAirtimeUs(frameLen, implicitHeader));
+  uint32_t floorMs = (cmdUs + LORA_AIRTIME_BUDGET_PERMILLE - 1) / LORA_AIRTIME_BUDGET_PERMILLE;  // 📒 Same channel share
+#ifdef PROTO_BIDIRECTIONAL
+  // 🗓️ Telemetry slot still fits (ADR runs on reliable frames: the trailer is in frameLen)
+  const uint32_t tdmaMs = (cmdUs + dataRateTlmSlotUs(implicitHeader) + 999) / 1000;
+  if (tdmaMs > floorMs)
+    floorMs = tdmaMs;
+#endif
+  return ms < floorMs ? floorMs : ms;
+}
+
+const DataRateStats& dataRateStats() {
+  return stats;
+}
+
+void dataRatePrintReport() {
+  if (!adaptive)
+    return;
+  const ProtoRateProfile p = proto_rate_profile(current);
+  Serial.printf("📶 Data rate: profile %u/%u (SF%u, %ld kHz), margin %.1f dB | %lu requests, %lu up, %lu down, %lu fallbacks, %lu unacked\n",
+                (unsigned)current, (unsigned)(proto_rate_profile_count() - 1), (unsigned)p.sf, p.bandwidthHz / 1000,
+                dataRateMarginDb(), (unsigned long)stats.requests, (unsigned long)stats.upSwitches,
+                (unsigned long)stats.downSwitches, (unsigned long)stats.fallbacks, (unsigned long)stats.unacked);
+}
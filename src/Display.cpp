@@ -1,4 +1,7 @@
 #include "Display.h"
+#include "Airtime.h"
+#include "Latency.h"
+#include "LinkQuality.h"
 #include "PS5Joystick.h"
 #include "common.h"
 #include "protocol.h"
@@ -24,31 +27,32 @@ void drawFrame1(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int1
   display->setFont(ArialMT_Plain_10);
 
   char buf[24];
+  const ControlState cs = controlSnapshot();  // 🔒 Whole HUD from one controller report
 
   // ── Row 1 (y=10): Control surfaces + Arm/Stop pill ──
-  snprintf(buf, sizeof(buf), "A:%d", sendingAileronMessage);
+  snprintf(buf, sizeof(buf), "A:%d", cs.aileron);
   display->drawString(0 + x, 10 + y, buf);
-  snprintf(buf, sizeof(buf), "E:%d", sendingElevatorsMessage);
+  snprintf(buf, sizeof(buf), "E:%d", cs.elevators);
   display->drawString(34 + x, 10 + y, buf);
-  snprintf(buf, sizeof(buf), "R:%d", sendingRudderMessage);
+  snprintf(buf, sizeof(buf), "R:%d", cs.rudder);
   display->drawString(68 + x, 10 + y, buf);
-  drawPill(display, 98 + x, 10 + y, isEmergencyStopEnabled ? "STOP" : "ARM", true);
+  drawPill(display, 98 + x, 10 + y, cs.emergencyStop ? "STOP" : "ARM", true);
 
   // ── Row 2 (y=21): Engine throttle progress bar + Flaps ──
-  int enginePct = map(sendingEngineMessage, 0, PROTO_ENGINE_RAW_MAX, 0, 100);
+  int enginePct = map(cs.engine, 0, PROTO_ENGINE_RAW_MAX, 0, 100);
   display->drawProgressBar(0 + x, 23 + y, 76, 8, enginePct);
   snprintf(buf, sizeof(buf), "%d%%", enginePct);
   display->drawString(80 + x, 21 + y, buf);
-  snprintf(buf, sizeof(buf), "F%d", sendingFlapsMessage);
+  snprintf(buf, sizeof(buf), "F%d", cs.flaps);
   display->drawString(106 + x, 21 + y, buf);
 
   // ── Row 3 (y=32): Status indicator pills ──
   int16_t px = 0;
-  drawPill(display, px + x, 32 + y, "ABRK", airbrakeEnabled);
+  drawPill(display, px + x, 32 + y, "ABRK", cs.airbrake);
   px += display->getStringWidth("ABRK") + 7;
-  drawPill(display, px + x, 32 + y, "ACS", acsEngageEnabled);
+  drawPill(display, px + x, 32 + y, "ACS", cs.acsEngage);
   px += display->getStringWidth("ACS") + 7;
-  int stabPct = map(stabilityAssistValue, 0, 255, 0, 100);
+  int stabPct = map(cs.stabilityAssist, 0, 255, 0, 100);
   snprintf(buf, sizeof(buf), "SA:%d%%", stabPct);
   display->drawString(px + x, 32 + y, buf);
 
@@ -71,8 +75,8 @@ void drawFrame1(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int1
   }
 
   // ── Row 5 (y=53): Flight timer + telemetry extras ──
-  if (flightTimerRunning && flightTimerStartMs > 0) {
-    unsigned long elapsed = (millis() - flightTimerStartMs) / 1000;
+  if (cs.flightTimerRunning && cs.flightTimerStartMs > 0) {
+    unsigned long elapsed = (millis() - cs.flightTimerStartMs) / 1000;
     char timeBuf[10];
     snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d", (int)(elapsed / 60), (int)(elapsed % 60));
     display->drawString(0 + x, 53 + y, timeBuf);
@@ -94,7 +98,7 @@ void drawFrame1(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int1
   snprintf(uptimeBuf, sizeof(uptimeBuf), "%lu:%02lu", uptimeMinutes, uptimeRemainderSeconds);
 
   // 🌿 ECO mode indicator + uptime — bottom right
-  if (ecoModeEnabled) {
+  if (cs.ecoMode) {
     int16_t ecoWidth = display->getStringWidth("ECO") + 4;
     int16_t ecoX = 128 + x - ecoWidth;
     drawPill(display, ecoX, 53 + y, "ECO", true);
@@ -119,9 +123,16 @@ void drawFrame2(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int1
            (int)(expoAileron * 100), (int)(expoElevator * 100), (int)(expoRudder * 100));
   display->drawString(0 + x, 10 + y, buf);
 
-  // ── Row 2 (y=21): Rate values (A/E/R) ──
-  snprintf(buf, sizeof(buf), "Rate %.1f/%.1f/%.1f",
-           (double)RATE_AILERON, (double)RATE_ELEVATOR, (double)RATE_RUDDER);
+  // ── Row 2 (y=21): Link quality once telemetry flows, else rate values (A/E/R) ──
+  const LinkQuality& link = linkQuality();
+  if (link.down.received) {
+    snprintf(buf, sizeof(buf), "Loss D%d U%d%% B%u J%lums", (int)(link.down.lossEwma * 100.0f + 0.5f),
+             (int)(link.up.lossEwma * 100.0f + 0.5f), (unsigned)link.down.maxBurst,
+             (unsigned long)(link.jitterUs / 1000));
+  } else {
+    snprintf(buf, sizeof(buf), "Rate %.1f/%.1f/%.1f",
+             (double)RATE_AILERON, (double)RATE_ELEVATOR, (double)RATE_RUDDER);
+  }
   display->drawString(0 + x, 21 + y, buf);
 
   // ── Row 3-4 (y=32, y=43): Extended telemetry or radio config ──
@@ -148,27 +159,45 @@ void drawFrame2(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int1
     display->drawString(0 + x, 43 + y, radioBuf);
   }
 
-  // ── Row 5 (y=53): Name ──
+  // ── Row 5 (y=53): Airtime budget left this second + Name ──
+  snprintf(buf, sizeof(buf), "Air:%lu%%", (unsigned long)(airtimeRemainingUs() * 100UL / LORA_AIRTIME_BUDGET_US));
+  display->drawString(0 + x, 53 + y, buf);
   display->setTextAlignment(TEXT_ALIGN_RIGHT);
   display->drawString(128 + x, 53 + y, "Arsalan Iravani");
   display->setTextAlignment(TEXT_ALIGN_LEFT);
 }
 
+// 🖼️ Frame 3: Diagnostics — round trip and control-path latency (ms)
 void drawFrame3(OLEDDisplay* display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
-  // Text alignment demo ⬅️➡️
+  display->setTextAlignment(TEXT_ALIGN_LEFT);
   display->setFont(ArialMT_Plain_10);
 
-  // The coordinates define the left starting point of the text ⬅️
-  display->setTextAlignment(TEXT_ALIGN_LEFT);
-  display->drawString(0 + x, 11 + y, "⬅️ Left aligned (0,10)");
+  // ── Row 1-2 (y=10, y=21): Round trip p50/p99/max, samples, last + air hold ──
+  char buf[32];
+  const LatencyHistogram& rtt = latencyHistogram(LAT_ROUND_TRIP);
+  if (rtt.count) {
+    snprintf(buf, sizeof(buf), "RTT %.1f/%.1f/%.1f", latencyPercentile(LAT_ROUND_TRIP, 50) / 1000.0,
+             latencyPercentile(LAT_ROUND_TRIP, 99) / 1000.0, rtt.maxUs / 1000.0);
+    display->drawString(0 + x, 10 + y, buf);
+    const LinkQuality& link = linkQuality();
+    snprintf(buf, sizeof(buf), "n%lu last %.1f hold %u", (unsigned long)rtt.count, link.lastRttUs / 1000.0,
+             (unsigned)link.lastEchoAgeMs);
+    display->drawString(0 + x, 21 + y, buf);
+  } else {
+    display->drawString(0 + x, 10 + y, "RTT -- (no echo yet)");
+  }
 
-  // The coordinates define the center of the text ↔️
-  display->setTextAlignment(TEXT_ALIGN_CENTER);
-  display->drawString(64 + x, 22 + y, "↔️ Center aligned (64,22)");
+  // ── Row 3-4 (y=32, y=43): One-way control path ──
+  snprintf(buf, sizeof(buf), "Stick>air p99 %.1f", latencyPercentile(LAT_STICK_TO_AIR, 99) / 1000.0);
+  display->drawString(0 + x, 32 + y, buf);
+  snprintf(buf, sizeof(buf), "Estop>air max %.1f", latencyHistogram(LAT_ESTOP_TO_AIR).maxUs / 1000.0);
+  display->drawString(0 + x, 43 + y, buf);
 
-  // The coordinates define the right end of the text ➡️
+  // ── Row 5 (y=53): How to get the full histograms ──
+  display->drawString(0 + x, 53 + y, "Diag ms");
   display->setTextAlignment(TEXT_ALIGN_RIGHT);
-  display->drawString(128 + x, 33 + y, "➡️ Right aligned (128,33)");
+  display->drawString(128 + x, 53 + y, "Serial 'c' = CSV");
+  display->setTextAlignment(TEXT_ALIGN_LEFT);
 }
 
 // Demo for drawStringMaxWidth:
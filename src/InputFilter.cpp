@@ -0,0 +1,44 @@
+#include "InputFilter.h"
+
+#include <stdlib.h>
+
+#include "protocol.h"
+
+// Last output per axis (LoRaTask only)
+static int heldAileron, heldElevators, heldRudder, heldStability, heldEngine;
+static bool haveHeld = false;
+
+void inputFilterReset() {
+  haveHeld = false;
+}
+
+// 🎚️ End snap + hysteresis on a 0..fullScale axis
+static int quantize(int raw, int& held, int fullScale, int band) {
+  int v = raw;
+  if (v <= band)
+    v = 0;
+  else if (v >= fullScale - band)
+    v = fullScale;
+  else if (haveHeld && abs(v - held) <= band)
+    v = held;
+  held = v;
+  return v;
+}
+
+// 🎯 Center snap first: a stick resting near center is exactly center
+static uint8_t quantizeStick(uint8_t raw, int& held) {
+  if (abs(raw - PROTO_JOYSTICK_CENTER) <= INPUT_DEADBAND) {
+    held = PROTO_JOYSTICK_CENTER;
+    return PROTO_JOYSTICK_CENTER;
+  }
+  return (uint8_t)quantize(raw, held, 255, INPUT_HYSTERESIS);
+}
+
+void inputFilterApply(ControlState& cs) {
+  cs.aileron = quantizeStick(cs.aileron, heldAileron);
+  cs.elevators = quantizeStick(cs.elevators, heldElevators);
+  cs.rudder = quantizeStick(cs.rudder, heldRudder);
+  cs.stabilityAssist = (uint8_t)quantize(cs.stabilityAssist, heldStability, 255, INPUT_HYSTERESIS);
+  cs.engine = (uint16_t)quantize(cs.engine, heldEngine, PROTO_ENGINE_RAW_MAX, INPUT_ENGINE_HYSTERESIS);
+  haveHeld = true;
+}
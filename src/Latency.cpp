@@ -0,0 +1,162 @@
+#include "Latency.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include <atomic>
+
+static LatencyHistogram histograms[LAT_STAGE_COUNT];
+
+static const char* const stageNames[LAT_STAGE_COUNT] = {
+    "bt>parse", "parse>event", "event>notify", "notify>build", "build>tx", "stick>air", "estop>air", "cmd>air>gnd",
+};
+
+// 🔗 Trace handoff: notify() (BT task) → constructMessage()/LoRa_sendPacket() (LoRaTask)
+// Single producer / single consumer: the producer only writes the fields while
+// inputPending is false, the consumer only reads them while it is true.
+static uint32_t pendingRxUs = 0;
+static uint32_t pendingNotifyUs = 0;
+static std::atomic<bool> inputPending(false);
+
+// 🚨 Priority-lane trace (same handoff, own slot so stick traces never delay it)
+static uint32_t priorityRxUs = 0;
+static std::atomic<bool> priorityPending(false);
+
+// Owned by LoRaTask
+static bool buildActive = false;
+static uint32_t buildRxUs = 0;
+static uint32_t buildUs = 0;
+
+uint16_t latencyBucketIndex(uint32_t us) {
+  const uint32_t sub = 1u << LAT_SUB_BUCKET_BITS;
+  if (us < sub)
+    return (uint16_t)us;
+
+  uint8_t msb = 31 - __builtin_clz(us);
+  if (msb >= LAT_MAX_EXPONENT)
+    return LAT_BUCKETS - 1;
+
+  uint32_t subIdx = (us >> (msb - LAT_SUB_BUCKET_BITS)) & (sub - 1);
+  return (uint16_t)((msb - LAT_SUB_BUCKET_BITS + 1) * sub + subIdx);
+}
+
+uint32_t latencyBucketUpperUs(uint16_t idx) {
+  const uint32_t sub = 1u << LAT_SUB_BUCKET_BITS;
+  if (idx < sub)
+    return idx;
+
+  uint8_t msb = idx / sub + LAT_SUB_BUCKET_BITS - 1;
+  uint32_t lower = (sub + idx % sub) << (msb - LAT_SUB_BUCKET_BITS);
+  return lower + (1u << (msb - LAT_SUB_BUCKET_BITS)) - 1;
+}
+
+void latencyRecord(LatencyStage stage, uint32_t us) {
+  LatencyHistogram& h = histograms[stage];
+  h.buckets[latencyBucketIndex(us)]++;
+  h.count++;
+  if (us > h.maxUs)
+    h.maxUs = us;
+}
+
+uint32_t latencyPercentile(LatencyStage stage, uint8_t pct) {
+  const LatencyHistogram& h = histograms[stage];
+  if (h.count == 0)
+    return 0;
+
+  uint32_t target = (uint32_t)(((uint64_t)h.count * pct + 99) / 100);
+  if (target == 0)
+    target = 1;
+
+  uint32_t seen = 0;
+  for (uint16_t i = 0; i < LAT_BUCKETS; i++) {
+    seen += h.buckets[i];
+    if (seen >= target) {
+      uint32_t upper = latencyBucketUpperUs(i);
+      return upper < h.maxUs ? upper : h.maxUs;  // Never report above the observed max
+    }
+  }
+  return h.maxUs;
+}
+
+const LatencyHistogram& latencyHistogram(LatencyStage stage) {
+  return histograms[stage];
+}
+
+void latencyReset() {
+  memset(histograms, 0, sizeof(histograms));
+  inputPending.store(false, std::memory_order_release);
+  priorityPending.store(false, std::memory_order_release);
+  buildActive = false;
+}
+
+void latencyMarkInput(uint32_t rxUs, uint32_t parseUs, uint32_t eventUs, uint32_t notifyUs, bool sticksMoved) {
+  latencyRecord(LAT_BT_TO_PARSE, parseUs - rxUs);
+  latencyRecord(LAT_PARSE_TO_EVENT, eventUs - parseUs);
+  latencyRecord(LAT_EVENT_TO_NOTIFY, notifyUs - eventUs);
+
+  // Only stick movements start an end-to-end trace; keep the oldest untransmitted one
+  if (!sticksMoved || inputPending.load(std::memory_order_acquire))
+    return;
+
+  pendingRxUs = rxUs;
+  pendingNotifyUs = notifyUs;
+  inputPending.store(true, std::memory_order_release);
+}
+
+void latencyMarkBuild() {
+  if (buildActive || !inputPending.load(std::memory_order_acquire))
+    return;  // Previous build not on air yet, or nothing new to trace
+
+  uint32_t now = micros();
+  latencyRecord(LAT_NOTIFY_TO_BUILD, now - pendingNotifyUs);
+  buildRxUs = pendingRxUs;
+  buildUs = now;
+  buildActive = true;
+  inputPending.store(false, std::memory_order_release);
+}
+
+void latencyMarkSent() {
+  if (!buildActive)
+    return;
+
+  uint32_t now = micros();
+  latencyRecord(LAT_BUILD_TO_TX, now - buildUs);
+  latencyRecord(LAT_STICK_TO_AIR, now - buildRxUs);
+  buildActive = false;
+}
+
+void latencyMarkPriorityInput(uint32_t rxUs) {
+  if (priorityPending.load(std::memory_order_acquire))
+    return;  // Keep the oldest press until it is on air
+  priorityRxUs = rxUs;
+  priorityPending.store(true, std::memory_order_release);
+}
+
+void latencyMarkPrioritySent() {
+  if (!priorityPending.load(std::memory_order_acquire))
+    return;
+  latencyRecord(LAT_ESTOP_TO_AIR, micros() - priorityRxUs);
+  priorityPending.store(false, std::memory_order_release);
+}
+
+void latencyPrintReport() {
+  Serial.println("⏱️ Latency (µs)      n      p50      p99      max");
+  for (uint8_t s = 0; s < LAT_STAGE_COUNT; s++) {
+    const LatencyHistogram& h = histograms[s];
+    Serial.printf("   %-13s %6lu %8lu %8lu %8lu\n", stageNames[s], (unsigned long)h.count,
+                  (unsigned long)latencyPercentile((LatencyStage)s, 50),
+                  (unsigned long)latencyPercentile((LatencyStage)s, 99), (unsigned long)h.maxUs);
+  }
+}
+
+void latencyPrintCsv() {
+  Serial.println("stage,bucket_upper_us,count");
+  for (uint8_t s = 0; s < LAT_STAGE_COUNT; s++) {
+    const LatencyHistogram& h = histograms[s];
+    for (uint16_t i = 0; i < LAT_BUCKETS; i++) {
+      if (h.buckets[i])
+        Serial.printf("%s,%lu,%lu\n", stageNames[s], (unsigned long)latencyBucketUpperUs(i),
+                      (unsigned long)h.buckets[i]);
+    }
+  }
+}
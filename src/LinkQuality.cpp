@@ -0,0 +1,134 @@
+#include "LinkQuality.h"
+
+#include <Arduino.h>
+
+#include "Latency.h"
+
+// Owned by LoRaTask
+static LinkQuality q;
+static uint8_t upSeq = 0;
+static bool haveSeq = false;
+static uint8_t lastTlmSeq = 0;
+static uint8_t lastEchoSeq = 0;
+static uint32_t lastArrivalUs = 0;
+static bool haveArrival = false;
+
+// ⏱️ Send time of the last LINK_RTT_HISTORY uplink frames, by upSeq
+struct SentStamp {
+  uint32_t us;
+  uint8_t seq;
+  bool valid;
+};
+static SentStamp sentStamps[LINK_RTT_HISTORY];
+
+void linkQualityReset() {
+  q = LinkQuality();
+  upSeq = 0;
+  haveSeq = false;
+  haveArrival = false;
+  for (SentStamp& s : sentStamps)
+    s.valid = false;
+}
+
+uint8_t linkUplinkSeq() {
+  return upSeq;
+}
+
+void linkUplinkSent() {
+  sentStamps[upSeq % LINK_RTT_HISTORY] = {(uint32_t)micros(), upSeq, true};
+  upSeq++;
+}
+
+static void countLost(LinkDirection& d, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    d.lossEwma += LINK_LOSS_EWMA_ALPHA * (1.0f - d.lossEwma);
+    d.burst++;
+  }
+  d.lost += n;
+  if (d.burst > d.maxBurst)
+    d.maxBurst = d.burst;
+}
+
+static void countReceived(LinkDirection& d, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++)
+    d.lossEwma -= LINK_LOSS_EWMA_ALPHA * d.lossEwma;
+  d.received += n;
+  if (n)
+    d.burst = 0;
+}
+
+// ⏱️ One round-trip sample for a newly echoed upSeq
+static void measureRoundTrip(uint32_t arrivalUs, uint8_t echoSeq, uint8_t echoAgeMs) {
+  const SentStamp& s = sentStamps[echoSeq % LINK_RTT_HISTORY];
+  if (!s.valid || s.seq != echoSeq || echoAgeMs == LINK_ECHO_AGE_UNKNOWN)
+    return;  // Too old, never sent by us, or the air can't tell
+  uint32_t heldUs = echoAgeMs * 1000UL;
+  uint32_t elapsedUs = arrivalUs - s.us;
+  if (elapsedUs < heldUs)
+    return;  // Inconsistent echo (seq wrapped / reset on either side)
+  q.lastRttUs = elapsedUs - heldUs;
+  q.lastEchoAgeMs = echoAgeMs;
+  latencyRecord(LAT_ROUND_TRIP, q.lastRttUs);
+}
+
+void linkOnTelemetry(uint32_t arrivalUs, bool sequenced, uint8_t tlmSeq, uint8_t echoSeq, uint8_t echoAgeMs) {
+  uint32_t frames = 1;  // Telemetry intervals this arrival closes
+  q.sequenced = sequenced;
+
+  if (sequenced) {
+    if (haveSeq) {
+      uint8_t g = (uint8_t)(tlmSeq - lastTlmSeq);
+      uint8_t d = (uint8_t)(echoSeq - lastEchoSeq);
+      if (g == 0)
+        return;  // Duplicate frame
+      countLost(q.down, g - 1u);
+      countReceived(q.down, 1);
+      // Uplink: losses first, then the heard frames that end the gap
+      if (d > g)
+        countLost(q.up, d - g);
+      countReceived(q.up, d < g ? d : g);
+      frames = g;
+      if (d)
+        measureRoundTrip(arrivalUs, echoSeq, echoAgeMs);  // Repeated echoes add no new sample
+    } else {
+      countReceived(q.down, 1);
+      measureRoundTrip(arrivalUs, echoSeq, echoAgeMs);
+    }
+    haveSeq = true;
+    lastTlmSeq = tlmSeq;
+    lastEchoSeq = echoSeq;
+  } else {
+    countReceived(q.down, 1);
+  }
+
+  // ⏱️ Per-frame inter-arrival (a gap of g frames counts as g intervals)
+  if (haveArrival) {
+    uint32_t interval = (arrivalUs - lastArrivalUs) / frames;
+    if (!q.meanIntervalUs)
+      q.meanIntervalUs = interval;
+    int32_t dev = (int32_t)(interval - q.meanIntervalUs);
+    q.meanIntervalUs += dev / 16;
+    int32_t absDev = dev < 0 ? -dev : dev;
+    q.jitterUs = (uint32_t)((int32_t)q.jitterUs + (absDev - (int32_t)q.jitterUs) / 16);
+  }
+  lastArrivalUs = arrivalUs;
+  haveArrival = true;
+}
+
+const LinkQuality& linkQuality() {
+  return q;
+}
+
+void linkQualityPrintReport() {
+  const LinkQuality& l = q;
+  if (!l.down.received)
+    return;
+  Serial.printf("📶 Link down: %lu rx / %lu lost (%.1f%%, burst max %u) | up: %lu / %lu lost (%.1f%%, burst max %u)%s | jitter %lu us (interval %lu us)\n",
+                (unsigned long)l.down.received, (unsigned long)l.down.lost, l.down.lossEwma * 100.0f,
+                (unsigned)l.down.maxBurst, (unsigned long)l.up.received, (unsigned long)l.up.lost,
+                l.up.lossEwma * 100.0f, (unsigned)l.up.maxBurst, l.sequenced ? "" : " (no seq trailer)",
+                (unsigned long)l.jitterUs, (unsigned long)l.meanIntervalUs);
+  if (l.lastRttUs)
+    Serial.printf("   RTT last %lu us (air hold %u ms)\n", (unsigned long)l.lastRttUs,
+                  (unsigned)l.lastEchoAgeMs);
+}
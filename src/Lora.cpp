@@ -1,29 +1,38 @@
 #include <LoRa.h>
 #include <SPI.h>
+#include <esp_timer.h>
 #include <math.h>
+
+#include <atomic>
+
+#include "Airtime.h"
+#include "DataRate.h"
+#include "InputFilter.h"
+#include "Latency.h"
+#include "LinkQuality.h"
+#include "RadioState.h"
+#include "RateControl.h"
+#include "ReliableQueue.h"
+#include "SX1276.h"
+#include "TelemetryRing.h"
+#include "TxPower.h"
+#include "TxScheduler.h"
 #include "common.h"
 #include "protocol.h"
+#include "protocol_aggregate.h"
+#include "protocol_delta.h"
+#include "protocol_fec.h"
+#include "protocol_heartbeat.h"
+#include "protocol_implicit.h"
+#include "protocol_trim.h"
 
 bool lora_initialized = false;  // 📡 Track init status
-bool ecoModeEnabled = true;     // 🌿 ECO mode: suppress duplicate packets (default ON)
-
-// 📡 LoRa Communication Variables
-int sendingEngineMessage = 1;
-byte sendingAileronMessage = 127;    // ↔️ Aileron control
-byte sendingRudderMessage = 127;     // ↔️ Rudder control
-byte sendingElevatorsMessage = 127;  // ↕️ Elevator control
-int sendingElevatorTrimMessage = 0;
-int sendingAileronTrimMessage = 0;
-int sendingFlapsMessage = 0;  // 🪶 Flaps: 0, 1, 2, 3, 4
-bool resetAileronTrim = false;
-bool resetElevatorTrim = false;
-bool airbrakeEnabled = false;  // 🛑 Airbrake status
-bool acsEngageEnabled = false; // 🤖 ACS autopilot engage
-uint8_t stabilityAssistValue = 0; // 🛡️ Stability assist L2 analog
-
-// ⏱️ Flight timer
-unsigned long flightTimerStartMs = 0;
-bool flightTimerRunning = false;
+
+// 🔄 Discrete state already put on air (compared against ControlState)
+static int8_t sentElevatorTrim = 0;  // Trim the air holds after our one-shot steps
+static int8_t sentAileronTrim = 0;
+static uint8_t sentResetAileronCount = 0;
+static uint8_t sentResetElevatorCount = 0;
 
 // 🟥 Expo presets — cycled via Square button
 // Columns: {aileron, elevator, rudder}
@@ -55,6 +64,8 @@ float tlm_temperature = 0.0f;
 float tlm_verticalSpeed = 0.0f;
 bool tlm_valid = false;
 unsigned long tlm_lastReceived = 0;
+int tlm_linkRssi = 0;       // 📶 Ground-side RSSI of the last telemetry frame
+float tlm_linkSnr = 0.0f;   // 📶 Ground-side SNR of the last telemetry frame
 #endif
 
 // � Binary command packet buffer (10 bytes — was 48 byte ASCII buffer)
@@ -79,30 +90,579 @@ static uint8_t applyExpoRate(byte rawJoystick, float expo, float rate) {
   float servo = 90.0f + curved * 90.0f;
   return (uint8_t)constrain((int)roundf(servo), 0, 180);
 }
-void LoRa_sendPacket(const uint8_t* data, size_t len) {
-  if (!lora_initialized)
-    return;  // ⚠️ Skip if LoRa not initialized
+// ⏰ Event-driven scheduling: timer / ISR post bits here and wake LoRaTask
+static std::atomic<uint32_t> pendingEvents(0);
+static TaskHandle_t schedulerTask = NULL;
+static volatile bool schedulerStarted = false;
+static esp_timer_handle_t txTimer = NULL;
+
+// 📊 Current stats window (LoRaTask only) and the last completed one
+static TxSchedulerStats schedWindow;
+static TxSchedulerStats schedLast;
+static unsigned long schedWindowStartMs = 0;
+static uint32_t lastSlotUs = 0;
+static uint32_t slotPeriodUs = (uint32_t)PROTO_CMD_INTERVAL_MS * 1000UL;  // 🌿 Current TX timer period
+static uint64_t jitterSumUs = 0;
+static uint32_t jitterSamples = 0;
+
+static void onTxTimer(void* arg) {
+  pendingEvents.fetch_or(LORA_EVT_TX_TICK);
+  xTaskNotifyGive(schedulerTask);
+}
+
+// 🧺 Multi-sample frames (protocol_aggregate.h) — off (1) until the flight board decodes them
+#ifndef CMD_AGGREGATE_SAMPLES
+#define CMD_AGGREGATE_SAMPLES 1  // Stick samples per command frame, newest included
+#endif
+static_assert(CMD_AGGREGATE_SAMPLES >= 1 && CMD_AGGREGATE_SAMPLES <= PROTO_AGG_MAX_SAMPLES, "1..PROTO_AGG_MAX_SAMPLES");
+
+struct StickSample {
+  uint32_t atUs;
+  ProtoAggSample axes;  // ageMs filled in when the frame is built
+};
+
+static uint8_t aggSamples = CMD_AGGREGATE_SAMPLES;
+static StickSample stickSamples[PROTO_AGG_MAX_SAMPLES];  // Ring, newest at stickHead − 1 (+ the tick's own)
+static uint8_t stickHead = 0;
+static uint8_t stickCount = 0;
+static uint32_t lastAggFrameUs = 0;  // Samples up to here went out already
+static esp_timer_handle_t sampleTimer = NULL;
+
+static void onSampleTimer(void* arg) {
+  pendingEvents.fetch_or(LORA_EVT_SAMPLE);
+  xTaskNotifyGive(schedulerTask);
+}
+
+// 🧺 Sample timer runs aggSamples× the TX tick, in phase with it
+static void armSampleTimer() {
+  if (!schedulerStarted)
+    return;
+  if (!sampleTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = onSampleTimer;
+    args.name = "lora_sample";
+    args.dispatch_method = ESP_TIMER_TASK;
+    esp_timer_create(&args, &sampleTimer);
+  }
+  esp_timer_stop(sampleTimer);
+  if (aggSamples > 1)
+    esp_timer_start_periodic(sampleTimer, slotPeriodUs / aggSamples);
+}
+
+// 🧺 Build-time default, switchable at run time (channel simulator, diagnostics)
+void commandAggregateSetSamples(uint8_t n) {
+  aggSamples = n < 1 ? 1 : (n > PROTO_AGG_MAX_SAMPLES ? PROTO_AGG_MAX_SAMPLES : n);
+  armSampleTimer();
+}
+
+#ifdef PROTO_BIDIRECTIONAL
+static esp_timer_handle_t slotTimer = NULL;  // 🗓️ Telemetry slot end
+
+static void onSlotTimer(void* arg) {
+  pendingEvents.fetch_or(LORA_EVT_SLOT_END);
+  xTaskNotifyGive(schedulerTask);
+}
+#endif
+
+// ⚡ DIO0 ISR context. Before LoRaTask exists (setupRadio's init packet) the bit
+// just waits for its first wakeup.
+static void IRAM_ATTR notifyFromIsr(uint32_t event) {
+  BaseType_t woken = pdFALSE;
+  pendingEvents.fetch_or(event);
+  if (schedulerStarted) {
+    vTaskNotifyGiveFromISR(schedulerTask, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+static void IRAM_ATTR onTxDone() {
+  notifyFromIsr(LORA_EVT_TX_DONE);
+}
+
+#ifdef PROTO_BIDIRECTIONAL
+static volatile int rxPendingSize = 0;
+static volatile uint32_t rxDoneUs = 0;
+static uint32_t rxOverruns = 0;  // 📊 RX-done before the previous frame was drained
+static TlmRxEntry* rxDrainEntry = nullptr;  // ⚡ Reserved, FIFO read still queued
+
+static void IRAM_ATTR onRxDone(int packetSize) {  // No FIFO reads here
+  rxPendingSize = packetSize;
+  rxDoneUs = micros();
+  if (pendingEvents.load() & LORA_EVT_RX_DONE)
+    rxOverruns++;
+  notifyFromIsr(LORA_EVT_RX_DONE);
+}
+
+static void IRAM_ATTR onSpiDone(uint8_t op) {
+  if (op == SX1276_OP_RX_READ)
+    notifyFromIsr(LORA_EVT_SPI_DONE);
+}
+#endif
+
+// 👂 CAD done (RADIO_LBT): preamble seen or not
+static volatile bool cadDetected = false;
+
+static void IRAM_ATTR onCadDone(bool detected) {
+  cadDetected = detected;
+  notifyFromIsr(LORA_EVT_CAD_DONE);
+}
+
+// ⚡ RADIO_SPI_DMA: the driver owns DIO0 — LoRaTask reads which IRQ it was
+static volatile uint32_t dio0Us = 0;
+
+static void IRAM_ATTR onDio0() {
+  dio0Us = micros();
+  notifyFromIsr(LORA_EVT_DIO0);
+}
+
+// 📡 Radio state machine (LoRaTask only, plus setupRadio() before it starts)
+static RadioState radio = RadioState::IDLE;
+static RadioStats radioCounters;
+static unsigned long txStartMs = 0;
+static bool txPending = false;  // Command slot deferred behind an in-flight TX
+static uint8_t priorityFramesLeft = 0;  // 🚨 Priority-lane repeats still to send
+static bool implicitHeader = CMD_IMPLICIT_HEADER;  // 📏 Fixed-size frames, no LoRa header
+static bool directSpi = RADIO_DIRECT_SPI || RADIO_SPI_DMA;  // 🔌 SX1276.h instead of the library's register path
+static bool spiDma = RADIO_SPI_DMA;                          // ⚡ ... on the spi_master DMA queue
+static bool lbtEnabled = RADIO_LBT;  // 👂 CAD before each uplink frame
+#ifdef PROTO_BIDIRECTIONAL
+static bool tlmSlotOpen = false;  // 🗓️ Air side owns the channel
+static uint32_t tlmSlotEndUs = 0;
+#endif
+
+void resetCommandEncoder();
+static void lbtReset();
+
+void radioInit() {
+  radio = RadioState::IDLE;
+  radioCounters = RadioStats();
+  txPending = false;
+  priorityFramesLeft = 0;
+#ifdef PROTO_BIDIRECTIONAL
+  tlmSlotOpen = false;
+#endif
+  pendingEvents.store(0);
+  resetCommandEncoder();  // 🔑 First frame after (re)init is a keyframe
+  stickCount = 0;
+  linkQualityReset();
+  inputFilterReset();
+  reliableReset();
+  lbtReset();
+  dataRateReset(millis());  // 📶 setupRadio() tunes profile 0 (protocol.h)
+  txPowerReset();           // 🔋 ...at PROTO_LORA_TX_POWER
+  airtimeReset();           // 📒 Nothing on air yet
+
+  if (spiDma) {
+    LoRa.onTxDone(NULL);  // ⚡ The library's ISR would read the flags over Arduino SPI
+    LoRa.onReceive(NULL);
+    LoRa.onCadDone(NULL);
+    sx1276AttachDio0(LORA_DIO0, onDio0);
+  } else {
+    LoRa.onTxDone(onTxDone);  // 📡 DIO0 → TX done (armed by endPacket(true))
+    LoRa.onCadDone(onCadDone);  // 👂 DIO0 → CAD done (armed by channelActivityDetection())
+#ifdef PROTO_BIDIRECTIONAL
+    LoRa.onReceive(onRxDone);  // 📡 DIO0 → RX done (armed by receive())
+#endif
+  }
+#ifdef PROTO_BIDIRECTIONAL
+  sx1276OnSpiDone(onSpiDone);
+  tlmRingReset();
+  rxDrainEntry = nullptr;
+  rxOverruns = 0;
+#endif
+}
+
+RadioState radioState() {
+  return radio;
+}
+
+const RadioStats& radioStats() {
+  return radioCounters;
+}
+
+void radioSetImplicitHeader(bool on) {
+  implicitHeader = on;
+}
+
+bool radioImplicitHeader() {
+  return implicitHeader;
+}
+
+void radioSetDirectSpi(bool on) {
+  directSpi = on;
+  spiDma = spiDma && on;
+}
+
+bool radioDirectSpi() {
+  return directSpi;
+}
+
+void radioSetListenBeforeTalk(bool on) {
+  lbtEnabled = on;
+}
+
+bool radioListenBeforeTalk() {
+  return lbtEnabled;
+}
+
+void radioSetSpiDma(bool on) {
+  spiDma = on;
+  directSpi = directSpi || on;
+}
+
+bool radioSpiDma() {
+  return spiDma;
+}
+
+const char* radioStateName(RadioState s) {
+  switch (s) {
+    case RadioState::TX:        return "TX";
+    case RadioState::RX_WINDOW: return "RX";
+    case RadioState::LBT:       return "LBT";
+    default:                    return "IDLE";
+  }
+}
+
+// 🚨 TX done lost (DIO0 glitch) — don't stay deaf forever
+static bool radioTxBusy() {
+  if (radio == RadioState::LBT)
+    return true;  // 👂 Held frame goes first (its deadline or a priority burst ends the hold)
+  if (radio != RadioState::TX)
+    return false;
+  if (millis() - txStartMs < RADIO_TX_TIMEOUT_MS)
+    return true;
+  radioCounters.txTimeouts++;
+  radio = RadioState::IDLE;
+  return false;
+}
 
+static void radioOnTxDone() {
+  if (radio != RadioState::TX) {
+    radioCounters.spuriousTxDone++;
+    return;
+  }
+  radioCounters.txCompleted++;
+  radio = RadioState::IDLE;
+
+#ifdef PROTO_BIDIRECTIONAL
+  // 🗓️ Our command is off the air: the telemetry slot starts now
+  tlmSlotOpen = true;
+  tlmSlotEndUs = micros() + dataRateTlmSlotUs(implicitHeader);  // 📶 On the current data-rate profile
+  txPowerOnUplink();  // 🔋 Counts toward a loss burst until telemetry answers
+#endif
+}
+
+// 🗓️ True while the air side may be transmitting telemetry
+static bool tdmaSlotReserved() {
+#ifdef PROTO_BIDIRECTIONAL
+  if (tlmSlotOpen && (int32_t)(tlmSlotEndUs - micros()) <= 0)
+    tlmSlotOpen = false;
+  return tlmSlotOpen;
+#else
+  return false;
+#endif
+}
+
+// ⏰ Wake LoRaTask when the slot closes — armed only if a command is waiting on it
+static void tdmaWakeAtSlotEnd() {
+#ifdef PROTO_BIDIRECTIONAL
+  if (!slotTimer)
+    return;
+  esp_timer_stop(slotTimer);
+  esp_timer_start_once(slotTimer, (uint32_t)(tlmSlotEndUs - micros()));
+#endif
+}
+
+// 📥 Listen for telemetry until the next command slot
+static void radioOpenRxWindow() {
+#ifdef PROTO_BIDIRECTIONAL
+  if (directSpi)
+    sx1276Receive(implicitHeader ? TLM_IMPLICIT_SIZE : 0);
+  else
+    LoRa.receive(implicitHeader ? TLM_IMPLICIT_SIZE : 0);  // 📏 Size > 0 = implicit header
+  radio = RadioState::RX_WINDOW;
+#endif
+}
+
+// 📡 Frame on air now (LoRa_sendPacket() checks done)
+static void radioTransmit(const uint8_t* data, size_t len) {
   digitalWrite(BUILTIN_LED, 1);  // 💡 Turn on LED during transmission
 
-  LoRa.beginPacket();
-  LoRa.write(data, len);
-  LoRa.endPacket(true);  // 📡 Async mode - non-blocking TX
+  if (directSpi) {
+    uint8_t upSeq = linkUplinkSeq();  // 📶 Uplink sequence trailer, same FIFO burst
+    sx1276Transmit(data, len, &upSeq, LINK_SEQ_TRAILER ? LINK_UP_TRAILER_SIZE : 0, implicitHeader);
+    if (LINK_SEQ_TRAILER)
+      len += LINK_UP_TRAILER_SIZE;
+  } else {
+    LoRa.beginPacket(implicitHeader);
+    LoRa.write(data, len);
+    if (LINK_SEQ_TRAILER) {
+      LoRa.write(linkUplinkSeq());  // 📶 Uplink sequence trailer
+      len += LINK_UP_TRAILER_SIZE;
+    }
+    LoRa.endPacket(true);  // 📡 Async mode - non-blocking TX
+  }
+  linkUplinkSent();
+  latencyMarkSent();     // ⏱️ Close the stick-to-air trace
+
+  radio = RadioState::TX;
+  txStartMs = millis();
+  radioCounters.txStarted++;
+  airtimeRecord(dataRateAirtimeUs(len, implicitHeader));  // 📒 Airtime ledger
 
   digitalWrite(BUILTIN_LED, 0);  // 💡 Turn off LED after transmission
   // No delay needed - async TX handles packet separation
 }
 
-boolean runEvery(unsigned long interval) {
-  static unsigned long previousMillis = 0;
-  unsigned long currentMillis = millis();
+// 👂 Listen before talk (LoRaTask only). CAD lasts ~2 symbols: another look
+// is only taken while it still ends before the held frame's deadline.
+#define LBT_CAD_US (2UL * (1UL << PROTO_LORA_SF) * 1000000UL / PROTO_LORA_BANDWIDTH_HZ + 100)
 
-  if (currentMillis - previousMillis >= interval) {
-    previousMillis = currentMillis;
-    return true;  // ⏰ Time to execute
+static uint8_t lbtFrame[255];
+static size_t lbtLen = 0;
+static uint32_t lbtSinceUs = 0;   // Handed to LoRa_sendPacket()
+static uint32_t lbtWindowUs = 0;  // Backoff window, doubles per busy CAD
+static bool lbtWasBusy = false;
+static esp_timer_handle_t lbtTimer = NULL;
+
+static void onLbtTimer(void* arg) {
+  pendingEvents.fetch_or(LORA_EVT_LBT);
+  if (schedulerStarted)
+    xTaskNotifyGive(schedulerTask);
+}
+
+static void lbtArm(uint32_t us) {
+  if (!lbtTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = onLbtTimer;
+    args.name = "lora_lbt";
+    args.dispatch_method = ESP_TIMER_TASK;
+    esp_timer_create(&args, &lbtTimer);
   }
+  esp_timer_stop(lbtTimer);
+  esp_timer_start_once(lbtTimer, us);
+}
+
+static void lbtReset() {
+  if (lbtTimer)
+    esp_timer_stop(lbtTimer);
+  lbtLen = 0;
+}
+
+static uint32_t lbtRemainingUs() {
+  uint32_t heldUs = micros() - lbtSinceUs;
+  return heldUs >= LBT_MAX_DELAY_US ? 0 : LBT_MAX_DELAY_US - heldUs;
+}
+
+static void lbtStartCad() {
+  radioCounters.cadRuns++;
+  if (directSpi)
+    sx1276StartCad();
+  else
+    LoRa.channelActivityDetection();
+  lbtArm(lbtRemainingUs());  // Deadline stands even if CAD done never arrives
+}
+
+static void lbtRelease(bool forced) {
+  esp_timer_stop(lbtTimer);
+  uint32_t heldUs = micros() - lbtSinceUs;
+  if (heldUs > radioCounters.lbtDelayMaxUs)
+    radioCounters.lbtDelayMaxUs = heldUs;
+  if (forced)
+    radioCounters.lbtForced++;
+  radioTransmit(lbtFrame, lbtLen);
+  lbtLen = 0;
+}
 
-  return false;  // ⏳ Wait more
+static void lbtHold(const uint8_t* data, size_t len) {
+  memcpy(lbtFrame, data, len);
+  lbtLen = len;
+  lbtSinceUs = micros();
+  lbtWindowUs = LBT_BACKOFF_MIN_US;
+  lbtWasBusy = false;
+  radio = RadioState::LBT;
+  lbtStartCad();
+}
+
+static void lbtOnCadDone() {
+  if (radio != RadioState::LBT)
+    return;  // Hold already ended at its deadline
+  if (!cadDetected) {
+    lbtRelease(false);
+    return;
+  }
+  radioCounters.cadBusy++;
+  if (!lbtWasBusy) {
+    lbtWasBusy = true;
+    radioCounters.lbtHeld++;
+  }
+  uint32_t left = lbtRemainingUs();
+  if (left < LBT_CAD_US) {
+    lbtRelease(true);  // ⏰ No time for another look
+    return;
+  }
+  uint32_t backoff = (uint32_t)random(LBT_BACKOFF_MIN_US, lbtWindowUs + 1);
+  lbtWindowUs = lbtWindowUs * 2 > LBT_BACKOFF_MAX_US ? LBT_BACKOFF_MAX_US : lbtWindowUs * 2;
+  lbtArm(backoff < left - LBT_CAD_US ? backoff : left - LBT_CAD_US);
+}
+
+static void lbtOnTimer() {
+  if (radio != RadioState::LBT)
+    return;
+  if (lbtRemainingUs() < LBT_CAD_US)
+    lbtRelease(true);  // ⏰ Deadline: out it goes
+  else
+    lbtStartCad();
+}
+
+static bool radioSend(const uint8_t* data, size_t len, bool listenFirst) {
+  if (!lora_initialized)
+    return false;  // ⚠️ Skip if LoRa not initialized
+  if (implicitHeader && len != PROTO_CMD_PACKET_SIZE) {
+    radioCounters.implicitRejected++;  // 📏 The air side would read it with the wrong length
+    return false;
+  }
+  if (radioTxBusy())
+    return false;  // 🚫 Never abort the frame on air
+  if (radio == RadioState::RX_WINDOW)
+    radioCounters.rxPreempted++;
+
+  if (listenFirst && len <= sizeof(lbtFrame))
+    lbtHold(data, len);  // 👂 On air once the channel is clear, by LBT_MAX_DELAY_US at the latest
+  else
+    radioTransmit(data, len);
+  return true;
+}
+
+bool LoRa_sendPacket(const uint8_t* data, size_t len) {
+  return radioSend(data, len, lbtEnabled);
+}
+
+void loraStartScheduler(TaskHandle_t task) {
+  schedulerTask = task;
+  schedulerStarted = true;
+
+  if (!txTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = onTxTimer;
+    args.name = "lora_tx";
+    args.dispatch_method = ESP_TIMER_TASK;
+    esp_timer_create(&args, &txTimer);
+  }
+  esp_timer_stop(txTimer);  // Re-phase if already running
+  slotPeriodUs = (uint32_t)PROTO_CMD_INTERVAL_MS * 1000UL;
+  esp_timer_start_periodic(txTimer, slotPeriodUs);
+  armSampleTimer();
+  rateControlReset(millis());
+
+#ifdef PROTO_BIDIRECTIONAL
+  if (!slotTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = onSlotTimer;
+    args.name = "lora_slot";
+    args.dispatch_method = ESP_TIMER_TASK;
+    esp_timer_create(&args, &slotTimer);
+  }
+  const uint32_t tdmaFrameUs = tdmaCmdSlotUs(loraCommandFrameMaxSize(), implicitHeader) + tdmaTlmSlotUs(implicitHeader);
+  if (tdmaFrameUs > PROTO_CMD_INTERVAL_MS * 1000UL)  // Commands still flow, just slower than PROTO_CMD_INTERVAL_MS
+    Serial.printf("⚠️ TDMA frame %u us > command interval %u ms\n", (unsigned)tdmaFrameUs,
+                  (unsigned)PROTO_CMD_INTERVAL_MS);
+#endif
+
+  schedWindow = TxSchedulerStats();
+  schedLast = TxSchedulerStats();
+  schedWindowStartMs = millis();
+  lastSlotUs = 0;
+  jitterSumUs = 0;
+  jitterSamples = 0;
+}
+
+// 🚨 BT task: the published ControlState holds a new e-stop / disarm
+void loraRequestPriority() {
+  pendingEvents.fetch_or(LORA_EVT_PRIORITY);
+  if (schedulerStarted)
+    xTaskNotifyGive(schedulerTask);
+}
+
+// ⏱️ Slot-to-slot interval vs the period the TX timer was armed with
+static void markSlot(uint32_t nowUs) {
+  const uint32_t nominalUs = slotPeriodUs;
+  uint32_t interval = nowUs - lastSlotUs;
+  if (lastSlotUs && interval < 2 * nominalUs) {  // Skip gaps (disconnects, first slot)
+    uint32_t dev = interval > nominalUs ? interval - nominalUs : nominalUs - interval;
+    jitterSumUs += dev;
+    jitterSamples++;
+    if (dev > schedWindow.jitterMaxUs)
+      schedWindow.jitterMaxUs = dev;
+  }
+  lastSlotUs = nowUs;
+  schedWindow.slots++;
+}
+
+// 📊 Close the stats window once per TX_SCHED_WINDOW_MS
+static void rollSchedulerWindow() {
+  unsigned long elapsed = millis() - schedWindowStartMs;
+  if (elapsed < TX_SCHED_WINDOW_MS)
+    return;
+  schedWindow.windowMs = (uint32_t)elapsed;
+  schedWindow.jitterMeanUs = jitterSamples ? (uint32_t)(jitterSumUs / jitterSamples) : 0;
+  schedLast = schedWindow;
+  schedWindow = TxSchedulerStats();
+  schedWindowStartMs = millis();
+  jitterSumUs = 0;
+  jitterSamples = 0;
+}
+
+// 🌿 Adaptive command rate: re-arm the TX timer when the controller picks a new period
+static void retimeCommandSlot() {
+  // 📶 Periods are sized for profile 0; a faster data rate fits more commands in the same share
+  uint32_t periodUs = dataRateIntervalMs(rateControlUpdate(controlSnapshot(), millis(), airtimeRemainingUs())) * 1000UL;
+  if (periodUs == slotPeriodUs)
+    return;
+  slotPeriodUs = periodUs;
+  esp_timer_stop(txTimer);
+  esp_timer_start_periodic(txTimer, periodUs);
+  armSampleTimer();  // 🧺 Keep sampling in step with the new period
+}
+
+const TxSchedulerStats& txSchedulerStats() {
+  return schedLast;
+}
+
+void txSchedulerPrintReport() {
+  const TxSchedulerStats s = schedLast;  // Diagnostics only: fields are word-sized
+  if (!s.windowMs)
+    return;
+  Serial.printf("⏰ LoRaTask: %u wakeups, %u slots, %u TX-done, %u RX-done in %u ms | CPU %.2f%% | jitter mean %u us max %u us\n",
+                (unsigned)s.wakeups, (unsigned)s.slots, (unsigned)s.txDone, (unsigned)s.rxDone, (unsigned)s.windowMs,
+                s.busyUs * 100.0f / (s.windowMs * 1000.0f), (unsigned)s.jitterMeanUs, (unsigned)s.jitterMaxUs);
+  Serial.printf("📒 Airtime: %lu us/s used of %lu us/s budget (cmd frame %lu us)\n", (unsigned long)airtimeUsedUs(),
+                (unsigned long)LORA_AIRTIME_BUDGET_US, (unsigned long)LORA_CMD_AIRTIME_US);
+  Serial.printf("🌿 Rate: %lu ms period (floor %lu ms), stick activity %lu/s\n", (unsigned long)rateControlIntervalMs(),
+                (unsigned long)rateControlFloorMs(), (unsigned long)rateControlActivity());
+  const RadioStats& r = radioCounters;
+  Serial.printf("📡 Radio %s: TX %u/%u done, %u deferred (%u by TLM slot, %u merged), %u timeouts, %u priority, %u heartbeats, %u parity, %u implicit rejects, %u extra samples | RX preempted %u, outside window %u | spurious TX done %u\n",
+                radioStateName(radio), (unsigned)r.txCompleted, (unsigned)r.txStarted, (unsigned)r.txDeferred,
+                (unsigned)r.slotDeferred, (unsigned)r.txMerged, (unsigned)r.txTimeouts, (unsigned)r.priorityTx, (unsigned)r.heartbeats,
+                (unsigned)r.parityTx, (unsigned)r.implicitRejected, (unsigned)r.aggSamples, (unsigned)r.rxPreempted,
+                (unsigned)r.rxOutsideWindow, (unsigned)r.spuriousTxDone);
+  if (lbtEnabled) {
+    Serial.printf("👂 LBT: %u CAD, %u busy (%.1f%%), %u frames held, %u sent at deadline, %u cut short, longest hold %u us\n",
+                  (unsigned)r.cadRuns, (unsigned)r.cadBusy, r.cadRuns ? r.cadBusy * 100.0f / r.cadRuns : 0.0f,
+                  (unsigned)r.lbtHeld, (unsigned)r.lbtForced, (unsigned)r.lbtCutShort, (unsigned)r.lbtDelayMaxUs);
+  }
+  if (directSpi) {
+    const Sx1276Stats& spi = sx1276Stats();
+    Serial.printf("🔌 SPI: %lu transactions, %lu bytes, %lu FIFO bursts, %lu writes skipped (cached) | %lu queued "
+                  "(%lu bytes by DMA), %lu us blocked\n",
+                  (unsigned long)spi.transactions, (unsigned long)spi.bytes, (unsigned long)spi.fifoBursts,
+                  (unsigned long)spi.writesSkipped, (unsigned long)spi.queued, (unsigned long)spi.queuedBytes,
+                  (unsigned long)spi.blockedUs);
+  }
+#ifdef PROTO_BIDIRECTIONAL
+  if (rxOverruns || tlmRingDropped())
+    Serial.printf("⚠️ TLM RX: %u overruns, %u ring drops\n", (unsigned)rxOverruns, (unsigned)tlmRingDropped());
+#endif
 }
 
 uint32_t previousHash = 0;
@@ -118,36 +678,172 @@ static uint32_t fnv1a_hash(const uint8_t* data, size_t len) {
   return hash;
 }
 
-// 📦 Build binary command packet (10 bytes, zero heap allocation)
-void constructMessage() {
+// ⚖️ Absolute trim (protocol_trim.h) — off until the flight board reads it
+#ifndef CMD_ABSOLUTE_TRIM
+#define CMD_ABSOLUTE_TRIM 0
+#endif
+static_assert(!(PROTO_FLAG_ABS_TRIM & (PROTO_FLAG_RESET_AIL | PROTO_FLAG_RESET_ELEV | PROTO_FLAG_AIRBRAKE | PROTO_FLAG_ACS)),
+              "absolute trim flag must be unique");
+
+static bool absoluteTrim = CMD_ABSOLUTE_TRIM;
+
+// ⚖️ Build-time default, switchable at run time (replay benchmark, diagnostics)
+void commandSetAbsoluteTrim(bool on) {
+  absoluteTrim = on;
+}
+
+// 🔁 Reliable discrete commands (protocol_reliable.h) — off until the flight board acks them
+#ifndef CMD_RELIABLE
+#define CMD_RELIABLE 0
+#endif
+#if CMD_RELIABLE && !defined(PROTO_BIDIRECTIONAL)
+#error "CMD_RELIABLE needs PROTO_BIDIRECTIONAL (acks ride in telemetry)"
+#endif
+#if DATA_RATE_ADAPTIVE && !CMD_RELIABLE
+#error "DATA_RATE_ADAPTIVE needs CMD_RELIABLE (the switch handshake is a reliable op)"
+#endif
+
+static bool reliableCommands = CMD_RELIABLE;
+
+// 🔁 Build-time default, switchable at run time (channel simulator, diagnostics)
+void commandSetReliable(bool on) {
+  reliableCommands = on;
+  reliableReset();
+}
+
+// ⚖️ One trim step (±1) per packet toward the ground offset; a pending reset
+// zeroes the air's trim first, so the steps count from neutral
+static int8_t pendingTrimStep(int8_t trim, int8_t sent, bool reset) {
+  int base = reset ? 0 : sent;
+  return trim > base ? 1 : (trim < base ? -1 : 0);
+}
+
+// 🎮 Stick axes as they go on air (engine map, expo / rate) — commands and 🧺 samples
+static void shapeAxes(const ControlState& cs, ProtoAggSample& out) {
+  out.engine = cs.emergencyStop ? 0 : (uint8_t)map(cs.engine, PROTO_ENGINE_RAW_MIN, PROTO_ENGINE_RAW_MAX, PROTO_ENGINE_MIN, PROTO_ENGINE_MAX);
+  out.ailerons = applyExpoRate(cs.aileron, expoAileron, RATE_AILERON);
+  out.rudder = applyExpoRate(cs.rudder, expoRudder, RATE_RUDDER);
+  out.elevators = applyExpoRate(cs.elevators, expoElevator, RATE_ELEVATOR);
+}
+
+// 📦 Build binary command packet from one ControlState snapshot (zero heap allocation)
+const ProtoCmdPacket& constructMessage(const ControlState& cs) {
+  latencyMarkBuild();  // ⏱️ Pick up the pending stick-to-air trace
+  ProtoAggSample axes;
+  shapeAxes(cs, axes);
   cmdPacket.magic = PROTO_CMD_MAGIC;
-  cmdPacket.engine = isEmergencyStopEnabled ? 0 : (uint8_t)map(sendingEngineMessage, PROTO_ENGINE_RAW_MIN, PROTO_ENGINE_RAW_MAX, PROTO_ENGINE_MIN, PROTO_ENGINE_MAX);
-  cmdPacket.ailerons = applyExpoRate(sendingAileronMessage, expoAileron, RATE_AILERON);
-  cmdPacket.rudder = applyExpoRate(sendingRudderMessage, expoRudder, RATE_RUDDER);
-  cmdPacket.elevators = applyExpoRate(sendingElevatorsMessage, expoElevator, RATE_ELEVATOR);
-  cmdPacket.elevatorTrim = (int8_t)sendingElevatorTrimMessage;
-  cmdPacket.aileronTrim = (int8_t)sendingAileronTrimMessage;
-  cmdPacket.flaps = (uint8_t)sendingFlapsMessage;
+  cmdPacket.engine = axes.engine;
+  cmdPacket.ailerons = axes.ailerons;
+  cmdPacket.rudder = axes.rudder;
+  cmdPacket.elevators = axes.elevators;
+  cmdPacket.flaps = cs.flaps;
   cmdPacket.flags = 0;
-  if (resetAileronTrim)  cmdPacket.flags |= PROTO_FLAG_RESET_AIL;
-  if (resetElevatorTrim) cmdPacket.flags |= PROTO_FLAG_RESET_ELEV;
-  if (airbrakeEnabled)   cmdPacket.flags |= PROTO_FLAG_AIRBRAKE;
-  if (acsEngageEnabled)  cmdPacket.flags |= PROTO_FLAG_ACS;
-  cmdPacket.stabilityAssist = stabilityAssistValue;
+  if (absoluteTrim) {
+    // ⚖️ Whole trim state every frame — resets are already folded into it
+    cmdPacket.elevatorTrim = cs.elevatorTrim;
+    cmdPacket.aileronTrim = cs.aileronTrim;
+    cmdPacket.flags |= PROTO_FLAG_ABS_TRIM;
+  } else if (reliableCommands) {
+    // 🔁 Trim and resets travel on the reliable queue instead
+    cmdPacket.elevatorTrim = 0;
+    cmdPacket.aileronTrim = 0;
+  } else {
+    const bool resetElev = cs.resetElevatorCount != sentResetElevatorCount;
+    const bool resetAil = cs.resetAileronCount != sentResetAileronCount;
+    cmdPacket.elevatorTrim = pendingTrimStep(cs.elevatorTrim, sentElevatorTrim, resetElev);
+    cmdPacket.aileronTrim = pendingTrimStep(cs.aileronTrim, sentAileronTrim, resetAil);
+    if (resetAil)  cmdPacket.flags |= PROTO_FLAG_RESET_AIL;
+    if (resetElev) cmdPacket.flags |= PROTO_FLAG_RESET_ELEV;
+  }
+  if (cs.airbrake)  cmdPacket.flags |= PROTO_FLAG_AIRBRAKE;
+  if (cs.acsEngage) cmdPacket.flags |= PROTO_FLAG_ACS;
+  if (implicitHeader) cmdPacket.flags |= PROTO_FLAG_IMPLICIT_HDR;  // 📏 Protocol revision marker
+  cmdPacket.stabilityAssist = cs.stabilityAssist;
   cmdPacket.checksum = proto_checksum((const uint8_t*)&cmdPacket, PROTO_CMD_PACKET_SIZE - 1);
+  return cmdPacket;
+}
+
+// 🔺 Delta frames (protocol_delta.h) — off until the flight board decodes them
+#ifndef CMD_DELTA_FRAMES
+#define CMD_DELTA_FRAMES 0
+#endif
+
+static ProtoCmdPacket keyPacket;  // Last keyframe on air
+static uint8_t framesSinceKey = PROTO_DELTA_KEYFRAME_INTERVAL;  // Start with a keyframe
+
+// 🔺 Keyframe every PROTO_DELTA_KEYFRAME_INTERVAL frames, otherwise only the
+// fields that differ from it (full frame whenever the delta would not be smaller)
+size_t encodeCommandFrame(const ProtoCmdPacket& full, uint8_t* out) {
+  if (framesSinceKey < PROTO_DELTA_KEYFRAME_INTERVAL) {
+    size_t len = proto_delta_encode(&keyPacket, &full, out);
+    if (len < PROTO_CMD_PACKET_SIZE)
+      return len;
+  }
+  memcpy(out, &full, PROTO_CMD_PACKET_SIZE);
+  return PROTO_CMD_PACKET_SIZE;
+}
+
+// 🔑 Advance the encoder only for frames that really went out
+void commandFrameSent(const uint8_t* frame, size_t len) {
+  if (frame[0] == PROTO_CMD_MAGIC && len == PROTO_CMD_PACKET_SIZE) {
+    memcpy(&keyPacket, frame, PROTO_CMD_PACKET_SIZE);
+    framesSinceKey = 1;
+  } else if (framesSinceKey < PROTO_DELTA_KEYFRAME_INTERVAL) {
+    framesSinceKey++;
+  }
+}
+
+// 🧩 XOR parity frames (protocol_fec.h) — off until the flight board rebuilds from them
+#ifndef CMD_FEC_GROUP
+#define CMD_FEC_GROUP 0  // Command frames per parity frame (0 = off)
+#endif
+static_assert(CMD_FEC_GROUP <= PROTO_FEC_MAX_GROUP, "CMD_FEC_GROUP exceeds PROTO_FEC_MAX_GROUP");
+
+static ProtoFecGroup fecGroup;  // Commands on air since the last parity frame
+static uint8_t fecGroupSize = CMD_FEC_GROUP;
+
+// 🧩 Build-time default, switchable at run time (channel simulator, diagnostics)
+void commandFecSetGroup(uint8_t k) {
+  fecGroupSize = k < PROTO_FEC_MAX_GROUP ? k : PROTO_FEC_MAX_GROUP;
+  proto_fec_reset(&fecGroup);
+}
+
+void resetCommandEncoder() {
+  framesSinceKey = PROTO_DELTA_KEYFRAME_INTERVAL;
+  proto_fec_reset(&fecGroup);
+}
+
+// 🔄 Discrete commands in cs are on air — don't repeat them
+static void markOneShotsSent(const ControlState& cs) {
+  if (absoluteTrim || reliableCommands) {  // The whole offset went out (or is queued)
+    sentElevatorTrim = cs.elevatorTrim;
+    sentAileronTrim = cs.aileronTrim;
+  } else {
+    const bool resetElev = cs.resetElevatorCount != sentResetElevatorCount;
+    const bool resetAil = cs.resetAileronCount != sentResetAileronCount;
+    sentElevatorTrim = proto_trim_step(resetElev ? 0 : sentElevatorTrim,
+                                       pendingTrimStep(cs.elevatorTrim, sentElevatorTrim, resetElev));
+    sentAileronTrim = proto_trim_step(resetAil ? 0 : sentAileronTrim,
+                                      pendingTrimStep(cs.aileronTrim, sentAileronTrim, resetAil));
+  }
+  sentResetAileronCount = cs.resetAileronCount;
+  sentResetElevatorCount = cs.resetElevatorCount;
 }
 
 #ifdef PROTO_BIDIRECTIONAL
-// 📊 Parse binary telemetry packet from flight board (14 bytes)
-static void parseTelemetry(const uint8_t* data, int len) {
-  if (len != PROTO_TLM_PACKET_SIZE) return;
+static_assert(PROTO_RX_BUF_SIZE >= PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE, "RX buffer must hold the seq trailer");
+
+// 📊 Parse one binary telemetry packet from the RX ring (14 bytes, + 📶 seq trailer)
+static bool parseTelemetry(const TlmRxEntry& e) {
+  bool sequenced = e.len == PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE;
+  if (e.len != PROTO_TLM_PACKET_SIZE && !sequenced) return false;
 
-  const ProtoTlmPacket* pkt = (const ProtoTlmPacket*)data;
-  if (pkt->magic != PROTO_TLM_MAGIC) return;
+  const ProtoTlmPacket* pkt = &e.pkt;
+  if (pkt->magic != PROTO_TLM_MAGIC) return false;
 
   // Validate software checksum
-  uint8_t expected = proto_checksum(data, PROTO_TLM_PACKET_SIZE - 1);
-  if (pkt->checksum != expected) return;
+  uint8_t expected = proto_checksum(e.raw, PROTO_TLM_PACKET_SIZE - 1);
+  if (pkt->checksum != expected) return false;
 
   // Decode fixed-point → float
   tlm_altitude      = pkt->altitude_dm    / 10.0f;
@@ -156,83 +852,428 @@ static void parseTelemetry(const uint8_t* data, int len) {
   tlm_gforce        = pkt->gforce_centi   / 100.0f;
   tlm_temperature   = pkt->temperature_dC / 10.0f;
   tlm_verticalSpeed = pkt->vspeed_dms     / 10.0f;
+  tlm_linkRssi      = e.rssi;
+  tlm_linkSnr       = e.snr;
   tlm_valid = true;
-  tlm_lastReceived = millis();
+  tlm_lastReceived = millis() - (micros() - e.arrivalUs) / 1000;  // ⏱️ Arrival, not decode time
+  const uint8_t* trailer = e.raw + PROTO_TLM_PACKET_SIZE;
+  linkOnTelemetry(e.arrivalUs, sequenced, trailer[0], trailer[1], trailer[2]);
+  if (sequenced)
+    reliableOnAck(trailer[3], trailer[4], millis());  // 🔁 Retire acked discrete commands
+  // 📶 After the acks: a rate switch may be among them. Uplink margin as if at full power (🔋 trims the rest)
+  dataRateOnTelemetry(e.rssi, e.snr, tlm_rssi < 0 ? tlm_rssi + txPowerHeadroomDb() : tlm_rssi, millis());
+  txPowerOnTelemetry(e.rssi, tlm_rssi, dataRateSensitivityDbm(dataRateProfile()));
+  return true;
 }
 
-// 📡 Check for incoming telemetry from flight board
-static void checkTelemetry() {
-  int packetSize = LoRa.parsePacket();
-  if (packetSize == 0)
+// ⚡ Queued FIFO drain done: status is in, the entry can go to the ring
+static void finishRxDrain() {
+  if (!rxDrainEntry)
     return;
+  sx1276PacketStatus(&rxDrainEntry->rssi, &rxDrainEntry->snr);
+  rxDrainEntry = nullptr;
+  tlmRingCommit();
+}
+
+// 📥 RX-done: copy the frame out of the FIFO into the ring before the next one lands
+static void drainRxFifo() {
+  uint32_t arrivalUs = rxDoneUs;
+  int size = rxPendingSize;
+
+  if (rxDrainEntry) {
+    sx1276Flush();  // ⚡ Previous drain still queued (its SPI-done wakeup not handled yet)
+    finishRxDrain();
+  }
+  TlmRxEntry* e = tlmRingReserve();
+  if (!e)
+    return;  // Ring full — frame counted as dropped
 
-  uint8_t rxBuf[PROTO_RX_BUF_SIZE];
   int idx = 0;
-  while (LoRa.available() && idx < (int)sizeof(rxBuf)) {
-    rxBuf[idx++] = (uint8_t)LoRa.read();
+  if (directSpi) {
+    idx = size < (int)sizeof(e->raw) ? size : (int)sizeof(e->raw);
+    e->len = (uint8_t)idx;
+    e->arrivalUs = arrivalUs;
+    if (!sx1276ReadPacket(e->raw, idx)) {  // 🔌 One burst, the FIFO already points at the frame
+      rxDrainEntry = e;                    // ⚡ Still on the bus: committed on LORA_EVT_SPI_DONE
+      return;
+    }
+    sx1276PacketStatus(&e->rssi, &e->snr);
+  } else {
+    while (idx < size && idx < (int)sizeof(e->raw) && LoRa.available())
+      e->raw[idx++] = (uint8_t)LoRa.read();
+    e->rssi = (int16_t)LoRa.packetRssi();
+    e->snr = LoRa.packetSnr();
   }
-  // Drain any extra bytes
-  while (LoRa.available()) LoRa.read();
 
-  parseTelemetry(rxBuf, idx);
+  e->len = (uint8_t)idx;
+  e->arrivalUs = arrivalUs;
+  tlmRingCommit();
+}
+
+#endif
 
-  static int tlmCount = 0;
-  if (++tlmCount % 5 == 0) {
-    Serial.printf("📊 TLM: Alt=%.1fm T=%.1f°C RSSI=%d G=%.2f\n",
-                  tlm_altitude, tlm_temperature, tlm_rssi, tlm_gforce);
+// ⚡ RADIO_SPI_DMA: DIO0 rose — read which interrupt it was, post what the library ISR would
+static uint32_t serviceDio0() {
+  uint8_t rxLen = 0;
+  uint8_t flags = sx1276ServiceDio0(&rxLen);
+  uint32_t events = 0;
+  if (flags & SX1276_IRQ_TX_DONE)
+    events |= LORA_EVT_TX_DONE;
+  if (flags & SX1276_IRQ_CAD_DONE) {
+    cadDetected = flags & SX1276_IRQ_CAD_DETECTED;
+    events |= LORA_EVT_CAD_DONE;
+  }
+#ifdef PROTO_BIDIRECTIONAL
+  if (rxLen) {
+    rxPendingSize = rxLen;
+    rxDoneUs = dio0Us;
+    events |= LORA_EVT_RX_DONE;
+  }
+#endif
+  return events;
+}
+
+#ifdef PROTO_BIDIRECTIONAL
+// 📶 Adaptive data rate: requests ride the reliable trailer, the radio retunes
+// once the air acked (it retuned right after that telemetry) or on fallback
+static void serviceDataRate() {
+  dataRateUpdate(millis(), reliableCommands && !implicitHeader);
+  int next = dataRatePendingSwitch();
+  if (next < 0 || radioTxBusy())
+    return;  // Retuned once the frame is off the air
+  const ProtoRateProfile p = proto_rate_profile((uint8_t)next);
+  if (directSpi) {
+    sx1276Standby();
+    sx1276SetSpreadingFactor(p.sf);
+    sx1276SetBandwidth(p.bandwidthHz);
+  } else {
+    LoRa.idle();
+    LoRa.setSpreadingFactor(p.sf);
+    LoRa.setSignalBandwidth(p.bandwidthHz);
+  }
+  dataRateSwitched(millis());
+  tlmSlotOpen = false;
+  radioOpenRxWindow();  // 📥 Listening on the new profile
+}
+
+// 🔋 Closed-loop TX power: set between frames, never mid-TX
+static void serviceTxPower() {
+  int dbm = txPowerPendingDbm();
+  if (dbm < 0 || radioTxBusy())
+    return;
+  if (directSpi)
+    sx1276SetTxPower((int8_t)dbm);
+  else
+    LoRa.setTxPower(dbm);
+  txPowerApplied();
+}
+
+// 📊 Decode everything the ring holds
+static void consumeTelemetry() {
+  const TlmRxEntry* e;
+  while ((e = tlmRingPeek()) != nullptr) {
+    bool ok = parseTelemetry(*e);
+    tlmRingPop();
+
+    static int tlmCount = 0;
+    if (ok && ++tlmCount % 5 == 0) {
+      Serial.printf("📊 TLM: Alt=%.1fm T=%.1f°C RSSI=%d G=%.2f (link %d dBm / %.1f dB)\n",
+                    tlm_altitude, tlm_temperature, tlm_rssi, tlm_gforce, tlm_linkRssi, tlm_linkSnr);
+    }
   }
 }
 #endif
 
-void loraLoop() {
-  if (!lora_initialized)
-    return;  // ⚠️ Skip if LoRa not initialized
+static_assert(PROTO_HEARTBEAT_MAGIC != PROTO_CMD_MAGIC && PROTO_HEARTBEAT_MAGIC != PROTO_DELTA_MAGIC &&
+              PROTO_HEARTBEAT_MAGIC != PROTO_TLM_MAGIC, "heartbeat magic must be unique");
 
-#ifdef PROTO_BIDIRECTIONAL
-  // 📊 Check for incoming telemetry from flight board
-  checkTelemetry();
+static uint8_t heartbeatSeq = 0;
+
+// 💓 Keepalive for the air side while duplicates are suppressed: the command it
+// holds (cmdPacket == last frame sent) is still what the pilot wants
+static void sendHeartbeat() {
+  if (millis() - txStartMs + rateControlIntervalMs() / 2 < HEARTBEAT_INTERVAL_MS)
+    return;  // Something went out recently enough (nearest TX tick wins)
+  if (implicitHeader) {
+    // 📏 Fixed frame size: the held command itself is the keepalive
+    if (!LoRa_sendPacket((const uint8_t*)&cmdPacket, PROTO_CMD_PACKET_SIZE))
+      return;
+    radioCounters.heartbeats++;
+    return;
+  }
+  ProtoHeartbeatPacket hb;
+  proto_heartbeat_build(&hb, heartbeatSeq, &cmdPacket);
+  if (!LoRa_sendPacket((const uint8_t*)&hb, PROTO_HEARTBEAT_SIZE))
+    return;
+  heartbeatSeq++;
+  radioCounters.heartbeats++;
+}
+
+static_assert(PROTO_FEC_MAGIC != PROTO_CMD_MAGIC && PROTO_FEC_MAGIC != PROTO_DELTA_MAGIC &&
+              PROTO_FEC_MAGIC != PROTO_HEARTBEAT_MAGIC && PROTO_FEC_MAGIC != PROTO_TLM_MAGIC,
+              "parity magic must be unique");
+
+// 🧩 Group full → this slot carries its parity frame instead of a command
+static bool sendParity() {
+  uint8_t frame[PROTO_FEC_MAX_SIZE];
+  size_t len = proto_fec_encode(&fecGroup, frame);
+  if (!LoRa_sendPacket(frame, len))
+    return false;
+  proto_fec_reset(&fecGroup);
+  radioCounters.parityTx++;
+  return true;
+}
+
+static_assert(!(PROTO_FLAG_IMPLICIT_HDR & (PROTO_FLAG_RESET_AIL | PROTO_FLAG_RESET_ELEV | PROTO_FLAG_AIRBRAKE |
+                                          PROTO_FLAG_ACS | PROTO_FLAG_ABS_TRIM)),
+              "implicit-header flag must be unique");
+#if CMD_IMPLICIT_HEADER && (CMD_DELTA_FRAMES || CMD_FEC_GROUP || CMD_RELIABLE || CMD_AGGREGATE_SAMPLES > 1)
+#error "CMD_IMPLICIT_HEADER needs fixed-size frames: turn off delta / parity / reliable trailers / multi-sample"
 #endif
 
-  if (runEvery(PROTO_CMD_INTERVAL_MS)) {  // 📡 Send every 50ms
-    constructMessage();
+static_assert(PROTO_AGG_MAGIC != PROTO_CMD_MAGIC && PROTO_AGG_MAGIC != PROTO_DELTA_MAGIC &&
+              PROTO_AGG_MAGIC != PROTO_HEARTBEAT_MAGIC && PROTO_AGG_MAGIC != PROTO_FEC_MAGIC &&
+              PROTO_AGG_MAGIC != PROTO_TLM_MAGIC, "multi-sample magic must be unique");
 
-    int aileronDeviation = abs(sendingAileronMessage - PROTO_JOYSTICK_CENTER);
-    int rudderDeviation = abs(sendingRudderMessage - PROTO_JOYSTICK_CENTER);
-    int elevatorsDeviation = abs(sendingElevatorsMessage - PROTO_JOYSTICK_CENTER);
-    int totalDeviation = aileronDeviation + rudderDeviation + elevatorsDeviation;
+// 🧺 Sample timer tick: one shaped stick snapshot into the ring
+static void takeStickSample() {
+  if (aggSamples < 2)
+    return;
+  const uint8_t cap = PROTO_AGG_MAX_SAMPLES;
+  StickSample& s = stickSamples[stickHead];
+  s.atUs = micros();
+  ControlState cs = controlSnapshot();
+  if (cs.ecoMode)
+    inputFilterApply(cs);  // 🎚️ Same quantized sticks as the command they ride with
+  shapeAxes(cs, s.axes);
+  stickHead = (uint8_t)((stickHead + 1) % cap);
+  if (stickCount < cap)
+    stickCount++;
+}
 
-    // 🧮 FNV-1a hash on binary packet for accurate duplicate detection
-    uint32_t currentHash = fnv1a_hash((const uint8_t*)&cmdPacket, PROTO_CMD_PACKET_SIZE);
+// 🧺 cmdPacket with up to aggSamples − 1 samples taken since the last frame
+// (a plain command when there are none)
+static size_t encodeAggregateFrame(uint8_t* out) {
+  const uint8_t cap = PROTO_AGG_MAX_SAMPLES;
+  const uint32_t nowUs = micros();
+  const uint32_t sameTickUs = slotPeriodUs / aggSamples / 2;  // This tick's own sample is cmdPacket
+  ProtoAggSample newestFirst[PROTO_AGG_MAX_SAMPLES - 1];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < stickCount && n < aggSamples - 1; i++) {
+    const StickSample& s = stickSamples[(stickHead + cap - 1 - i) % cap];
+    uint32_t ageUs = nowUs - s.atUs;
+    if ((int32_t)(s.atUs - lastAggFrameUs) <= 0 || ageUs > 255000)
+      break;  // Already on air, or too old for the age byte
+    if (ageUs < sameTickUs)
+      continue;
+    newestFirst[n] = s.axes;
+    newestFirst[n++].ageMs = (uint8_t)((ageUs + 500) / 1000);
+  }
+  if (!n) {
+    memcpy(out, &cmdPacket, PROTO_CMD_PACKET_SIZE);
+    return PROTO_CMD_PACKET_SIZE;
+  }
+  ProtoAggSample older[PROTO_AGG_MAX_SAMPLES - 1];
+  for (uint8_t i = 0; i < n; i++)
+    older[i] = newestFirst[n - 1 - i];
+  return proto_agg_encode(&cmdPacket, older, n, out);
+}
 
-    // 🌿 ECO mode: skip sending duplicate packets when idle (saves bandwidth)
-    if (ecoModeEnabled && currentHash == previousHash &&
-        samePacketCount >= PROTO_DUPLICATE_LIMIT &&
-        totalDeviation < PROTO_IDLE_THRESHOLD) {
-      return;
-    }
+#define CMD_FRAME_MAX_SIZE (PROTO_AGG_MAX_SIZE > PROTO_DELTA_MAX_SIZE ? PROTO_AGG_MAX_SIZE : PROTO_DELTA_MAX_SIZE)
 
-    LoRa_sendPacket((const uint8_t*)&cmdPacket, PROTO_CMD_PACKET_SIZE);  // 📡 Send binary (10 bytes)
+// 📏 What the command slot has to hold: 🧺 multi-sample frames, 🔁 reliable
+// trailer, 🧩 parity, 📶 seq trailer (a delta only goes out when shorter)
+size_t loraCommandFrameMaxSize() {
+  size_t len = PROTO_CMD_PACKET_SIZE;
+  if (!implicitHeader) {
+    if (aggSamples > 1)
+      len = PROTO_AGG_SIZE(aggSamples);
+    if (reliableCommands)
+      len += PROTO_REL_TRAILER_SIZE;
+    if (fecGroupSize && PROTO_FEC_SIZE(fecGroupSize) > len)
+      len = PROTO_FEC_SIZE(fecGroupSize);
+  }
+  return LINK_SEQ_TRAILER ? len + LINK_UP_TRAILER_SIZE : len;
+}
+
+// 📡 One command slot: build, ECO-suppress, send
+// priority: 🚨 lane frame — never suppressed, always a full keyframe
+static bool transmitCommand(bool priority = false) {
+  if (!priority && fecGroupSize && !implicitHeader && fecGroup.count >= fecGroupSize)
+    return sendParity();
+
+  ControlState cs = controlSnapshot();  // 🔒 One consistent controller report per packet
+  if (cs.ecoMode)
+    inputFilterApply(cs);  // 🎚️ Stick noise must not defeat duplicate suppression
+  constructMessage(cs);
+  if (reliableCommands)
+    reliableTrack(cs, millis());  // 🔁 Discrete state changes → reliable queue
+
+  int aileronDeviation = abs(cs.aileron - PROTO_JOYSTICK_CENTER);
+  int rudderDeviation = abs(cs.rudder - PROTO_JOYSTICK_CENTER);
+  int elevatorsDeviation = abs(cs.elevators - PROTO_JOYSTICK_CENTER);
+  int totalDeviation = aileronDeviation + rudderDeviation + elevatorsDeviation;
+
+  // 🧮 FNV-1a hash on binary packet for accurate duplicate detection
+  uint32_t currentHash = fnv1a_hash((const uint8_t*)&cmdPacket, PROTO_CMD_PACKET_SIZE);
+
+  // 🌿 ECO mode: duplicate packets when idle become a heartbeat (saves bandwidth)
+  if (!priority && cs.ecoMode && currentHash == previousHash &&
+      samePacketCount >= PROTO_DUPLICATE_LIMIT &&
+      totalDeviation < PROTO_IDLE_THRESHOLD &&
+      !(reliableCommands && reliableDue(millis()))) {  // 🔁 An unacked command keeps frames flowing
+    sendHeartbeat();
+    return false;
+  }
+
+  uint8_t frame[CMD_FRAME_MAX_SIZE + PROTO_REL_TRAILER_SIZE];
+  size_t len = PROTO_CMD_PACKET_SIZE;
+  if (aggSamples > 1 && !priority && !implicitHeader)
+    len = encodeAggregateFrame(frame);
+  else if (CMD_DELTA_FRAMES && !priority && !implicitHeader)
+    len = encodeCommandFrame(cmdPacket, frame);
+  else
+    memcpy(frame, &cmdPacket, PROTO_CMD_PACKET_SIZE);
+  size_t trailerLen = reliableCommands && !implicitHeader ? reliableTrailer(frame + len, millis()) : 0;
+
+  // 📡 Send binary (keyframe / delta / 🧺 multi-sample, + 🔁 trailer) — 🚨 priority frames don't wait for the channel
+  if (!radioSend(frame, len + trailerLen, lbtEnabled && !priority))
+    return false;
+  commandFrameSent(frame, len);
+  lastAggFrameUs = micros();
+  if (frame[0] == PROTO_AGG_MAGIC)
+    radioCounters.aggSamples += (uint32_t)(len - PROTO_AGG_SIZE(1)) / PROTO_AGG_SAMPLE_SIZE;
+  if (trailerLen)
+    reliableTrailerSent(millis());
+  if (fecGroupSize)
+    proto_fec_add(&fecGroup, &cmdPacket);  // 🧩 Covered by the next parity frame
+  if (priority) {
+    latencyMarkPrioritySent();  // ⏱️ Press-to-air, first frame of the burst
+    radioCounters.priorityTx++;
+  }
+
+  // Reduced serial output - print every 10th packet
+  static int printCount = 0;
+  if (++printCount >= 10) {
+    Serial.printf("📡 TX [%dB]: E=%d A=%d R=%d L=%d F=%d flags=0x%02X\n",
+                  (int)len, cmdPacket.engine, cmdPacket.ailerons,
+                  cmdPacket.rudder, cmdPacket.elevators, cmdPacket.flaps, cmdPacket.flags);
+    printCount = 0;
+  }
+
+  if (currentHash == previousHash)
+    samePacketCount++;  // 📈 Increment duplicate count
+  else
+    samePacketCount = 0;  // 🔄 Reset duplicate count
+
+  previousHash = currentHash;  // 💾 Store for comparison
+
+  markOneShotsSent(cs);  // 🔄 One-shot trim / reset commands delivered
+  return true;
+}
+
+// 🚨 Priority lane: next burst frame as soon as the channel is ours.
+// True while the lane owns the channel (regular slots stand aside).
+static bool servicePriorityLane(uint32_t events) {
+  if (events & LORA_EVT_PRIORITY)
+    priorityFramesLeft = PRIORITY_REPEAT_COUNT;  // (Re)start the burst with the latest state
+  if (!priorityFramesLeft)
+    return false;
 
-    // Reduced serial output - print every 10th packet
-    static int printCount = 0;
-    if (++printCount >= 10) {
-      Serial.printf("📡 TX [%dB]: E=%d A=%d R=%d L=%d F=%d flags=0x%02X\n",
-                    PROTO_CMD_PACKET_SIZE, cmdPacket.engine, cmdPacket.ailerons,
-                    cmdPacket.rudder, cmdPacket.elevators, cmdPacket.flaps, cmdPacket.flags);
-      printCount = 0;
+  txPending = false;  // The burst carries the latest state anyway
+  if (radio == RadioState::LBT) {
+    radioCounters.lbtCutShort++;
+    lbtRelease(false);  // 👂 No more listening: the held frame now, the burst on its TX done
+  }
+  if (radioTxBusy())
+    return true;  // Goes out on TX done
+  if (tdmaSlotReserved()) {
+    tdmaWakeAtSlotEnd();
+    return true;
+  }
+  if (transmitCommand(true))
+    priorityFramesLeft--;
+  return true;
+}
+
+// 📡 LoRaTask body — runs once per wakeup and handles whatever the TX timer /
+// DIO0 interrupt posted since the last run
+void loraLoop() {
+  uint32_t startUs = micros();
+  uint32_t events = pendingEvents.exchange(0);
+  if (events & LORA_EVT_DIO0)
+    events |= serviceDio0();
+  schedWindow.wakeups++;
+  if (events & LORA_EVT_TX_DONE)
+    schedWindow.txDone++;
+  if (events & LORA_EVT_RX_DONE)
+    schedWindow.rxDone++;
+
+  if (lora_initialized) {
+#ifdef PROTO_BIDIRECTIONAL
+    if ((events & LORA_EVT_SPI_DONE) && rxDrainEntry) {
+      finishRxDrain();
+      tlmSlotOpen = false;  // 🗓️ Telemetry is in the ring — the channel is ours again
     }
+    if (events & LORA_EVT_RX_DONE) {
+      if (radio != RadioState::RX_WINDOW)
+        radioCounters.rxOutsideWindow++;
+      drainRxFifo();  // 📥 First: the FIFO is overwritten by the next frame
+      if (!rxDrainEntry)
+        tlmSlotOpen = false;  // 🗓️ Telemetry is in the ring — the channel is ours again
+    }
+#endif
+    if (events & LORA_EVT_TX_DONE)
+      radioOnTxDone();
+    if (events & LORA_EVT_CAD_DONE)
+      lbtOnCadDone();
+    if (events & LORA_EVT_LBT)
+      lbtOnTimer();
 
-    if (currentHash == previousHash)
-      samePacketCount++;  // 📈 Increment duplicate count
-    else
-      samePacketCount = 0;  // 🔄 Reset duplicate count
+    if (events & LORA_EVT_SAMPLE)
+      takeStickSample();  // 🧺 Before the TX tick that may share its instant
 
-    previousHash = currentHash;  // 💾 Store for comparison
+#ifdef PROTO_BIDIRECTIONAL
+    // 📊 Off the SPI path: decode what the ring holds, before any TX — the telemetry
+    // that just closed the slot may ack a profile switch the released command must use
+    consumeTelemetry();
+    serviceDataRate();
+    serviceTxPower();
+#endif
+
+    bool priorityLane = servicePriorityLane(events);
+
+    if (events & LORA_EVT_TX_TICK) {  // 📡 Send every rateControlIntervalMs()
+      markSlot(startUs);
+      retimeCommandSlot();
+      if (txPending && !priorityLane)
+        radioCounters.txMerged++;
+      if (priorityLane) {
+        // 🚨 Burst in progress: this slot's state goes out with it
+      } else if (radioTxBusy()) {
+        radioCounters.txDeferred++;
+        txPending = true;  // Goes out once TX done (and the telemetry slot) is over
+      } else if (tdmaSlotReserved()) {
+        radioCounters.slotDeferred++;
+        txPending = true;
+        tdmaWakeAtSlotEnd();
+      } else {
+        transmitCommand();
+      }
+    }
 
-    // Reset one-shot messages
-    sendingElevatorTrimMessage = 0;
-    sendingAileronTrimMessage = 0;
-    resetAileronTrim = false;
-    resetElevatorTrim = false;
+    if (txPending && !priorityLane && !radioTxBusy()) {
+      if (!tdmaSlotReserved()) {
+        txPending = false;
+        transmitCommand();
+      } else if (events & LORA_EVT_TX_DONE) {
+        tdmaWakeAtSlotEnd();  // Deferred behind our own TX, now behind the telemetry slot
+      }
+    }
+    if (radio == RadioState::IDLE)
+      radioOpenRxWindow();  // 📥 Only once the TX is really off the air
   }
-}
\ No newline at end of file
+
+  schedWindow.busyUs += micros() - startUs;
+  rollSchedulerWindow();
+}
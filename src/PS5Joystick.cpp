@@ -1,11 +1,17 @@
 #include "PS5Joystick.h"
+#include "Latency.h"
+#include "TxScheduler.h"
 #include "common.h"
+#include "protocol_trim.h"
 
 unsigned long lastTimeStamp = 0;
 
 unsigned long lastFlapsChangeTimestamp = 0;
 unsigned long lastExpoChangeTimestamp = 0;
 unsigned long lastShareChangeTimestamp = 0;
+unsigned long lastOptionsChangeTimestamp = 0;
+unsigned long lastElevatorTrimTimestamp = 0;
+unsigned long lastAileronTrimTimestamp = 0;
 
 uint8_t batteryPercentage = 0;
 
@@ -43,22 +49,35 @@ void printDeviceAddress() {
   Serial.println();
 }
 
+// ⚖️ Held D-pad repeats at the command rate: one step per packet on average,
+// however often reports arrive (a fresh press steps at once)
+static bool trimRepeatDue(unsigned long& lastStepMs) {
+  unsigned long since = millis() - lastStepMs;
+  if (since < PROTO_CMD_INTERVAL_MS)
+    return false;
+  lastStepMs = since < 2 * PROTO_CMD_INTERVAL_MS ? lastStepMs + PROTO_CMD_INTERVAL_MS : millis();
+  return true;
+}
+
 // 🎮
 void notify() {
   if (millis() - lastTimeStamp > 20) {
     lastTimeStamp = millis();
+    uint32_t notifyUs = micros();  // ⏱️ Latency trace
 
-    if (ps5.Up())  // Up Button ⬆️
-      sendingElevatorTrimMessage = 1;
-
-    if (ps5.Down())  // Down Button ⬇️
-      sendingElevatorTrimMessage = -1;
+    // 🔒 One consistent ControlState per controller report
+    ControlState& cs = controlBeginWrite();
+    bool wasStopped = cs.emergencyStop;
 
-    if (ps5.Right())  // Right Button ➡️
-      sendingAileronTrimMessage = 1;
+    if ((ps5.Up() || ps5.Down()) && trimRepeatDue(lastElevatorTrimTimestamp)) {
+      int8_t dir = ps5.Up() ? +1 : -1;  // Up Button ⬆️ / Down Button ⬇️
+      cs.elevatorTrim = proto_trim_step(cs.elevatorTrim, dir);
+    }
 
-    if (ps5.Left())  // Left Button ⬅️
-      sendingAileronTrimMessage = -1;
+    if ((ps5.Right() || ps5.Left()) && trimRepeatDue(lastAileronTrimTimestamp)) {
+      int8_t dir = ps5.Right() ? +1 : -1;  // Right Button ➡️ / Left Button ⬅️
+      cs.aileronTrim = proto_trim_step(cs.aileronTrim, dir);
+    }
 
     if (ps5.Square() && millis() - lastExpoChangeTimestamp > 300) {  // 🟥 Square: cycle expo preset
       cycleExpoPreset();
@@ -67,60 +86,82 @@ void notify() {
 
     if (ps5.Cross()) {  // Cross Button ❌
       digitalWrite(BUILTIN_LED, 1);
-      isEmergencyStopEnabled = false;  // 🔓 Disable emergency stop
-      airbrakeEnabled = false;         // 🚀 Disable airbrake
-      acsEngageEnabled = false;        // 🤖 Disable ACS
+      cs.emergencyStop = false;  // 🔓 Disable emergency stop
+      cs.airbrake = false;       // 🚀 Disable airbrake
+      cs.acsEngage = false;      // 🤖 Disable ACS
       // ⏱️ Start flight timer on arm
-      if (!flightTimerRunning) {
-        flightTimerStartMs = millis();
-        flightTimerRunning = true;
+      if (!cs.flightTimerRunning) {
+        cs.flightTimerStartMs = millis();
+        cs.flightTimerRunning = true;
       }
     } else
       digitalWrite(BUILTIN_LED, 0);
 
     if (ps5.Circle()) {               // Circle Button ⭕
-      isEmergencyStopEnabled = true;  // 🚨 Enable emergency stop
-      flightTimerRunning = false;     // ⏱️ Stop flight timer on disarm
+      cs.emergencyStop = true;        // 🚨 Enable emergency stop
+      cs.flightTimerRunning = false;  // ⏱️ Stop flight timer on disarm
     }
 
-    if (ps5.Triangle())         // Triangle Button 🔺
-      acsEngageEnabled = true;  // 🤖 Engage ACS autopilot
+    if (ps5.Triangle())    // Triangle Button 🔺
+      cs.acsEngage = true;  // 🤖 Engage ACS autopilot
 
     if (ps5.L1() && millis() - lastFlapsChangeTimestamp > 200) {
-      sendingFlapsMessage = constrain(sendingFlapsMessage - 1, 0, 4);  // ⬇️ Decrease flaps
+      cs.flaps = constrain(cs.flaps - 1, 0, 4);  // ⬇️ Decrease flaps
       lastFlapsChangeTimestamp = millis();
     }
 
     if (ps5.R1() && millis() - lastFlapsChangeTimestamp > 200) {
-      sendingFlapsMessage = constrain(sendingFlapsMessage + 1, 0, 4);  // ⬆️ Increase flaps
+      cs.flaps = constrain(cs.flaps + 1, 0, 4);  // ⬆️ Increase flaps
       lastFlapsChangeTimestamp = millis();
     }
 
     if (ps5.Share() && millis() - lastShareChangeTimestamp > 300) {  // 🌿 Share: toggle ECO mode
-      ecoModeEnabled = !ecoModeEnabled;
+      cs.ecoMode = !cs.ecoMode;
       lastShareChangeTimestamp = millis();
     }
 
-    // if (ps5.Options())  // Options Button ⚙️
+    if (ps5.Options() && millis() - lastOptionsChangeTimestamp > 300) {  // ⚙️ Options: next HUD frame
+      cs.hudPageCount++;
+      lastOptionsChangeTimestamp = millis();
+    }
 
-    if (ps5.L3())               // L3 Button 🔘
-      resetAileronTrim = true;  // 🔄 Reset aileron trim
+    if (ps5.L3()) {            // L3 Button 🔘
+      cs.resetAileronCount++;  // 🔄 Reset aileron trim
+      cs.aileronTrim = 0;
+    }
 
-    if (ps5.R3())                // R3 Button 🔘
-      resetElevatorTrim = true;  // 🔄 Reset elevator trim
+    if (ps5.R3()) {             // R3 Button 🔘
+      cs.resetElevatorCount++;  // 🔄 Reset elevator trim
+      cs.elevatorTrim = 0;
+    }
 
-    if (ps5.PSButton())        // PS Button ⏹️
-      airbrakeEnabled = true;  // 🛑 Enable airbrake
+    if (ps5.PSButton())    // PS Button ⏹️
+      cs.airbrake = true;  // 🛑 Enable airbrake
 
     // if (ps5.Touchpad()) // Touch Pad Button 🖱️
 
     // 🕹️ Joystick inputs
-    sendingAileronMessage = ps5.LStickX() + 128;    // ↔️ Aileron
-    sendingRudderMessage = ps5.RStickX() + 128;     // ↔️ Rudder
-    sendingElevatorsMessage = ps5.RStickY() + 128;  // ↕️ Elevators
+    byte aileron = ps5.LStickX() + 128;    // ↔️ Aileron
+    byte rudder = ps5.RStickX() + 128;     // ↔️ Rudder
+    byte elevators = ps5.RStickY() + 128;  // ↕️ Elevators
+    bool sticksMoved = aileron != cs.aileron || rudder != cs.rudder || elevators != cs.elevators;
+    cs.aileron = aileron;
+    cs.rudder = rudder;
+    cs.elevators = elevators;
+
+    // ⏱️ BT hops + start of the stick-to-air trace
+    latencyMarkInput(ps5.RxMicros(), ps5.ParseMicros(), ps5.EventMicros(), notifyUs, sticksMoved);
 
     // 🛡️ Stability Assist — L2 analog trigger (0-255)
-    stabilityAssistValue = ps5.L2Value();
+    cs.stabilityAssist = ps5.L2Value();
+
+    bool stopped = cs.emergencyStop;
+    controlEndWrite();  // 📤 Publish to LoRaTask / DisplayTask
+
+    if (stopped && !wasStopped) {  // 🚨 E-stop / disarm: priority lane, don't wait for the TX tick
+      latencyMarkPriorityInput(ps5.RxMicros());
+      loraRequestPriority();
+    }
 
 #if EVENTS
     boolean sqd = ps5.event.button_down.square, squ = ps5.event.button_up.square, trd = ps5.event.button_down.triangle,
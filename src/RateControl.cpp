@@ -0,0 +1,122 @@
+#include "RateControl.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "TxScheduler.h"
+
+// 📒 Fastest sustainable period: one command frame per LORA_AIRTIME_BUDGET_PERMILLE share,
+// sized for the longest frame the current settings send, in the header mode the radio runs
+static constexpr uint32_t budgetFloorMs(size_t frameLen, bool implicitHeader) {
+  return (tdmaCmdSlotUs(frameLen, implicitHeader) + LORA_AIRTIME_BUDGET_PERMILLE - 1) / LORA_AIRTIME_BUDGET_PERMILLE;
+}
+#ifdef PROTO_BIDIRECTIONAL
+static constexpr uint32_t tdmaFloorMs(size_t frameLen, bool implicitHeader) {  // 🗓️ Leave room for telemetry
+  return (tdmaCmdSlotUs(frameLen, implicitHeader) + tdmaTlmSlotUs(implicitHeader) + 999) / 1000;
+}
+#else
+static constexpr uint32_t tdmaFloorMs(size_t, bool) {
+  return 0;
+}
+#endif
+static constexpr uint32_t floorFor(size_t frameLen, bool implicitHeader) {
+  return budgetFloorMs(frameLen, implicitHeader) > tdmaFloorMs(frameLen, implicitHeader)
+             ? budgetFloorMs(frameLen, implicitHeader)
+             : tdmaFloorMs(frameLen, implicitHeader);
+}
+static constexpr uint32_t fastFor(uint32_t floorMs) {
+  return RATE_MIN_INTERVAL_MS > floorMs ? RATE_MIN_INTERVAL_MS : floorMs;
+}
+static constexpr uint32_t slowFor(uint32_t fastMs) {
+  return RATE_MAX_INTERVAL_MS > fastMs ? RATE_MAX_INTERVAL_MS : fastMs;
+}
+
+// Picked again by rateControlReset() (header mode, multi-sample / trailers may have switched)
+static uint32_t floorMs = floorFor(PROTO_CMD_PACKET_SIZE, CMD_IMPLICIT_HEADER);
+static uint32_t fastMs = fastFor(floorFor(PROTO_CMD_PACKET_SIZE, CMD_IMPLICIT_HEADER));
+static uint32_t slowMs = slowFor(fastFor(floorFor(PROTO_CMD_PACKET_SIZE, CMD_IMPLICIT_HEADER)));
+
+// LoRaTask only
+static ControlState lastState;
+static bool haveLastState = false;
+static uint32_t lastUpdateMs = 0;
+static float activity = 0.0f;  // Smoothed stick units/s
+static uint32_t intervalMs = PROTO_CMD_INTERVAL_MS;
+
+void rateControlReset(uint32_t nowMs) {
+  haveLastState = false;
+  lastUpdateMs = nowMs;
+  activity = 0.0f;
+  intervalMs = PROTO_CMD_INTERVAL_MS;
+  floorMs = floorFor(loraCommandFrameMaxSize(), radioImplicitHeader());
+  fastMs = fastFor(floorMs);
+  slowMs = slowFor(fastMs);
+}
+
+// 🔘 Anything that is not a stick: must reach the air quickly
+static bool discreteChanged(const ControlState& a, const ControlState& b) {
+  return a.flaps != b.flaps || a.emergencyStop != b.emergencyStop || a.airbrake != b.airbrake ||
+         a.acsEngage != b.acsEngage || a.elevatorTrim != b.elevatorTrim ||
+         a.aileronTrim != b.aileronTrim || a.resetAileronCount != b.resetAileronCount ||
+         a.resetElevatorCount != b.resetElevatorCount;
+}
+
+uint32_t rateControlUpdate(const ControlState& cs, uint32_t nowMs, uint32_t airtimeLeftUs) {
+  uint32_t dtMs = nowMs - lastUpdateMs;
+  if (dtMs == 0)
+    dtMs = 1;
+
+  // 🎮 Instantaneous activity since the last tick (throttle scaled to stick units)
+  float instant = 0.0f;
+  if (haveLastState) {
+    uint32_t moved = abs(cs.aileron - lastState.aileron) + abs(cs.elevators - lastState.elevators) +
+                     abs(cs.rudder - lastState.rudder) +
+                     (uint32_t)abs(cs.engine - lastState.engine) * 255 / PROTO_ENGINE_RAW_MAX;
+    instant = moved * 1000.0f / dtMs;
+    if (discreteChanged(cs, lastState) && instant < RATE_ACTIVITY_FULL)
+      instant = RATE_ACTIVITY_FULL;
+  }
+  lastState = cs;
+  haveLastState = true;
+  lastUpdateMs = nowMs;
+
+  // ⚡ Fast attack, 🌿 exponential decay
+  if (instant >= activity)
+    activity = instant;
+  else
+    activity = instant + (activity - instant) * expf(-(float)dtMs / RATE_DECAY_MS);
+
+  if (!cs.ecoMode) {
+    intervalMs = PROTO_CMD_INTERVAL_MS;
+    return intervalMs;
+  }
+
+  float share = activity >= RATE_ACTIVITY_FULL ? 1.0f : activity / RATE_ACTIVITY_FULL;
+  uint32_t target = slowMs - (uint32_t)lroundf((slowMs - fastMs) * share);
+
+  // 📒 Ledger nearly spent (other traffic, bursts) → back off
+  if (airtimeLeftUs < 2 * LORA_CMD_AIRTIME_US && target < 2 * intervalMs)
+    target = 2 * intervalMs;
+
+  if (target > intervalMs) {  // 📈 Slow down gradually
+    uint32_t step = intervalMs * RATE_GROW_PERCENT / 100;
+    if (target > intervalMs + (step ? step : 1))
+      target = intervalMs + (step ? step : 1);
+  }
+  intervalMs = target < fastMs ? fastMs : (target > slowMs ? slowMs : target);
+  return intervalMs;
+}
+
+uint32_t rateControlIntervalMs() {
+  return intervalMs;
+}
+
+uint32_t rateControlActivity() {
+  return (uint32_t)activity;
+}
+
+uint32_t rateControlFloorMs() {
+  return floorMs;
+}
@@ -0,0 +1,155 @@
+#include "ReliableQueue.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+// Owned by LoRaTask
+struct ReliableSlot {
+  bool pending;     // Not acked with the current arg yet
+  bool sentOnce;    // Current arg went out at least once
+  uint8_t arg;      // Latest state
+  uint8_t sentArg;  // State carried by the latest send
+  uint8_t id;       // Id of the latest send
+  uint32_t queuedMs;
+  uint32_t sentMs;
+};
+
+static ReliableSlot slots[PROTO_REL_OP_COUNT];  // Index = op − 1
+static ReliableStats stats;
+static uint8_t nextId = 0;
+static int staged = -1;  // Slot of the trailer handed out, until it is on air
+static bool tracking = false;
+static uint8_t trackedArgs[RELIABLE_STATE_OPS];
+
+void reliableReset() {
+  memset(slots, 0, sizeof(slots));
+  stats = ReliableStats();
+  staged = -1;
+  tracking = false;
+}
+
+static void fillArgs(const ControlState& cs, uint8_t* args) {
+  args[PROTO_REL_OP_RESET_AIL - 1] = cs.resetAileronCount;
+  args[PROTO_REL_OP_RESET_ELEV - 1] = cs.resetElevatorCount;
+  args[PROTO_REL_OP_TRIM_AIL - 1] = (uint8_t)cs.aileronTrim;
+  args[PROTO_REL_OP_TRIM_ELEV - 1] = (uint8_t)cs.elevatorTrim;
+  args[PROTO_REL_OP_AIRBRAKE - 1] = cs.airbrake;
+  args[PROTO_REL_OP_ACS - 1] = cs.acsEngage;
+  args[PROTO_REL_OP_FLAPS - 1] = cs.flaps;
+}
+
+static void queueArg(uint8_t i, uint8_t arg, uint32_t nowMs) {
+  ReliableSlot& s = slots[i];
+  if (!s.pending)
+    s.queuedMs = nowMs;
+  s.pending = true;
+  s.sentOnce = false;  // 🔄 Newer value replaces whatever was in flight
+  s.arg = arg;
+  stats.queued++;
+}
+
+void reliableTrack(const ControlState& cs, uint32_t nowMs) {
+  uint8_t args[RELIABLE_STATE_OPS];
+  fillArgs(cs, args);
+  if (!tracking) {  // First snapshot is the baseline the air side starts from
+    memcpy(trackedArgs, args, sizeof(args));
+    tracking = true;
+    return;
+  }
+  for (uint8_t i = 0; i < RELIABLE_STATE_OPS; i++) {
+    if (args[i] == trackedArgs[i])
+      continue;
+    queueArg(i, args[i], nowMs);
+    trackedArgs[i] = args[i];
+  }
+}
+
+void reliableQueueOp(uint8_t op, uint8_t arg, uint32_t nowMs) {
+  if (op > RELIABLE_STATE_OPS && op <= PROTO_REL_OP_COUNT)
+    queueArg(op - 1, arg, nowMs);
+}
+
+void reliableCancel(uint8_t op) {
+  if (op >= 1 && op <= PROTO_REL_OP_COUNT) {
+    slots[op - 1].pending = false;
+    if (staged == op - 1)
+      staged = -1;
+  }
+}
+
+bool reliableOpPending(uint8_t op) {
+  return op >= 1 && op <= PROTO_REL_OP_COUNT && slots[op - 1].pending;
+}
+
+// 📤 Unsent first, then the one waiting longest for its ack
+static int nextDue(uint32_t nowMs) {
+  int best = -1;
+  for (uint8_t i = 0; i < PROTO_REL_OP_COUNT; i++) {
+    const ReliableSlot& s = slots[i];
+    if (!s.pending)
+      continue;
+    if (s.sentOnce && nowMs - s.sentMs < RELIABLE_ACK_TIMEOUT_MS)
+      continue;
+    if (best < 0 || (slots[best].sentOnce && !s.sentOnce) ||
+        (slots[best].sentOnce == s.sentOnce && (int32_t)(s.queuedMs - slots[best].queuedMs) < 0))
+      best = i;
+  }
+  return best;
+}
+
+bool reliableDue(uint32_t nowMs) {
+  return nextDue(nowMs) >= 0;
+}
+
+size_t reliableTrailer(uint8_t* out, uint32_t nowMs) {
+  staged = nextDue(nowMs);
+  if (staged < 0)
+    return 0;
+  proto_rel_encode(nextId, (uint8_t)(staged + 1), slots[staged].arg, out);
+  return PROTO_REL_TRAILER_SIZE;
+}
+
+void reliableTrailerSent(uint32_t nowMs) {
+  if (staged < 0)
+    return;
+  ReliableSlot& s = slots[staged];
+  if (s.sentOnce)
+    stats.resent++;
+  else
+    stats.sent++;
+  s.id = nextId++;
+  s.sentArg = s.arg;
+  s.sentOnce = true;
+  s.sentMs = nowMs;
+  staged = -1;
+}
+
+void reliableOnAck(uint8_t ackId, uint8_t ackMask, uint32_t nowMs) {
+  for (ReliableSlot& s : slots) {
+    if (!s.pending || !s.sentOnce || s.sentArg != s.arg || !proto_rel_acked(ackId, ackMask, s.id))
+      continue;
+    s.pending = false;
+    stats.acked++;
+    if (nowMs - s.queuedMs > stats.maxAckMs)
+      stats.maxAckMs = nowMs - s.queuedMs;
+  }
+}
+
+uint8_t reliablePendingCount() {
+  uint8_t n = 0;
+  for (const ReliableSlot& s : slots)
+    n += s.pending;
+  return n;
+}
+
+const ReliableStats& reliableStats() {
+  return stats;
+}
+
+void reliablePrintReport() {
+  if (!stats.queued)
+    return;
+  Serial.printf("🔁 Reliable: %lu queued, %lu sent + %lu resent, %lu acked (max %lu ms), %u pending\n",
+                (unsigned long)stats.queued, (unsigned long)stats.sent, (unsigned long)stats.resent,
+                (unsigned long)stats.acked, (unsigned long)stats.maxAckMs, (unsigned)reliablePendingCount());
+}
@@ -0,0 +1,462 @@
+#include "SX1276.h"
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <driver/spi_master.h>
+#include <string.h>
+
+#define SX1276_VERSION 0x12
+#define SX1276_REG_COUNT 0x80
+#define SX1276_TX_BASE 0x00  // Whole FIFO for either direction, like LoRa.begin()
+#define SX1276_RX_BASE 0x00
+
+// Owned by LoRaTask (and setupRadio() before it starts)
+static uint8_t csPin = 0;
+static SPISettings spiSettings(SX1276_SPI_HZ, MSBFIRST, SPI_MODE0);
+static uint8_t cache[SX1276_REG_COUNT];
+static uint8_t cacheValid[SX1276_REG_COUNT / 8];
+static Sx1276Stats stats;
+static long frequencyHz = 0;  // RSSI offset depends on the band
+static uint8_t spreadingFactor = 7;
+static long bandwidthHz = 125000;
+static uint8_t txBuffer[256] __attribute__((aligned(4)));  // 📦 Frame + tail, one FIFO burst
+static uint8_t pktStatus[2] __attribute__((aligned(4)));   // PKT_SNR_VALUE, PKT_RSSI_VALUE of the last frame read
+
+// ⚡ spi_master backend: ring of transactions in flight, completed in order
+struct QueuedTransfer {
+  spi_transaction_t t;
+  uint8_t op;  // SX1276_OP_*, 0 = none
+};
+static bool dma = false;
+static spi_device_handle_t spiDevice = NULL;
+static QueuedTransfer queue[SX1276_QUEUE_DEPTH];
+static uint8_t queueNext = 0;
+static uint8_t inFlight = 0;
+static bool txBufferBusy = false;  // FIFO load still queued
+static void (*spiDoneCallback)(uint8_t op) = NULL;
+
+// 💾 Registers only this driver changes
+static bool cacheable(uint8_t reg) {
+  switch (reg) {
+    case SX1276_REG_OP_MODE:
+    case SX1276_REG_FRF_MSB:
+    case SX1276_REG_FRF_MSB + 1:
+    case SX1276_REG_FRF_MSB + 2:
+    case SX1276_REG_PA_CONFIG:
+    case SX1276_REG_OCP:
+    case SX1276_REG_LNA:
+    case SX1276_REG_FIFO_TX_BASE_ADDR:
+    case SX1276_REG_FIFO_RX_BASE_ADDR:
+    case SX1276_REG_MODEM_CONFIG_1:
+    case SX1276_REG_MODEM_CONFIG_2:
+    case SX1276_REG_PREAMBLE_MSB:
+    case SX1276_REG_PREAMBLE_MSB + 1:
+    case SX1276_REG_PAYLOAD_LENGTH:
+    case SX1276_REG_MODEM_CONFIG_3:
+    case SX1276_REG_DETECTION_OPTIMIZE:
+    case SX1276_REG_DETECTION_THRESHOLD:
+    case SX1276_REG_SYNC_WORD:
+    case SX1276_REG_DIO_MAPPING_1:
+    case SX1276_REG_PA_DAC:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool isCached(uint8_t reg) {
+  return cacheValid[reg / 8] & (1u << (reg % 8));
+}
+
+static void remember(uint8_t reg, uint8_t value) {
+  if (!cacheable(reg))
+    return;
+  cache[reg] = value;
+  cacheValid[reg / 8] |= (uint8_t)(1u << (reg % 8));
+}
+
+static void forget(uint8_t reg) {
+  cacheValid[reg / 8] &= (uint8_t) ~(1u << (reg % 8));
+}
+
+static void count(size_t dataBytes) {
+  stats.transactions++;
+  stats.bytes += (uint32_t)(1 + dataBytes);
+}
+
+// ⚡ Collect one finished transaction (wait = block until the bus gets there)
+static bool reapOne(bool wait) {
+  if (!inFlight)
+    return false;
+  spi_transaction_t* t;
+  if (spi_device_get_trans_result(spiDevice, &t, wait ? portMAX_DELAY : 0) != ESP_OK)
+    return false;
+  inFlight--;
+  if (((QueuedTransfer*)t->user)->op == SX1276_OP_TX_LOADED)
+    txBufferBusy = false;
+  return true;
+}
+
+static void drainQueue() {
+  while (reapOne(true)) {
+  }
+}
+
+// 🔌 One transaction — address byte, then len bytes out of tx (zeros if NULL)
+// and, when rx is set, in — finished before returning
+static void transferNow(uint8_t addr, const uint8_t* tx, uint8_t* rx, size_t len) {
+  uint32_t startUs = micros();
+  if (dma) {
+    drainQueue();  // IDF: no polling while queued transactions are pending
+    spi_transaction_t t = {};
+    t.addr = addr;
+    t.length = len * 8;
+    t.tx_buffer = tx;
+    t.rx_buffer = rx;
+    spi_device_polling_transmit(spiDevice, &t);
+  } else {
+    SPI.beginTransaction(spiSettings);
+    digitalWrite(csPin, LOW);
+    SPI.transfer(addr);
+    if (rx) {
+      if (tx)
+        memcpy(rx, tx, len);
+      else
+        memset(rx, 0, len);
+      SPI.transfer(rx, len);  // In place: tx out, chip bytes in
+    } else {
+      SPI.writeBytes(tx, len);
+    }
+    digitalWrite(csPin, HIGH);
+    SPI.endTransaction();
+  }
+  stats.blockedUs += micros() - startUs;
+  count(len);
+}
+
+// ⚡ Hand a transaction to DMA and return; tx / rx must stay valid until it is
+// reaped (≤ 4 bytes out are copied). Polled backend: plain transferNow().
+static void transferQueued(uint8_t addr, const uint8_t* tx, uint8_t* rx, size_t len, uint8_t op) {
+  if (!dma) {
+    transferNow(addr, tx, rx, len);
+    return;
+  }
+  while (reapOne(false)) {
+  }
+  if (inFlight == SX1276_QUEUE_DEPTH) {
+    uint32_t startUs = micros();
+    reapOne(true);
+    stats.blockedUs += micros() - startUs;
+  }
+  QueuedTransfer& q = queue[queueNext];
+  queueNext = (queueNext + 1) % SX1276_QUEUE_DEPTH;
+  memset(&q.t, 0, sizeof(q.t));
+  q.op = op;
+  q.t.user = &q;
+  q.t.addr = addr;
+  q.t.length = len * 8;
+  if (tx && !rx && len <= sizeof(q.t.tx_data)) {
+    q.t.flags = SPI_TRANS_USE_TXDATA;
+    memcpy(q.t.tx_data, tx, len);
+  } else {
+    q.t.tx_buffer = tx;
+    q.t.rx_buffer = rx;
+  }
+  spi_device_queue_trans(spiDevice, &q.t, portMAX_DELAY);
+  inFlight++;
+  count(len);
+  stats.queued++;
+  stats.queuedBytes += (uint32_t)(1 + len);
+}
+
+// ⚡ spi_master post-transaction callback (ISR context)
+static void IRAM_ATTR onTransferDone(spi_transaction_t* t) {
+  const QueuedTransfer* q = (const QueuedTransfer*)t->user;
+  if (q && q->op && spiDoneCallback)
+    spiDoneCallback(q->op);
+}
+
+uint8_t sx1276ReadReg(uint8_t reg) {
+  uint8_t value;
+  transferNow(reg & 0x7F, NULL, &value, 1);
+  remember(reg, value);
+  return value;
+}
+
+// 💾 Cached copy when there is one (read-modify-write without the read)
+static uint8_t regValue(uint8_t reg) {
+  return isCached(reg) ? cache[reg] : sx1276ReadReg(reg);
+}
+
+// ✍️ Consecutive registers in one burst — skipped when all of them already hold the values
+static void writeRegs(uint8_t reg, const uint8_t* values, size_t n) {
+  bool same = true;
+  for (size_t i = 0; i < n && same; i++)
+    same = isCached(reg + i) && cache[reg + i] == values[i];
+  if (same) {
+    stats.writesSkipped++;
+    return;
+  }
+  transferQueued(reg | 0x80, values, NULL, n, 0);
+  for (size_t i = 0; i < n; i++)
+    remember(reg + i, values[i]);
+}
+
+void sx1276WriteReg(uint8_t reg, uint8_t value) {
+  writeRegs(reg, &value, 1);
+}
+
+static void setOpMode(uint8_t mode) {
+  sx1276WriteReg(SX1276_REG_OP_MODE, SX1276_MODE_LONG_RANGE | mode);
+}
+
+static void setHeaderMode(bool implicitHeader) {
+  uint8_t mc1 = regValue(SX1276_REG_MODEM_CONFIG_1);
+  sx1276WriteReg(SX1276_REG_MODEM_CONFIG_1, implicitHeader ? (mc1 | 0x01) : (mc1 & 0xFE));
+}
+
+static void resetChip(int8_t resetPin) {
+  if (dma)
+    drainQueue();  // Nothing half-written into the chip being reset
+  if (resetPin >= 0) {  // 🔄 Same pulse as LoRa.begin()
+    pinMode(resetPin, OUTPUT);
+    digitalWrite(resetPin, LOW);
+    delay(10);
+    digitalWrite(resetPin, HIGH);
+    delay(10);
+  }
+  memset(cacheValid, 0, sizeof(cacheValid));  // Chip reset: nothing known
+}
+
+// Probe, then LoRa mode, standby
+static bool initChip() {
+  if (sx1276ReadReg(SX1276_REG_VERSION) != SX1276_VERSION)
+    return false;
+
+  sx1276WriteReg(SX1276_REG_OP_MODE, SX1276_MODE_LONG_RANGE | SX1276_MODE_SLEEP);  // LoRa bit only sets in sleep
+  const uint8_t bases[2] = {SX1276_TX_BASE, SX1276_RX_BASE};
+  writeRegs(SX1276_REG_FIFO_TX_BASE_ADDR, bases, 2);
+  sx1276WriteReg(SX1276_REG_LNA, regValue(SX1276_REG_LNA) | 0x03);  // LNA boost
+  sx1276WriteReg(SX1276_REG_MODEM_CONFIG_3, 0x04);                  // AGC auto
+  setOpMode(SX1276_MODE_STDBY);
+  return true;
+}
+
+bool sx1276Begin(uint8_t cs, int8_t resetPin) {
+  resetChip(resetPin);
+  dma = false;
+  csPin = cs;
+  pinMode(csPin, OUTPUT);
+  digitalWrite(csPin, HIGH);
+  SPI.begin();
+  return initChip();
+}
+
+bool sx1276BeginDma(uint8_t cs, int8_t resetPin, uint8_t sck, uint8_t miso, uint8_t mosi) {
+  resetChip(resetPin);
+  if (!spiDevice) {
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = mosi;
+    bus.miso_io_num = miso;
+    bus.sclk_io_num = sck;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = sizeof(txBuffer) + 1;
+    spi_device_interface_config_t device = {};
+    device.address_bits = 8;  // Register address (bit 7 = write), then data
+    device.mode = 0;
+    device.clock_speed_hz = SX1276_SPI_HZ;
+    device.spics_io_num = cs;
+    device.queue_size = SX1276_QUEUE_DEPTH;
+    device.post_cb = onTransferDone;
+    if (spi_bus_initialize(SPI3_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK ||
+        spi_bus_add_device(SPI3_HOST, &device, &spiDevice) != ESP_OK) {
+      spiDevice = NULL;
+      return false;
+    }
+  }
+  dma = true;
+  csPin = cs;
+  queueNext = 0;
+  txBufferBusy = false;
+  return initChip();
+}
+
+// 🐢 Low data rate optimize: required once a symbol lasts over 16 ms
+static void updateLdo() {
+  bool ldo = (1000L << spreadingFactor) / bandwidthHz > 16;
+  uint8_t mc3 = regValue(SX1276_REG_MODEM_CONFIG_3);
+  sx1276WriteReg(SX1276_REG_MODEM_CONFIG_3, ldo ? (mc3 | 0x08) : (mc3 & (uint8_t)~0x08));
+}
+
+static uint8_t clampSf(uint8_t sf) {
+  return sf < 6 ? 6 : (sf > 12 ? 12 : sf);
+}
+
+// SF6 needs its own detection settings
+static void setDetection(uint8_t sf) {
+  sx1276WriteReg(SX1276_REG_DETECTION_OPTIMIZE, sf == 6 ? 0xC5 : 0xC3);
+  sx1276WriteReg(SX1276_REG_DETECTION_THRESHOLD, sf == 6 ? 0x0C : 0x0A);
+}
+
+void sx1276SetSpreadingFactor(uint8_t sf) {
+  sf = clampSf(sf);
+  setDetection(sf);
+  uint8_t mc2 = regValue(SX1276_REG_MODEM_CONFIG_2);
+  sx1276WriteReg(SX1276_REG_MODEM_CONFIG_2, (uint8_t)((mc2 & 0x0F) | (sf << 4)));
+  spreadingFactor = sf;
+  updateLdo();
+}
+
+static uint8_t bandwidthIndex(long hz) {
+  static const long steps[] = {7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000};
+  for (uint8_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+    if (hz <= steps[i])
+      return i;
+  }
+  return 9;  // 500 kHz
+}
+
+void sx1276SetBandwidth(long hz) {
+  uint8_t mc1 = regValue(SX1276_REG_MODEM_CONFIG_1);
+  sx1276WriteReg(SX1276_REG_MODEM_CONFIG_1, (uint8_t)((mc1 & 0x0F) | (bandwidthIndex(hz) << 4)));
+  bandwidthHz = hz;
+  updateLdo();
+}
+
+// 📶 PA_BOOST output (TTGO), same limits and over-current trim as LoRa.setTxPower()
+void sx1276SetTxPower(int8_t dbm) {
+  uint8_t paDac = 0x84;
+  uint8_t ocpTrim = (100 - 45) / 5;  // 100 mA
+  if (dbm > 17) {
+    if (dbm > 20)
+      dbm = 20;
+    dbm -= 3;  // High-power DAC adds 3 dB
+    paDac = 0x87;
+    ocpTrim = (140 + 30) / 10;  // 140 mA
+  } else if (dbm < 2) {
+    dbm = 2;
+  }
+  sx1276WriteReg(SX1276_REG_PA_DAC, paDac);
+  sx1276WriteReg(SX1276_REG_OCP, (uint8_t)(0x20 | (0x1F & ocpTrim)));
+  sx1276WriteReg(SX1276_REG_PA_CONFIG, (uint8_t)(0x80 | (dbm - 2)));
+}
+
+void sx1276Configure(const Sx1276Config& c) {
+  frequencyHz = c.frequencyHz;
+  uint64_t frf = ((uint64_t)c.frequencyHz << 19) / 32000000;
+  const uint8_t f[3] = {(uint8_t)(frf >> 16), (uint8_t)(frf >> 8), (uint8_t)frf};
+  writeRegs(SX1276_REG_FRF_MSB, f, 3);
+
+  // MODEM_CONFIG_1 / 2 composed whole, one burst: bandwidth | coding rate | header mode, SF | CRC | timeout MSB
+  spreadingFactor = clampSf(c.spreadingFactor);
+  bandwidthHz = c.bandwidthHz;
+  uint8_t cr = c.codingRate4 < 5 ? 5 : (c.codingRate4 > 8 ? 8 : c.codingRate4);
+  const uint8_t modem[2] = {
+      (uint8_t)((bandwidthIndex(bandwidthHz) << 4) | ((cr - 4) << 1) | (regValue(SX1276_REG_MODEM_CONFIG_1) & 0x01)),
+      (uint8_t)((spreadingFactor << 4) | (c.crc ? 0x04 : 0) | (regValue(SX1276_REG_MODEM_CONFIG_2) & 0x03))};
+  writeRegs(SX1276_REG_MODEM_CONFIG_1, modem, 2);
+  setDetection(spreadingFactor);
+  updateLdo();
+
+  const uint8_t preamble[2] = {(uint8_t)(c.preamble >> 8), (uint8_t)c.preamble};
+  writeRegs(SX1276_REG_PREAMBLE_MSB, preamble, 2);
+  sx1276WriteReg(SX1276_REG_SYNC_WORD, c.syncWord);
+  sx1276SetTxPower(c.txPowerDbm);
+}
+
+void sx1276Standby() {
+  setOpMode(SX1276_MODE_STDBY);
+}
+
+void sx1276Receive(uint8_t implicitLen) {
+  setHeaderMode(implicitLen > 0);
+  if (implicitLen)
+    sx1276WriteReg(SX1276_REG_PAYLOAD_LENGTH, implicitLen);
+  sx1276WriteReg(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_RX_DONE);
+  setOpMode(SX1276_MODE_RX_CONT);
+}
+
+void sx1276Transmit(const uint8_t* frame, size_t len, const uint8_t* tail, size_t tailLen, bool implicitHeader) {
+  setOpMode(SX1276_MODE_STDBY);  // The FIFO only fills in standby
+  setHeaderMode(implicitHeader);
+  sx1276WriteReg(SX1276_REG_PAYLOAD_LENGTH, (uint8_t)(len + tailLen));
+
+  const uint8_t base = SX1276_TX_BASE;  // Pointer moves with every FIFO access: never cached
+  transferQueued(SX1276_REG_FIFO_ADDR_PTR | 0x80, &base, NULL, 1, 0);
+
+  if (len + tailLen > sizeof(txBuffer))
+    len = sizeof(txBuffer) - tailLen;
+  while (txBufferBusy)
+    reapOne(true);  // Previous frame still on its way into the FIFO
+  memcpy(txBuffer, frame, len);
+  if (tailLen)
+    memcpy(txBuffer + len, tail, tailLen);
+  transferQueued(SX1276_REG_FIFO | 0x80, txBuffer, NULL, len + tailLen, 0);  // 📦 Whole frame in one burst
+  stats.fifoBursts++;
+
+  sx1276WriteReg(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_TX_DONE);
+  const uint8_t tx = SX1276_MODE_LONG_RANGE | SX1276_MODE_TX;
+  transferQueued(SX1276_REG_OP_MODE | 0x80, &tx, NULL, 1, SX1276_OP_TX_LOADED);
+  txBufferBusy = dma;
+  forget(SX1276_REG_OP_MODE);  // Back to standby by itself at TX done
+}
+
+void sx1276StartCad() {
+  setOpMode(SX1276_MODE_STDBY);
+  sx1276WriteReg(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_CAD_DONE);
+  setOpMode(SX1276_MODE_CAD);
+  forget(SX1276_REG_OP_MODE);  // Back to standby by itself at CAD done
+}
+
+bool sx1276ReadPacket(uint8_t* out, size_t len) {
+  transferQueued(SX1276_REG_FIFO, NULL, out, len, 0);
+  stats.fifoBursts++;
+  transferQueued(SX1276_REG_PKT_SNR_VALUE, NULL, pktStatus, sizeof(pktStatus), SX1276_OP_RX_READ);
+  return !dma;
+}
+
+void sx1276PacketStatus(int16_t* rssi, float* snr) {
+  *snr = (int8_t)pktStatus[0] * 0.25f;
+  *rssi = (int16_t)(pktStatus[1] - (frequencyHz < 525000000L ? 164 : 157));  // LF / HF port offset
+}
+
+void sx1276AttachDio0(uint8_t pin, void (*isr)()) {
+  pinMode(pin, INPUT);
+  attachInterrupt(digitalPinToInterrupt(pin), isr, RISING);
+}
+
+// ⚡ What the library's DIO0 ISR does, from LoRaTask: one burst read of
+// FIFO_RX_CURRENT_ADDR … RX_NB_BYTES, flags cleared, FIFO pointed at a good frame
+uint8_t sx1276ServiceDio0(uint8_t* rxLen) {
+  uint8_t r[4];  // FIFO_RX_CURRENT_ADDR, IRQ_FLAGS_MASK, IRQ_FLAGS, RX_NB_BYTES
+  transferNow(SX1276_REG_FIFO_RX_CURRENT_ADDR, NULL, r, sizeof(r));
+  uint8_t flags = r[2];
+  if (flags)
+    transferQueued(SX1276_REG_IRQ_FLAGS | 0x80, &flags, NULL, 1, 0);  // Write 1 to clear
+  *rxLen = 0;
+  if ((flags & (SX1276_IRQ_RX_DONE | SX1276_IRQ_CRC_ERROR)) == SX1276_IRQ_RX_DONE) {
+    bool implicitHeader = regValue(SX1276_REG_MODEM_CONFIG_1) & 0x01;
+    *rxLen = implicitHeader ? regValue(SX1276_REG_PAYLOAD_LENGTH) : r[3];
+    transferQueued(SX1276_REG_FIFO_ADDR_PTR | 0x80, &r[0], NULL, 1, 0);
+  }
+  return flags;
+}
+
+void sx1276OnSpiDone(void (*callback)(uint8_t op)) {
+  spiDoneCallback = callback;
+}
+
+void sx1276Flush() {
+  uint32_t startUs = micros();
+  drainQueue();
+  stats.blockedUs += micros() - startUs;
+}
+
+const Sx1276Stats& sx1276Stats() {
+  return stats;
+}
+
+void sx1276ResetStats() {
+  stats = Sx1276Stats();
+}
@@ -0,0 +1,45 @@
+#include "TelemetryRing.h"
+
+#include <atomic>
+
+static_assert((TLM_RING_SIZE & (TLM_RING_SIZE - 1)) == 0, "TLM_RING_SIZE must be a power of two");
+static_assert(PROTO_RX_BUF_SIZE >= PROTO_TLM_PACKET_SIZE, "RX buffer must hold a telemetry packet");
+
+static TlmRxEntry ring[TLM_RING_SIZE];
+static std::atomic<uint32_t> head(0);  // Next slot to fill (producer)
+static std::atomic<uint32_t> tail(0);  // Oldest unread slot (consumer)
+static std::atomic<uint32_t> dropped(0);
+
+TlmRxEntry* tlmRingReserve() {
+  uint32_t h = head.load(std::memory_order_relaxed);
+  if (h - tail.load(std::memory_order_acquire) >= TLM_RING_SIZE) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;  // ⚠️ Consumer fell behind — keep the older frames
+  }
+  return &ring[h & (TLM_RING_SIZE - 1)];
+}
+
+void tlmRingCommit() {
+  head.fetch_add(1, std::memory_order_release);
+}
+
+const TlmRxEntry* tlmRingPeek() {
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  if (t == head.load(std::memory_order_acquire))
+    return nullptr;
+  return &ring[t & (TLM_RING_SIZE - 1)];
+}
+
+void tlmRingPop() {
+  tail.fetch_add(1, std::memory_order_release);
+}
+
+void tlmRingReset() {
+  head.store(0);
+  tail.store(0);
+  dropped.store(0);
+}
+
+uint32_t tlmRingDropped() {
+  return dropped.load(std::memory_order_relaxed);
+}
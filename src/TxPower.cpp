@@ -0,0 +1,115 @@
+#include "TxPower.h"
+
+#include <Arduino.h>
+#include <math.h>
+
+// Owned by LoRaTask
+static bool control = TX_POWER_CONTROL;
+static int8_t current = TX_POWER_MAX_DBM;
+static int pending = -1;  // Decided, radio not set yet
+static float marginEwma = 0.0f;
+static bool haveMargin = false;
+static uint16_t aboveBand = 0;   // Samples above the band at this level
+static uint8_t unanswered = 0;  // Uplink frames since the last telemetry
+static TxPowerStats stats;
+
+void txPowerReset() {
+  current = TX_POWER_MAX_DBM;
+  pending = -1;
+  haveMargin = false;
+  aboveBand = 0;
+  unanswered = 0;
+  stats = TxPowerStats();
+  stats.minDbm = current;
+}
+
+void txPowerSetControl(bool on) {
+  control = on;
+  if (!on && current != TX_POWER_MAX_DBM)
+    pending = TX_POWER_MAX_DBM;  // Back to the fixed setting
+}
+
+bool txPowerControl() {
+  return control;
+}
+
+void txPowerOnTelemetry(int16_t rssi, int airRssi, float sensitivityDbm) {
+  stats.samples++;
+  unanswered = 0;
+
+  float margin = rssi + (current - PROTO_LORA_TX_POWER) - sensitivityDbm;  // Reciprocal path
+  if (airRssi < 0 && airRssi - sensitivityDbm < margin)
+    margin = airRssi - sensitivityDbm;
+  marginEwma = haveMargin ? marginEwma + TX_POWER_EWMA_ALPHA * (margin - marginEwma) : margin;
+  haveMargin = true;
+
+  if (!control || pending >= 0)
+    return;
+  if (marginEwma < TX_POWER_TARGET_MARGIN_DB) {
+    aboveBand = 0;
+    if (current < TX_POWER_MAX_DBM) {
+      pending = current + TX_POWER_STEP_DB > TX_POWER_MAX_DBM ? TX_POWER_MAX_DBM : current + TX_POWER_STEP_DB;
+      stats.stepsUp++;
+    }
+  } else if (marginEwma >= TX_POWER_TARGET_MARGIN_DB + TX_POWER_HYSTERESIS_DB) {
+    if (++aboveBand >= TX_POWER_DOWN_FRAMES && current > TX_POWER_MIN_DBM) {
+      pending = current - TX_POWER_STEP_DB < TX_POWER_MIN_DBM ? TX_POWER_MIN_DBM : current - TX_POWER_STEP_DB;
+      stats.stepsDown++;
+    }
+  } else {
+    aboveBand = 0;
+  }
+}
+
+void txPowerOnUplink() {
+  stats.frames++;
+  stats.mwSum += powf(10.0f, current / 10.0f);
+
+  // 🚨 The frame just sent is still waiting for its answer; the ones before it are lost
+  if (++unanswered > TX_POWER_LOSS_BURST && control && current < TX_POWER_MAX_DBM && pending != TX_POWER_MAX_DBM) {
+    pending = TX_POWER_MAX_DBM;
+    haveMargin = false;  // Samples from before the fade say nothing now
+    stats.clamps++;
+  }
+}
+
+int txPowerPendingDbm() {
+  return pending;
+}
+
+void txPowerApplied() {
+  if (pending < 0)
+    return;
+  if (haveMargin)
+    marginEwma += pending - current;  // Same path, more / less power behind it
+  current = (int8_t)pending;
+  pending = -1;
+  aboveBand = 0;
+  if (current < stats.minDbm)
+    stats.minDbm = current;
+}
+
+int8_t txPowerDbm() {
+  return current;
+}
+
+int txPowerHeadroomDb() {
+  return TX_POWER_MAX_DBM - current;
+}
+
+float txPowerMarginDb() {
+  return haveMargin ? marginEwma : 0.0f;
+}
+
+const TxPowerStats& txPowerStats() {
+  return stats;
+}
+
+void txPowerPrintReport() {
+  if (!control)
+    return;
+  float meanMw = stats.frames ? stats.mwSum / stats.frames : 0.0f;
+  Serial.printf("🔋 TX power: %d dBm (min %d), uplink margin %.1f dB, mean %.1f mW | %lu down, %lu up, %lu clamps\n",
+                (int)current, (int)stats.minDbm, txPowerMarginDb(), meanMw, (unsigned long)stats.stepsDown,
+                (unsigned long)stats.stepsUp, (unsigned long)stats.clamps);
+}
@@ -1,4 +1,14 @@
 #include "main.h"
+#include "Airtime.h"
+#include "DataRate.h"
+#include "Latency.h"
+#include "LinkQuality.h"
+#include "RadioState.h"
+#include "ReliableQueue.h"
+#include "SX1276.h"
+#include "TxPower.h"
+#include "TxScheduler.h"
+#include "protocol_implicit.h"
 
 // Display (TTGO LoRa32 V2.1 built-in OLED)
 SSD1306Wire ui(0x3c, SDA_PIN, SCL_PIN);
@@ -6,10 +16,9 @@ OLEDDisplayUi display(&ui);
 
 // This array keeps function pointers to all frames
 // frames are the single views that slide in
-FrameCallback frames[] = {drawFrame1};
+FrameCallback frames[] = {drawFrame1, drawFrame2, drawFrame3};
 
 bool setToZeroEngineSlider = false;
-bool isEmergencyStopEnabled = true;
 
 // Task handles
 static TaskHandle_t displayTaskHandle = NULL;
@@ -20,6 +29,8 @@ void setup() {
 
   pinMode(BUILTIN_LED, OUTPUT);
 
+  controlInit();  // 🚨 Safe defaults (STOP, sticks centered) before any task reads them
+
   // Set LoRa pins (built-in SX1276 on TTGO LoRa32 V2.1)
   LoRa.setPins(LORA_CS, LORA_RST, LORA_DIO0);
 
@@ -29,15 +40,15 @@ void setup() {
   setupPS5();    // 🎮
   setupRadio();  // 📡
 
-  // � LoRa task — Core 1, priority 2 (higher than display, preempts for timely TX/RX)
+  // 📡 LoRa task — Core 1, priority 2 (higher than display, preempts for timely TX/RX)
+  // Sleeps until the TX timer or DIO0 notifies it (no more 1 ms polling)
   xTaskCreatePinnedToCore(
       [](void* pvParameters) {
-        TickType_t xLastWakeTime = xTaskGetTickCount();
-        while (true) {         
-            checkPS5Connection();  // 🎮 Detect PS5 disconnect (library callback unreliable)         
-            if (ps5.isConnected())
-              loraLoop();
-          vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(1));
+        while (true) {
+          ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // 💤 TX tick, TX done or RX done
+          checkPS5Connection();  // 🎮 Detect PS5 disconnect (library callback unreliable)
+          if (ps5.isConnected())
+            loraLoop();
         }
       },
       "LoRaTask",
@@ -47,12 +58,15 @@ void setup() {
       &loraTaskHandle,
       1  // Core 1
   );
+  loraStartScheduler(loraTaskHandle);  // ⏰ PROTO_CMD_INTERVAL_MS timer + DIO0 TX/RX done
   Serial.println(F("✅ LoRaTask created on Core 1 (priority 2)"));
 
   // 🖥️ Display task — Core 1, priority 1 (yields to LoRa when it needs the CPU)
   xTaskCreatePinnedToCore(
       [](void* pvParameters) {
+        uint8_t shownPage = 0;
         while (true) {
+          hudServicePaging(display, shownPage);  // ⚙️ Only this task touches the OLED UI
           int remaining = display.update();
           if (remaining > 1) {
             vTaskDelay(pdMS_TO_TICKS(remaining));
@@ -75,14 +89,40 @@ void loop() {
   // 🎚️ Engine slider (ADC) + PS5 R2 trigger — take the higher value
   int sliderValue = analogRead(sliderPin);
   int ps5Throttle = ps5.isConnected() ? (int)map(ps5.R2Value(), 0, 255, 0, PROTO_ENGINE_RAW_MAX) : 0;
-  sendingEngineMessage = max(sliderValue, ps5Throttle);
+  int engine = max(sliderValue, ps5Throttle);
 
   // 🛡️ Safety: slider must start at zero before accepting throttle
-  if (!sendingEngineMessage)
+  if (!engine)
     setToZeroEngineSlider = true;
 
-  if (!setToZeroEngineSlider && sendingEngineMessage)
-    sendingEngineMessage = 0;  // 🚨 Force zero until slider zeroed
+  if (!setToZeroEngineSlider && engine)
+    engine = 0;  // 🚨 Force zero until slider zeroed
+
+  // 📤 Publish only on change — keeps seqlock readers from retrying at 100 Hz
+  static int publishedEngine = -1;
+  if (engine != publishedEngine) {
+    controlBeginWrite().engine = (uint16_t)engine;
+    controlEndWrite();
+    publishedEngine = engine;
+  }
+
+  // ⏱️ Periodic stick-to-air latency report
+  static unsigned long lastLatencyReportMs = 0;
+  if (millis() - lastLatencyReportMs >= LATENCY_REPORT_INTERVAL_MS) {
+    lastLatencyReportMs = millis();
+    latencyPrintReport();
+    txSchedulerPrintReport();  // ⏰ LoRaTask wakeups / CPU load / TX jitter
+    linkQualityPrintReport();  // 📶 Loss / bursts / jitter both ways
+    reliablePrintReport();     // 🔁 Discrete-command resends / acks
+    dataRatePrintReport();     // 📶 Profile / margin / switches
+    txPowerPrintReport();      // 🔋 Level / uplink margin / clamps
+  }
+
+  // 📄 'c' on Serial dumps every latency histogram (incl. round trip) as CSV
+  while (Serial.available()) {
+    if (Serial.read() == 'c')
+      latencyPrintCsv();
+  }
 
   vTaskDelay(pdMS_TO_TICKS(10));  // 100Hz ADC polling is plenty
 }
@@ -90,8 +130,11 @@ void loop() {
 void setupRadio() {
   Serial.print("📡 Initializing LoRa1276 (SX1276)... ");
 
-  // Initialize LoRa with frequency (from protocol.h)
-  if (!LoRa.begin(PROTO_LORA_FREQUENCY_HZ)) {
+  // Initialize LoRa with frequency (from protocol.h) — 🔌 or reset + probe it directly
+  bool found = radioSpiDma()      ? sx1276BeginDma(LORA_CS, LORA_RST, LORA_SCK, LORA_MISO, LORA_MOSI)
+               : radioDirectSpi() ? sx1276Begin(LORA_CS, LORA_RST)
+                                  : LoRa.begin(PROTO_LORA_FREQUENCY_HZ);
+  if (!found) {
     Serial.println("❌ LoRa init failed! Check wiring.");
     Serial.printf("   CS:   Pin %d\n", LORA_CS);
     Serial.printf("   RST:  Pin %d\n", LORA_RST);
@@ -101,17 +144,24 @@ void setupRadio() {
   }
 
   lora_initialized = true;
+  radioInit();  // 📡 DIO0 TX/RX done → radio state machine
 
   Serial.println("✅ LoRa init succeeded.");
 
   // Configure radio settings (parameters from shared protocol.h)
-  LoRa.setSpreadingFactor(PROTO_LORA_SF);
-  LoRa.setSignalBandwidth(PROTO_LORA_BANDWIDTH_HZ);
-  LoRa.setCodingRate4(PROTO_LORA_CR);
-  LoRa.setSyncWord(PROTO_LORA_SYNC_WORD);
-  LoRa.setTxPower(PROTO_LORA_TX_POWER);
-  LoRa.setPreambleLength(PROTO_LORA_PREAMBLE);
-  LoRa.enableCrc();
+  if (radioDirectSpi()) {
+    const Sx1276Config config = {PROTO_LORA_FREQUENCY_HZ, PROTO_LORA_SF,       PROTO_LORA_BANDWIDTH_HZ, PROTO_LORA_CR,
+                                 PROTO_LORA_PREAMBLE,     PROTO_LORA_SYNC_WORD, PROTO_LORA_TX_POWER,     true};
+    sx1276Configure(config);  // 🔌 Cached: only registers that change are written
+  } else {
+    LoRa.setSpreadingFactor(PROTO_LORA_SF);
+    LoRa.setSignalBandwidth(PROTO_LORA_BANDWIDTH_HZ);
+    LoRa.setCodingRate4(PROTO_LORA_CR);
+    LoRa.setSyncWord(PROTO_LORA_SYNC_WORD);
+    LoRa.setTxPower(PROTO_LORA_TX_POWER);
+    LoRa.setPreambleLength(PROTO_LORA_PREAMBLE);
+    LoRa.enableCrc();
+  }
 
   Serial.println();
   Serial.println("📡 LoRa Ground Station");
@@ -122,6 +172,11 @@ void setupRadio() {
   Serial.printf("   CR:         4/%d\n", PROTO_LORA_CR);
   Serial.printf("   Sync Word:  0x%02X\n", PROTO_LORA_SYNC_WORD);
   Serial.printf("   TX Power:   %d dBm\n", PROTO_LORA_TX_POWER);
+  Serial.printf("   Registers:  %s\n", radioSpiDma()      ? "direct SX1276, spi_master DMA queue"
+                                      : radioDirectSpi() ? "direct SX1276 (burst FIFO, cached config)"
+                                                         : "LoRa library");
+  Serial.printf("   Header:     %s (cmd frame %lu us)\n", radioImplicitHeader() ? "implicit" : "explicit",
+                (unsigned long)protoAirtimeUs(PROTO_CMD_PACKET_SIZE, radioImplicitHeader()));
   Serial.println();
 
   // Send initial test packet 🚀
@@ -130,6 +185,8 @@ void setupRadio() {
   initPkt.ailerons = 90;
   initPkt.rudder = 90;
   initPkt.elevators = 90;
+  if (radioImplicitHeader())
+    initPkt.flags = PROTO_FLAG_IMPLICIT_HDR;  // 📏 Same revision marker as every command
   initPkt.checksum = proto_checksum((const uint8_t*)&initPkt, PROTO_CMD_PACKET_SIZE - 1);
   LoRa_sendPacket((const uint8_t*)&initPkt, PROTO_CMD_PACKET_SIZE);
   Serial.println("✅ Initial packet sent");
@@ -185,3 +242,12 @@ void setupDisplay() {
   ui.setTextAlignment(TEXT_ALIGN_LEFT);  // ⬅️ Left align
   ui.setFont(ArialMT_Plain_10);          // 🔤 Set font
 }
+
+// ⚙️ One frame per Options press (ControlState.hudPageCount); DisplayTask only
+void hudServicePaging(OLEDDisplayUi& ui, uint8_t& shownPage) {
+  uint8_t page = controlSnapshot().hudPageCount;
+  if (page != shownPage) {
+    shownPage = page;
+    ui.nextFrame();
+  }
+}
@@ -0,0 +1,237 @@
+#include <unity.h>
+
+// ⚖️ Absolute trim tests + lossy session replay
+// The real notify() → LoRaTask path runs a trim-heavy session over a lossy
+// link to a simulated flight board, once with one-shot ±1 steps and once with
+// absolute trim, and compares the trim the aircraft ends up with.
+
+#include <LoRa.h>
+
+#include "PS5Joystick.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_delta.h"
+#include "protocol_trim.h"
+
+void setupRadio();
+void setupPS5();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+const ProtoCmdPacket& constructMessage(const ControlState& cs);
+void commandSetAbsoluteTrim(bool on);
+
+#define SESSION_MS 60000
+#define PRESS_EVERY_MS 300  // ⚖️ One D-pad / reset press
+#define LOSS_PERCENT 20
+
+static FakePs5Report idleReport() {
+  FakePs5Report r = {};
+  r.lx = -1;  // 127 after +128 offset → stick centered
+  r.rx = -1;
+  r.ry = -1;
+  return r;
+}
+
+// 🎮 One press: button down for one report, released on the next
+static void press(void (*hold)(FakePs5Report&)) {
+  FakePs5Report r = idleReport();
+  hold(r);
+  hal_advanceMillis(25);  // Past the 20 ms notify gate
+  ps5.injectReport(r);
+  hal_advanceMillis(25);
+  ps5.injectReport(idleReport());
+}
+
+// 🛩️ Flight-board trim, as it reads either encoding
+struct AirTrim {
+  int elevator;
+  int aileron;
+
+  void apply(const ProtoCmdPacket& p) {
+    if (p.flags & PROTO_FLAG_ABS_TRIM) {
+      elevator = p.elevatorTrim;
+      aileron = p.aileronTrim;
+      return;
+    }
+    if (p.flags & PROTO_FLAG_RESET_ELEV)
+      elevator = 0;
+    if (p.flags & PROTO_FLAG_RESET_AIL)
+      aileron = 0;
+    elevator = proto_trim_step((int8_t)elevator, p.elevatorTrim);
+    aileron = proto_trim_step((int8_t)aileron, p.aileronTrim);
+  }
+};
+
+struct SessionResult {
+  uint32_t frames;
+  uint32_t mismatchMs;  // Time the aircraft trim differed from the ground's (after the first frame)
+  int worstError;       // Largest |air − ground| steps seen
+  int finalError;
+};
+
+static void holdUp(FakePs5Report& r) { r.up = true; }
+static void holdDown(FakePs5Report& r) { r.down = true; }
+static void holdRight(FakePs5Report& r) { r.right = true; }
+static void holdLeft(FakePs5Report& r) { r.left = true; }
+static void holdR3(FakePs5Report& r) { r.r3 = true; }
+static void holdL3(FakePs5Report& r) { r.l3 = true; }
+
+// 📡 SESSION_MS of trim presses through notify() + LoRaTask, LOSS_PERCENT dropped
+static SessionResult runSession(bool absolute) {
+  static void (*const script[])(FakePs5Report&) = {holdUp,    holdUp,   holdUp, holdRight, holdUp, holdDown,
+                                                   holdLeft,  holdLeft, holdUp, holdR3,    holdUp, holdRight,
+                                                   holdRight, holdL3,   holdDown};
+  const size_t scriptLen = sizeof(script) / sizeof(script[0]);
+
+  commandSetAbsoluteTrim(absolute);
+  controlInit();
+  controlBeginWrite().ecoMode = true;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+  size_t seen = LoRa.sent.size();
+
+  SessionResult r = {};
+  AirTrim air = {};
+  bool airHeard = false;
+  uint32_t rng = 99;
+  size_t step = 0;
+  for (int ms = 0; ms < SESSION_MS; ms++) {
+    if (ms % PRESS_EVERY_MS == 0)
+      press(script[step++ % scriptLen]);  // Advances the clock by 50 ms
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+
+    for (; seen < LoRa.sent.size(); seen++) {
+      r.frames++;
+      rng = rng * 1103515245u + 12345u;
+      const FakeLoRaFrame& f = LoRa.sent[seen];
+      if ((rng >> 16) % 100 < LOSS_PERCENT || f.data[0] != PROTO_CMD_MAGIC)
+        continue;
+      air.apply(*(const ProtoCmdPacket*)f.data.data());
+      airHeard = true;
+    }
+
+    ControlState cs = controlSnapshot();
+    int err = abs(air.elevator - cs.elevatorTrim) + abs(air.aileron - cs.aileronTrim);
+    if (airHeard && err)
+      r.mismatchMs++;
+    if (err > r.worstError)
+      r.worstError = err;
+    r.finalError = err;
+  }
+  return r;
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  setupPS5();
+  ps5.setConnected(true);
+  ps5.injectReport(idleReport());
+}
+
+void tearDown(void) {
+  commandSetAbsoluteTrim(false);
+  ps5.setConnected(false);
+  Serial.muted = false;
+}
+
+// ✅ notify() keeps the absolute offset: steps add up, L3 / R3 zero it, clamped
+void test_notify_accumulates_absolute_trim() {
+  press(holdUp);
+  press(holdUp);
+  press(holdUp);
+  press(holdLeft);
+  ControlState cs = controlSnapshot();
+  TEST_ASSERT_EQUAL(3, cs.elevatorTrim);
+  TEST_ASSERT_EQUAL(-1, cs.aileronTrim);
+
+  press(holdR3);
+  cs = controlSnapshot();
+  TEST_ASSERT_EQUAL(0, cs.elevatorTrim);
+  TEST_ASSERT_EQUAL(-1, cs.aileronTrim);
+
+  for (int i = 0; i < PROTO_TRIM_ABS_MAX + 20; i++)
+    press(holdDown);
+  TEST_ASSERT_EQUAL(-PROTO_TRIM_ABS_MAX, controlSnapshot().elevatorTrim);
+}
+
+// ✅ Absolute frames restate the trim every time, never carry reset flags
+void test_absolute_frames_are_idempotent() {
+  commandSetAbsoluteTrim(true);
+  ControlState cs = controlSnapshot();
+  cs.elevatorTrim = 7;
+  cs.aileronTrim = -2;
+  cs.resetElevatorCount = 1;
+
+  ProtoCmdPacket a = constructMessage(cs);
+  ProtoCmdPacket b = constructMessage(cs);
+  TEST_ASSERT_EQUAL_MEMORY(&a, &b, PROTO_CMD_PACKET_SIZE);
+  TEST_ASSERT_EQUAL(7, a.elevatorTrim);
+  TEST_ASSERT_EQUAL(-2, a.aileronTrim);
+  TEST_ASSERT_EQUAL_HEX8(PROTO_FLAG_ABS_TRIM, a.flags);
+}
+
+// ✅ Delta frames inherit absolute trim from the keyframe (one-shot steps are not)
+void test_delta_inherits_absolute_trim() {
+  ControlState cs = controlSnapshot();
+  commandSetAbsoluteTrim(true);
+  cs.elevatorTrim = 5;
+  ProtoCmdPacket key = constructMessage(cs);
+  cs.aileron = 200;
+  ProtoCmdPacket cur = constructMessage(cs);
+
+  uint8_t frame[PROTO_DELTA_MAX_SIZE];
+  size_t len = proto_delta_encode(&key, &cur, frame);
+  TEST_ASSERT_EQUAL(0, frame[PROTO_DELTA_MASK_INDEX] & PROTO_DELTA_F_TRIM);
+  ProtoCmdPacket out;
+  TEST_ASSERT_TRUE(proto_delta_decode(&key, frame, len, &out));
+  TEST_ASSERT_EQUAL_MEMORY(&cur, &out, PROTO_CMD_PACKET_SIZE);
+  TEST_ASSERT_EQUAL(5, out.elevatorTrim);
+
+  cs.elevatorTrim = 0;  // Reset → trim group goes out with the new value
+  cur = constructMessage(cs);
+  len = proto_delta_encode(&key, &cur, frame);
+  TEST_ASSERT_EQUAL(PROTO_DELTA_F_TRIM, frame[PROTO_DELTA_MASK_INDEX] & PROTO_DELTA_F_TRIM);
+  TEST_ASSERT_TRUE(proto_delta_decode(&key, frame, len, &out));
+  TEST_ASSERT_EQUAL(0, out.elevatorTrim);
+}
+
+// 📊 Lossy replay: aircraft trim vs ground trim, one-shot steps vs absolute
+void test_lossy_session_replay() {
+  SessionResult steps = runSession(false);
+  SessionResult absolute = runSession(true);
+
+  char msg[256];
+  snprintf(msg, sizeof(msg),
+           "%d%% loss, %d s, press every %d ms | one-shot: %u frames, final error %d, worst %d, wrong %.1f%% of the time | "
+           "absolute: %u frames, final error %d, worst %d, wrong %.1f%%",
+           LOSS_PERCENT, SESSION_MS / 1000, PRESS_EVERY_MS, (unsigned)steps.frames, steps.finalError,
+           steps.worstError, steps.mismatchMs * 100.0 / SESSION_MS, (unsigned)absolute.frames, absolute.finalError,
+           absolute.worstError, absolute.mismatchMs * 100.0 / SESSION_MS);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_GREATER_THAN(0, steps.finalError);  // Lost steps never come back
+  TEST_ASSERT_EQUAL(0, absolute.finalError);
+  TEST_ASSERT_LESS_THAN(steps.mismatchMs, absolute.mismatchMs);
+  TEST_ASSERT_LESS_THAN(steps.worstError, absolute.worstError);  // Only presses still in flight
+  TEST_ASSERT_LESS_OR_EQUAL(steps.frames, absolute.frames);  // ECO still deduplicates
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_notify_accumulates_absolute_trim);
+  RUN_TEST(test_absolute_frames_are_idempotent);
+  RUN_TEST(test_delta_inherits_absolute_trim);
+  RUN_TEST(test_lossy_session_replay);
+
+  return UNITY_END();
+}
@@ -0,0 +1,255 @@
+#include <unity.h>
+
+// 🧺 Multi-sample command frame tests + control-rate-per-airtime benchmark
+// The real LoRaTask samples the sticks aggSamples× per command period; a
+// simulated flight board unpacks each frame and replays the samples at their
+// original spacing.
+
+#include <LoRa.h>
+
+#include <string.h>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "RateControl.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_aggregate.h"
+#include "protocol_trim.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+void commandAggregateSetSamples(uint8_t n);
+
+#define SIM_DURATION_MS 10000
+#define REPLAY_DELAY_US (PROTO_CMD_INTERVAL_MS * 1000UL)  // ≥ oldest sample age
+
+static ProtoCmdPacket makePacket(uint8_t ail, int8_t trim, uint8_t flags) {
+  ProtoCmdPacket p = {};
+  p.magic = PROTO_CMD_MAGIC;
+  p.engine = 100;
+  p.ailerons = ail;
+  p.rudder = 90;
+  p.elevators = 80;
+  p.elevatorTrim = trim;
+  p.flaps = 2;
+  p.flags = flags;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_CMD_PACKET_SIZE - 1);
+  return p;
+}
+
+// 🎮 Sticks sweep continuously: aileron changes every millisecond
+static void runSticks(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    ControlState& cs = controlBeginWrite();
+    cs.aileron = (uint8_t)(millis() % 200 + 28);
+    controlEndWrite();
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+}
+
+void tearDown(void) {
+  commandAggregateSetSamples(1);
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ Round trip: newest exact, older samples inherit state but not one-shots
+void test_encode_decode_round_trip() {
+  ProtoCmdPacket newest = makePacket(150, 1, PROTO_FLAG_RESET_ELEV | PROTO_FLAG_AIRBRAKE);
+  ProtoAggSample older[3] = {{38, 90, 100, 91, 92}, {25, 95, 110, 93, 94}, {13, 99, 120, 95, 96}};
+  uint8_t frame[PROTO_AGG_MAX_SIZE];
+  size_t len = proto_agg_encode(&newest, older, 3, frame);
+  TEST_ASSERT_EQUAL(PROTO_AGG_SIZE(4), len);
+
+  ProtoCmdPacket out[PROTO_AGG_MAX_SAMPLES];
+  uint8_t ages[PROTO_AGG_MAX_SAMPLES], n = 0;
+  TEST_ASSERT_TRUE(proto_agg_decode(frame, len, out, ages, &n));
+  TEST_ASSERT_EQUAL(4, n);
+  TEST_ASSERT_EQUAL_MEMORY(&newest, &out[3], PROTO_CMD_PACKET_SIZE);
+  TEST_ASSERT_EQUAL(0, ages[3]);
+  for (uint8_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL(older[i].ageMs, ages[i]);
+    TEST_ASSERT_EQUAL(older[i].ailerons, out[i].ailerons);
+    TEST_ASSERT_EQUAL(older[i].elevators, out[i].elevators);
+    TEST_ASSERT_EQUAL(2, out[i].flaps);
+    TEST_ASSERT_EQUAL_HEX8(PROTO_FLAG_AIRBRAKE, out[i].flags);  // Reset stays with the newest
+    TEST_ASSERT_EQUAL(0, out[i].elevatorTrim);                   // One trim step, applied once
+    TEST_ASSERT_EQUAL_HEX8(proto_checksum((const uint8_t*)&out[i], PROTO_CMD_PACKET_SIZE - 1), out[i].checksum);
+  }
+
+  newest = makePacket(150, 7, PROTO_FLAG_ABS_TRIM);  // Absolute trim is state: every sample keeps it
+  len = proto_agg_encode(&newest, older, 1, frame);
+  TEST_ASSERT_TRUE(proto_agg_decode(frame, len, out, ages, &n));
+  TEST_ASSERT_EQUAL(2, n);
+  TEST_ASSERT_EQUAL(7, out[0].elevatorTrim);
+
+  frame[3] ^= 1;
+  TEST_ASSERT_FALSE(proto_agg_decode(frame, len, out, ages, &n));  // Corrupted
+  TEST_ASSERT_FALSE(proto_agg_decode(frame, PROTO_CMD_PACKET_SIZE, out, ages, &n));
+}
+
+// ✅ Real LoRaTask: n samples per frame, evenly spaced, newest is the command itself
+void test_ground_sampling_cadence() {
+  commandAggregateSetSamples(4);
+  setupRadio();
+  loraStartScheduler(NULL);
+  size_t first = LoRa.sent.size();
+  runSticks(1000);
+
+  uint32_t frames = 0;
+  for (size_t i = first; i < LoRa.sent.size(); i++) {
+    const FakeLoRaFrame& f = LoRa.sent[i];
+    ProtoCmdPacket out[PROTO_AGG_MAX_SAMPLES];
+    uint8_t ages[PROTO_AGG_MAX_SAMPLES], n = 0;
+    TEST_ASSERT_EQUAL_HEX8(PROTO_AGG_MAGIC, f.data[0]);
+    TEST_ASSERT_TRUE(proto_agg_decode(f.data.data(), f.data.size(), out, ages, &n));
+    TEST_ASSERT_EQUAL(4, n);
+    const uint8_t step = PROTO_CMD_INTERVAL_MS / 4;
+    TEST_ASSERT_UINT32_WITHIN(1, 3 * step, ages[0]);
+    TEST_ASSERT_UINT32_WITHIN(1, 2 * step, ages[1]);
+    TEST_ASSERT_UINT32_WITHIN(1, step, ages[2]);
+    TEST_ASSERT_TRUE(out[0].ailerons <= out[1].ailerons && out[1].ailerons <= out[2].ailerons);  // Sweep order
+    frames++;
+  }
+  TEST_ASSERT_GREATER_THAN(15, frames);
+  TEST_ASSERT_EQUAL(3 * frames, radioStats().aggSamples);
+}
+
+// ✅ ECO: older samples go through the input filter like the command; floors sized for the whole frame
+void test_eco_samples_filtered_floor_sized() {
+  commandAggregateSetSamples(4);
+  controlBeginWrite().ecoMode = true;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+  TEST_ASSERT_GREATER_OR_EQUAL(PROTO_AGG_SIZE(4), loraCommandFrameMaxSize());
+  const uint32_t frameUs = tdmaCmdSlotUs(loraCommandFrameMaxSize(), false);
+  TEST_ASSERT_GREATER_OR_EQUAL((frameUs + LORA_AIRTIME_BUDGET_PERMILLE - 1) / LORA_AIRTIME_BUDGET_PERMILLE,
+                               rateControlFloorMs());
+#ifdef PROTO_BIDIRECTIONAL
+  TEST_ASSERT_GREATER_OR_EQUAL((frameUs + tdmaTlmSlotUs(false) + 999) / 1000, rateControlFloorMs());
+#endif
+
+  size_t first = LoRa.sent.size();
+  for (int t = 0; t < 1000; t++) {  // 🎮 Aileron held at 180 with ±1 of noise, elevator moving
+    hal_advanceMillis(1);
+    ControlState& cs = controlBeginWrite();
+    cs.aileron = (uint8_t)(179 + t % 3);
+    cs.elevators = (uint8_t)(millis() % 200 + 28);
+    controlEndWrite();
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+
+  uint32_t frames = 0;
+  for (size_t i = first; i < LoRa.sent.size(); i++) {
+    const FakeLoRaFrame& f = LoRa.sent[i];
+    ProtoCmdPacket out[PROTO_AGG_MAX_SAMPLES];
+    uint8_t ages[PROTO_AGG_MAX_SAMPLES], n = 0;
+    if (!proto_agg_decode(f.data.data(), f.data.size(), out, ages, &n))
+      continue;
+    for (uint8_t k = 0; k + 1 < n; k++)
+      TEST_ASSERT_EQUAL(out[n - 1].ailerons, out[k].ailerons);  // Noise quantized away in every sample
+    frames++;
+  }
+  TEST_ASSERT_GREATER_THAN(5, frames);
+}
+
+struct BenchResult {
+  uint32_t frames;
+  uint32_t updates;          // Stick samples the air side replays
+  uint32_t bytes;
+  uint32_t worstReplayGapUs; // Between consecutive replayed samples
+  double airMs[3];           // Total time on air at SF7 / SF10 / SF12
+};
+
+static const int benchSf[3] = {7, 10, 12};
+
+static BenchResult runBench(uint8_t n) {
+  commandAggregateSetSamples(n);
+  setupRadio();
+  loraStartScheduler(NULL);
+  size_t seen = LoRa.sent.size();
+  runSticks(200);  // Settle
+  seen = LoRa.sent.size();
+  runSticks(SIM_DURATION_MS);
+
+  BenchResult r = {};
+  unsigned long lastReplayUs = 0;
+  for (size_t i = seen; i < LoRa.sent.size(); i++) {
+    const FakeLoRaFrame& f = LoRa.sent[i];
+    ProtoCmdPacket out[PROTO_AGG_MAX_SAMPLES];
+    uint8_t ages[PROTO_AGG_MAX_SAMPLES], count = 1;
+    ages[0] = 0;
+    if (f.data[0] == PROTO_AGG_MAGIC)
+      TEST_ASSERT_TRUE(proto_agg_decode(f.data.data(), f.data.size(), out, ages, &count));
+    r.frames++;
+    r.updates += count;
+    r.bytes += f.data.size();
+    for (int s = 0; s < 3; s++)
+      r.airMs[s] += loraAirtimeUs(f.data.size(), benchSf[s], PROTO_LORA_BANDWIDTH_HZ, PROTO_LORA_CR,
+                                  PROTO_LORA_PREAMBLE) / 1000.0;
+    for (uint8_t k = 0; k < count; k++) {  // 🛩️ Replay at the original spacing, REPLAY_DELAY_US behind
+      unsigned long replayUs = f.atUs - ages[k] * 1000UL + REPLAY_DELAY_US;
+      if (lastReplayUs && replayUs - lastReplayUs > r.worstReplayGapUs)
+        r.worstReplayGapUs = replayUs - lastReplayUs;
+      lastReplayUs = replayUs;
+    }
+  }
+  return r;
+}
+
+// 📊 Effective control rate per unit of airtime, 1–4 samples per frame
+void test_control_rate_per_airtime() {
+  BenchResult base = {};
+  double lastPerAir[3] = {};
+  for (uint8_t n = 1; n <= PROTO_AGG_MAX_SAMPLES; n++) {
+    BenchResult r = runBench(n);
+    const double secs = SIM_DURATION_MS / 1000.0;
+    char msg[256];
+    snprintf(msg, sizeof(msg),
+             "n=%u: %.1f frames/s, %.1f updates/s, %.1f B/frame, replay gap <= %lu ms | updates per second of air: "
+             "SF7 %.0f, SF10 %.1f, SF12 %.1f",
+             (unsigned)n, r.frames / secs, r.updates / secs, (double)r.bytes / r.frames,
+             (unsigned long)(r.worstReplayGapUs / 1000), r.updates / (r.airMs[0] / 1000.0),
+             r.updates / (r.airMs[1] / 1000.0), r.updates / (r.airMs[2] / 1000.0));
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_UINT32_WITHIN(2 * n, n * r.frames, r.updates);
+    TEST_ASSERT_LESS_OR_EQUAL(PROTO_CMD_INTERVAL_MS * 1000UL / n + 1000, r.worstReplayGapUs);
+    if (n == 1) {
+      base = r;
+    } else {
+      TEST_ASSERT_UINT32_WITHIN(2, base.frames, r.frames);  // Same TX rate, more updates in each frame
+      for (int s = 0; s < 3; s++)
+        TEST_ASSERT_GREATER_THAN(lastPerAir[s], r.updates / r.airMs[s]);
+    }
+    for (int s = 0; s < 3; s++)
+      lastPerAir[s] = r.updates / r.airMs[s];
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_encode_decode_round_trip);
+  RUN_TEST(test_ground_sampling_cadence);
+  RUN_TEST(test_eco_samples_filtered_floor_sized);
+  RUN_TEST(test_control_rate_per_airtime);
+
+  return UNITY_END();
+}
@@ -0,0 +1,106 @@
+#include <unity.h>
+
+// 📒 LoRa time-on-air model + duty-cycle ledger
+// Reference values from the Semtech LoRa calculator (explicit header, CRC on).
+
+#include <LoRa.h>
+
+#include "Airtime.h"
+#include "Display.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+// ✅ Compile-time: the model folds to constants
+static_assert(loraAirtimeUs(10, 7, 125000, 5, 8) == 41216, "SF7/125k 10 B");
+static_assert(LORA_CMD_AIRTIME_US > 0 && LORA_TLM_AIRTIME_US >= LORA_CMD_AIRTIME_US, "protocol.h frames");
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  airtimeReset();
+}
+
+void tearDown(void) {
+  Serial.muted = false;
+}
+
+// ✅ Semtech formula at the corners: symbol time, LDRO, header / CRC terms
+void test_airtime_matches_semtech_calculator() {
+  TEST_ASSERT_EQUAL(1024, loraSymbolUs(7, 125000));
+  TEST_ASSERT_EQUAL(41216, loraAirtimeUs(10, 7, 125000, 5, 8));
+  TEST_ASSERT_EQUAL(20608, loraAirtimeUs(10, 7, 250000, 5, 8));
+  TEST_ASSERT_EQUAL(164864, loraAirtimeUs(14, 9, 125000, 5, 8));
+  TEST_ASSERT_TRUE(loraLowDataRate(12, 125000));
+  TEST_ASSERT_FALSE(loraLowDataRate(10, 125000));
+  TEST_ASSERT_EQUAL(991232, loraAirtimeUs(10, 12, 125000, 5, 8));   // LDRO on
+  TEST_ASSERT_EQUAL(53504, loraAirtimeUs(10, 7, 125000, 8, 8));     // CR 4/8
+  TEST_ASSERT_LESS_THAN(loraAirtimeUs(10, 7, 125000, 5, 8), loraAirtimeUs(10, 7, 125000, 5, 8, false, true));
+}
+
+// ✅ The ledger keeps a rolling second and forgets older buckets
+void test_ledger_rolls_over_one_second() {
+  airtimeRecord(10000);
+  hal_advanceMillis(500);
+  airtimeRecord(20000);
+  TEST_ASSERT_EQUAL(30000, airtimeUsedUs());
+  TEST_ASSERT_EQUAL(LORA_AIRTIME_BUDGET_US - 30000, airtimeRemainingUs());
+
+  hal_advanceMillis(600);  // First record is now > 1 s old
+  TEST_ASSERT_EQUAL(20000, airtimeUsedUs());
+
+  hal_advanceMillis(1000);
+  TEST_ASSERT_EQUAL(0, airtimeUsedUs());
+
+  for (int i = 0; i < 100; i++)
+    airtimeRecord(LORA_AIRTIME_BUDGET_US / 50);
+  TEST_ASSERT_EQUAL(0, airtimeRemainingUs());  // Over budget clamps at zero
+}
+
+// ✅ LoRa_sendPacket() books every command frame at the model's cost
+void test_send_path_books_airtime() {
+  setupRadio();
+  loraStartScheduler(NULL);
+  airtimeReset();
+  LoRa.reset();
+
+  for (int ms = 0; ms < 500; ms++) {  // Well inside the rolling second
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+
+  TEST_ASSERT_EQUAL(LoRa.sent.size() * LORA_CMD_AIRTIME_US, airtimeUsedUs());
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%u frames/500 ms x %u us = %u us of %u us/s budget", (unsigned)LoRa.sent.size(),
+           (unsigned)LORA_CMD_AIRTIME_US, (unsigned)airtimeUsedUs(), (unsigned)LORA_AIRTIME_BUDGET_US);
+  TEST_MESSAGE(msg);
+}
+
+// ✅ drawFrame2() shows the budget left
+void test_frame2_shows_budget() {
+  SSD1306Wire hud(0x3c);
+  OLEDDisplayUiState state;
+  airtimeRecord(LORA_AIRTIME_BUDGET_US / 4);
+  drawFrame2(&hud, &state, 0, 0);
+  TEST_ASSERT_TRUE(hud.hasText("Air:75%"));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_airtime_matches_semtech_calculator);
+  RUN_TEST(test_ledger_rolls_over_one_second);
+  RUN_TEST(test_send_path_books_airtime);
+  RUN_TEST(test_frame2_shows_budget);
+
+  return UNITY_END();
+}
@@ -0,0 +1,191 @@
+#include <unity.h>
+
+// 🔒 ControlState seqlock tests
+// Stress: two writers (BT notify() + loop() throttle) race two readers
+// (LoRaTask + DisplayTask) on real host threads; every snapshot must be
+// internally consistent.
+
+#include <LoRa.h>
+
+#include <atomic>
+#include <thread>
+
+#include "ControlState.h"
+#include "PS5Joystick.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void setupPS5();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#define STRESS_WRITES 200000
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  loraStartScheduler(NULL);  // ⏰ TX timer phase-locked to the test clock
+}
+
+void tearDown(void) {
+  Serial.muted = false;
+}
+
+// ✅ Power-on defaults: disarmed, sticks centered, ECO on
+void test_defaults() {
+  ControlState cs = controlSnapshot();
+  TEST_ASSERT_TRUE(cs.emergencyStop);
+  TEST_ASSERT_TRUE(cs.ecoMode);
+  TEST_ASSERT_EQUAL(127, cs.aileron);
+  TEST_ASSERT_EQUAL(127, cs.rudder);
+  TEST_ASSERT_EQUAL(127, cs.elevators);
+  TEST_ASSERT_EQUAL(0, cs.engine);
+}
+
+// ✅ Writes become visible only when the write window closes
+void test_publish_on_end_write() {
+  ControlState& w = controlBeginWrite();
+  w.aileron = 200;
+  w.flaps = 3;
+  TEST_ASSERT_EQUAL(127, controlSnapshot().aileron);  // Reader never blocks mid-write
+  controlEndWrite();
+
+  ControlState cs = controlSnapshot();
+  TEST_ASSERT_EQUAL(200, cs.aileron);
+  TEST_ASSERT_EQUAL(3, cs.flaps);
+}
+
+// 🧵 Two writers vs two readers — no torn snapshots
+void test_stress_consistent_snapshots() {
+  ControlState& prime = controlBeginWrite();  // k = 0 satisfies every invariant below
+  prime.aileron = prime.rudder = prime.elevators = prime.stabilityAssist = 0;
+  prime.elevatorTrim = 0;
+  prime.flightTimerStartMs = 0;
+  controlEndWrite();
+
+  std::atomic<bool> done(false);
+  std::atomic<uint32_t> torn(0);
+  std::atomic<uint32_t> reads(0);
+
+  auto reader = [&] {
+    uint32_t lastStamp = 0;
+    while (!done.load(std::memory_order_acquire)) {
+      ControlState cs = controlSnapshot();
+      uint8_t k = cs.aileron;
+      bool ok = cs.rudder == k && cs.elevators == k && cs.stabilityAssist == k &&
+                (uint8_t)cs.flightTimerStartMs == k && (uint8_t)cs.elevatorTrim == k &&
+                cs.airbrake == cs.acsEngage && cs.emergencyStop == !cs.airbrake &&
+                cs.flightTimerStartMs >= lastStamp;
+      if (!ok)
+        torn.fetch_add(1);
+      lastStamp = cs.flightTimerStartMs;
+      reads.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  std::thread r1(reader), r2(reader);
+  std::thread btWriter([] {  // notify(): sticks + trims + timer stamp
+    for (uint32_t k = 1; k <= STRESS_WRITES; k++) {
+      ControlState& cs = controlBeginWrite();
+      cs.aileron = cs.rudder = cs.elevators = cs.stabilityAssist = (uint8_t)k;
+      cs.elevatorTrim = (int8_t)k;
+      cs.flightTimerStartMs = k;
+      controlEndWrite();
+    }
+  });
+  std::thread loopWriter([] {  // loop(): throttle + paired flags
+    for (uint32_t j = 1; j <= STRESS_WRITES; j++) {
+      ControlState& cs = controlBeginWrite();
+      cs.engine = (uint16_t)(j & 0x0FFF);
+      cs.airbrake = cs.acsEngage = (j & 1);
+      cs.emergencyStop = !(j & 1);
+      controlEndWrite();
+    }
+  });
+
+  btWriter.join();
+  loopWriter.join();
+  done.store(true, std::memory_order_release);
+  r1.join();
+  r2.join();
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "reads=%u retries=%u torn=%u", (unsigned)reads.load(),
+           (unsigned)controlRetryCount(), (unsigned)torn.load());
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_EQUAL(0, torn.load());
+  TEST_ASSERT_GREATER_THAN(0, reads.load());
+  TEST_ASSERT_EQUAL(STRESS_WRITES, controlSnapshot().flightTimerStartMs);
+}
+
+// ✅ Trim presses go on air exactly once, without loraLoop() writing back
+void test_trim_step_sent_once() {
+  setupRadio();
+  LoRa.reset();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+
+  controlBeginWrite().elevatorTrim++;
+  controlEndWrite();
+
+  for (int ms = 0; ms < PROTO_CMD_INTERVAL_MS * 3; ms++) {
+    hal_advanceMillis(1);
+    loraLoop();
+  }
+
+  TEST_ASSERT_GREATER_OR_EQUAL(2, LoRa.sent.size());
+  const ProtoCmdPacket* first = (const ProtoCmdPacket*)LoRa.sent[0].data.data();
+  const ProtoCmdPacket* second = (const ProtoCmdPacket*)LoRa.sent[1].data.data();
+  TEST_ASSERT_EQUAL(1, first->elevatorTrim);
+  TEST_ASSERT_EQUAL(0, second->elevatorTrim);
+}
+
+// ✅ Held D-pad: one step per command period, nothing left over after release
+void test_held_dpad_one_step_per_packet() {
+  setupRadio();
+  setupPS5();
+  ps5.setConnected(true);
+  LoRa.reset();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+
+  FakePs5Report r = {};
+  r.lx = r.rx = r.ry = -1;  // Sticks centered
+  r.up = true;
+  for (int ms = 0; ms < 2000; ms++) {
+    if (ms == 1000)
+      r.up = false;  // Release
+    ps5.injectReport(r);  // notify() gates reports to ~20 ms
+    hal_advanceMillis(1);
+    loraLoop();
+  }
+
+  int onAir = 0, afterRelease = 0;
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    const ProtoCmdPacket* p = (const ProtoCmdPacket*)f.data.data();
+    onAir += p->elevatorTrim;
+    if (f.atMs > 1000 + 1000 + PROTO_CMD_INTERVAL_MS)
+      afterRelease += p->elevatorTrim;
+  }
+  const int held = controlSnapshot().elevatorTrim;
+  TEST_ASSERT_INT_WITHIN(1, 1000 / PROTO_CMD_INTERVAL_MS, held);
+  TEST_ASSERT_INT_WITHIN(2, held, onAir);  // Two steps inside one period: the packet carries one
+  TEST_ASSERT_EQUAL(0, afterRelease);
+  ps5.setConnected(false);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_defaults);
+  RUN_TEST(test_publish_on_end_write);
+  RUN_TEST(test_stress_consistent_snapshots);
+  RUN_TEST(test_trim_step_sent_once);
+  RUN_TEST(test_held_dpad_one_step_per_packet);
+
+  return UNITY_END();
+}
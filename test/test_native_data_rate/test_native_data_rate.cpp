@@ -0,0 +1,203 @@
+#include <unity.h>
+
+// 📶 Adaptive data rate (DataRate.h / protocol_rate.h) in the channel simulator
+// The real LoRaTask next to a simulated flight board running the
+// protocol_rate.h air side (ChannelSim.h): path loss, fading, SNR vs the
+// demodulator floor, RX tuned to one SF / bandwidth at a time.
+
+#include <ChannelSim.h>
+
+#include "DataRate.h"
+#include "ReliableQueue.h"
+#include "TxScheduler.h"
+#include "protocol.h"
+#include "protocol_rate.h"
+#include "protocol_reliable.h"
+
+void commandSetReliable(bool on);
+
+// ✅ Each step halves the symbol time and costs the sensitivity it should
+void test_profile_ladder() {
+  const ProtoRateProfile base = proto_rate_profile(0);
+  TEST_ASSERT_EQUAL(PROTO_LORA_SF, base.sf);
+  TEST_ASSERT_EQUAL(PROTO_LORA_BANDWIDTH_HZ, base.bandwidthHz);
+  const uint8_t n = proto_rate_profile_count();
+  TEST_ASSERT_GREATER_OR_EQUAL(2, n);
+  for (uint8_t k = 1; k < n; k++) {
+    const ProtoRateProfile a = proto_rate_profile(k - 1), b = proto_rate_profile(k);
+    TEST_ASSERT_EQUAL(loraSymbolUs(a.sf, a.bandwidthHz) / 2, loraSymbolUs(b.sf, b.bandwidthHz));
+    TEST_ASSERT_LESS_OR_EQUAL(PROTO_RATE_MAX_BW_HZ, b.bandwidthHz);
+    float cost = dataRateSensitivityDbm(b) - dataRateSensitivityDbm(a);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, b.sf != a.sf ? 2.5f : 3.0f, cost);
+  }
+  const ProtoRateProfile last = proto_rate_profile(n - 1), past = proto_rate_profile(n);
+  TEST_ASSERT_EQUAL(last.sf, past.sf);
+  TEST_ASSERT_EQUAL(last.bandwidthHz, past.bandwidthHz);
+}
+
+#ifdef PROTO_BIDIRECTIONAL  // Acks ride in telemetry
+// 🗓️ Longest TDMA frame on profile 0: a reliable command + the slot for trailered
+// telemetry, which may not fit inside PROTO_CMD_INTERVAL_MS
+static const unsigned long FRAME_GAP_US =
+    PROTO_CMD_INTERVAL_MS * 1000UL > protoAirtimeUs(PROTO_CMD_PACKET_SIZE + PROTO_REL_TRAILER_SIZE) + TDMA_TLM_SLOT_US
+        ? PROTO_CMD_INTERVAL_MS * 1000UL
+        : protoAirtimeUs(PROTO_CMD_PACKET_SIZE + PROTO_REL_TRAILER_SIZE) + TDMA_TLM_SLOT_US;
+
+void setUp(void) {
+  channelSimSetUp();
+  commandSetReliable(true);
+  dataRateSetAdaptive(true);
+}
+
+void tearDown(void) {
+  channelSimTearDown();
+  dataRateSetAdaptive(false);
+  commandSetReliable(false);
+}
+
+// ✅ Strong link: both ends climb to the fastest profile together, commands speed up
+void test_strong_link_steps_up() {
+  for (int direct = 0; direct < 2; direct++) {
+    startSession(direct);
+    pathLossDb = 80.0f;  // ~−63 dBm
+    runFor(1000);
+    const uint32_t slowHeard = sim.cmdHeard;
+    runFor(5000);
+
+    const uint8_t top = proto_rate_profile_count() - 1;
+    TEST_ASSERT_EQUAL(top, dataRateProfileIndex());
+    TEST_ASSERT_EQUAL(top, air.rate.profile);
+    TEST_ASSERT_EQUAL(proto_rate_profile(top).sf, LoRa.spreadingFactor);
+    TEST_ASSERT_EQUAL(proto_rate_profile(top).bandwidthHz, LoRa.bandwidth);
+    const DataRateStats& s = dataRateStats();
+    TEST_ASSERT_EQUAL(top, s.upSwitches);
+    TEST_ASSERT_EQUAL(0, s.downSwitches);
+    TEST_ASSERT_EQUAL(0, s.fallbacks);
+
+    const uint32_t before = sim.cmdHeard;
+    runFor(1000);
+    TEST_ASSERT_GREATER_THAN(slowHeard * 3 / 2, sim.cmdHeard - before);  // More commands per second
+    TEST_ASSERT_LESS_OR_EQUAL(FRAME_GAP_US, sim.maxCmdGapUs);
+    TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  }
+}
+
+// ✅ Range grows: steps back down before the fast profile fails, link never breaks
+void test_fading_link_steps_down() {
+  startSession(false);
+  pathLossDb = 80.0f;
+  runFor(4000);
+  TEST_ASSERT_GREATER_THAN(0, dataRateProfileIndex());
+
+  for (int i = 0; i < 100; i++) {  // 80 → 132 dB over 10 s (−115 dBm: profile 0 only)
+    pathLossDb += 0.52f;
+    runFor(100);
+  }
+  runFor(2000);
+
+  const DataRateStats& s = dataRateStats();
+  TEST_ASSERT_EQUAL(0, dataRateProfileIndex());
+  TEST_ASSERT_EQUAL(0, air.rate.profile);
+  TEST_ASSERT_GREATER_THAN(0, s.downSwitches);
+  TEST_ASSERT_EQUAL(0, s.fallbacks);
+  TEST_ASSERT_LESS_THAN(PROTO_RATE_FALLBACK_MS * 1000UL / 2, sim.maxCmdGapUs);
+}
+
+// 🛟 The ack of a switch is lost: the ends drift apart, fall back and meet again
+void test_lost_ack_recovers() {
+  startSession(false);
+  pathLossDb = 80.0f;
+  air.dropRateAck = true;
+  runFor(3000);
+
+  TEST_ASSERT_FALSE(air.dropRateAck);  // The switch happened and its ack was dropped
+  TEST_ASSERT_GREATER_THAN(0, sim.profileMismatch);
+  TEST_ASSERT_LESS_THAN(PROTO_RATE_FALLBACK_MS * 1000UL + 2 * PROTO_CMD_INTERVAL_MS * 1000UL, sim.maxCmdGapUs);
+  runFor(3000);
+  TEST_ASSERT_EQUAL(proto_rate_profile_count() - 1, dataRateProfileIndex());  // Back up, in step
+  TEST_ASSERT_EQUAL(dataRateProfileIndex(), air.rate.profile);
+
+  // 🛟 Link gone entirely on the fast profile: both ends end up on profile 0
+  pathLossDb = 160.0f;
+  runFor(PROTO_RATE_FALLBACK_MS * 2);
+  TEST_ASSERT_EQUAL(0, dataRateProfileIndex());
+  TEST_ASSERT_EQUAL(0, air.rate.profile);
+  TEST_ASSERT_EQUAL(1, dataRateStats().fallbacks);
+  pathLossDb = 132.0f;  // Back in range, profile 0 only
+  const uint32_t heard = sim.cmdHeard;
+  runFor(2000);
+  TEST_ASSERT_GREATER_THAN(heard + 20, sim.cmdHeard);
+  TEST_ASSERT_EQUAL(0, dataRateProfileIndex());
+}
+
+// ✅ Flight board without the op: requests go unacked, the link stays on profile 0
+void test_air_without_adr_stays_put() {
+  startSession(false);
+  pathLossDb = 80.0f;
+  air.adr = false;
+  runFor(DATA_RATE_RETRY_MS + 3000);
+
+  const DataRateStats& s = dataRateStats();
+  TEST_ASSERT_EQUAL(0, dataRateProfileIndex());
+  TEST_ASSERT_EQUAL(0, sim.profileMismatch);
+  TEST_ASSERT_EQUAL(2, s.requests);  // First try, one retry after DATA_RATE_RETRY_MS
+  TEST_ASSERT_GREATER_OR_EQUAL(1, s.unacked);
+  TEST_ASSERT_FALSE(reliableOpPending(PROTO_REL_OP_RATE) && s.unacked == s.requests);
+  TEST_ASSERT_LESS_OR_EQUAL(FRAME_GAP_US, sim.maxCmdGapUs);
+}
+
+// 📊 Out-and-back flight: fixed profile 0 vs adaptive
+void test_flight_benchmark() {
+  struct Run {
+    SimStats sim;
+    DataRateStats rate;
+  } runs[2];
+  for (int adaptive = 0; adaptive < 2; adaptive++) {
+    dataRateSetAdaptive(adaptive);
+    rng = 7;
+    startSession(false);
+    for (int i = 0; i < 600; i++) {  // 60 s: 75 dB → 130 dB at 30 s → back
+      float x = i < 300 ? i / 300.0f : (600 - i) / 300.0f;
+      pathLossDb = 75.0f + 55.0f * x;
+      runFor(100);
+    }
+    runs[adaptive] = {sim, dataRateStats()};
+  }
+
+  const Run& fixed = runs[0];
+  const Run& adr = runs[1];
+  char msg[256];
+  snprintf(msg, sizeof(msg),
+           "60 s flight: fixed %u/%u commands heard, %u TLM | adaptive %u/%u, %u TLM, %u up / %u down / %u fallbacks, "
+           "%.0f%% of the time faster than profile 0",
+           (unsigned)fixed.sim.cmdHeard, (unsigned)fixed.sim.cmdSent, (unsigned)fixed.sim.tlmHeard,
+           (unsigned)adr.sim.cmdHeard, (unsigned)adr.sim.cmdSent, (unsigned)adr.sim.tlmHeard,
+           (unsigned)adr.rate.upSwitches, (unsigned)adr.rate.downSwitches, (unsigned)adr.rate.fallbacks,
+           100.0f - adr.rate.timeOnProfileMs[0] / 600.0f);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_EQUAL(0, fixed.rate.requests);
+  TEST_ASSERT_GREATER_THAN(fixed.sim.cmdHeard * 5 / 4, adr.sim.cmdHeard);
+  TEST_ASSERT_EQUAL(0, adr.rate.fallbacks);
+  TEST_ASSERT_LESS_OR_EQUAL(fixed.sim.maxCmdGapUs + PROTO_CMD_INTERVAL_MS * 1000UL, adr.sim.maxCmdGapUs);
+}
+
+#else
+void setUp(void) {}
+void tearDown(void) {}
+#endif
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_profile_ladder);
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_strong_link_steps_up);
+  RUN_TEST(test_fading_link_steps_down);
+  RUN_TEST(test_lost_ack_recovers);
+  RUN_TEST(test_air_without_adr_stays_put);
+  RUN_TEST(test_flight_benchmark);
+#endif
+
+  return UNITY_END();
+}
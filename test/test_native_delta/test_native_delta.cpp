@@ -0,0 +1,275 @@
+#include <unity.h>
+
+// 🔺 Delta command frame tests + flight replay benchmark
+// Three synthetic flight recordings (uplink packets at PROTO_CMD_INTERVAL_MS,
+// sticks through the real expo path) are replayed through the ground encoder
+// and a flight-board decoder over a lossy link.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "Airtime.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_delta.h"
+
+const ProtoCmdPacket& constructMessage(const ControlState& cs);
+size_t encodeCommandFrame(const ProtoCmdPacket& full, uint8_t* out);
+void commandFrameSent(const uint8_t* frame, size_t len);
+void resetCommandEncoder();
+
+#define FLIGHT_SECONDS 60
+#define FLIGHT_FRAMES (FLIGHT_SECONDS * 1000 / PROTO_CMD_INTERVAL_MS)
+
+typedef int8_t (*FlightProfile)(int frame, ControlState& cs);  // → elevator trim step this frame
+
+static ProtoCmdPacket makePacket(uint8_t ail, uint8_t elev, uint8_t engine) {
+  ProtoCmdPacket p = {};
+  p.magic = PROTO_CMD_MAGIC;
+  p.engine = engine;
+  p.ailerons = ail;
+  p.rudder = 90;
+  p.elevators = elev;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_CMD_PACKET_SIZE - 1);
+  return p;
+}
+
+static uint8_t stick(float v) {  // -1..1 → raw 0..255
+  return (uint8_t)constrain((int)lroundf(127.5f + v * 127.5f), 0, 255);
+}
+
+// 🛩️ Cruise: steady sticks, a small correction about once a second
+static int8_t cruiseFlight(int f, ControlState& cs) {
+  cs.engine = 2600;
+  cs.aileron = (f % 20 < 3) ? stick(0.08f) : 127;
+  cs.elevators = (f % 33 < 4) ? stick(-0.06f) : stick(0.02f);
+  return 0;
+}
+
+// 🌀 Aerobatics: rolls and loops, throttle working
+static int8_t aerobaticFlight(int f, ControlState& cs) {
+  float t = f * PROTO_CMD_INTERVAL_MS / 1000.0f;
+  cs.engine = (uint16_t)(3000 + 1000 * sinf(t * 0.7f));
+  cs.aileron = stick(0.9f * sinf(t * 2.1f));
+  cs.elevators = stick(0.7f * sinf(t * 1.3f + 1.0f));
+  cs.rudder = stick(0.3f * sinf(t * 2.1f));
+  cs.airbrake = (f / 100) % 4 == 3;
+  return 0;
+}
+
+// 🛬 Circuit: takeoff, pattern turns, flapped approach, a few trim presses
+static int8_t circuitFlight(int f, ControlState& cs) {
+  float t = f * PROTO_CMD_INTERVAL_MS / 1000.0f;
+  cs.flaps = t < 8 ? 2 : (t > 45 ? 3 : 0);
+  cs.engine = t < 10 ? (uint16_t)(t * 400) : (t > 45 ? 1200 : 2800);
+  bool turning = fmodf(t, 12.0f) > 9.0f;
+  cs.aileron = turning ? stick(0.35f) : stick(0.02f * sinf(t * 5.0f));
+  cs.elevators = stick(t < 10 ? 0.3f : (turning ? 0.15f : 0.0f));
+  return f % 150 == 75 ? 1 : 0;  // One-shot step goes out exactly once
+}
+
+static std::vector<ProtoCmdPacket> record(FlightProfile profile) {
+  std::vector<ProtoCmdPacket> flight;
+  ControlState cs = {};
+  cs.aileron = cs.rudder = cs.elevators = 127;
+  cs.ecoMode = true;
+  for (int f = 0; f < FLIGHT_FRAMES; f++) {
+    int8_t trim = profile(f, cs);
+    ProtoCmdPacket p = constructMessage(cs);
+    p.elevatorTrim = trim;
+    p.checksum = proto_checksum((const uint8_t*)&p, PROTO_CMD_PACKET_SIZE - 1);
+    flight.push_back(p);
+  }
+  return flight;
+}
+
+// 🛩️ Flight-board side: keyframes update the base, deltas rebuild from it
+struct Receiver {
+  ProtoCmdPacket key;
+  bool haveKey;
+  uint32_t decoded;
+  uint32_t rejected;
+
+  bool receive(const uint8_t* frame, size_t len, ProtoCmdPacket* out) {
+    if (frame[0] == PROTO_CMD_MAGIC && len == PROTO_CMD_PACKET_SIZE) {
+      memcpy(&key, frame, PROTO_CMD_PACKET_SIZE);
+      haveKey = true;
+      *out = key;
+      decoded++;
+      return true;
+    }
+    if (haveKey && proto_delta_decode(&key, frame, len, out)) {
+      decoded++;
+      return true;
+    }
+    rejected++;
+    return false;
+  }
+};
+
+struct ReplayResult {
+  uint64_t fullBytes, deltaBytes;
+  uint64_t fullAirUs, deltaAirUs;
+  uint32_t keyframes;
+};
+
+// 📡 Encode every packet, drop lossPct % on the link, check what the air side rebuilds
+static ReplayResult replay(const std::vector<ProtoCmdPacket>& flight, int lossPct, Receiver& rx) {
+  ReplayResult r = {};
+  resetCommandEncoder();
+  srand(7);
+  for (const ProtoCmdPacket& p : flight) {
+    uint8_t frame[PROTO_DELTA_MAX_SIZE];
+    size_t len = encodeCommandFrame(p, frame);
+    commandFrameSent(frame, len);
+
+    r.fullBytes += PROTO_CMD_PACKET_SIZE;
+    r.deltaBytes += len;
+    r.fullAirUs += protoAirtimeUs(PROTO_CMD_PACKET_SIZE);
+    r.deltaAirUs += protoAirtimeUs(len);
+    if (len == PROTO_CMD_PACKET_SIZE)
+      r.keyframes++;
+
+    if (rand() % 100 < lossPct)
+      continue;
+    ProtoCmdPacket out;
+    if (rx.receive(frame, len, &out))
+      TEST_ASSERT_EQUAL_MEMORY(&p, &out, PROTO_CMD_PACKET_SIZE);
+  }
+  return r;
+}
+
+void setUp(void) {
+  resetCommandEncoder();
+}
+
+void tearDown(void) {}
+
+// ✅ Round trip: only changed fields on air, full packet rebuilt bit-exact
+void test_delta_round_trip() {
+  ProtoCmdPacket key = makePacket(90, 90, 100);
+  ProtoCmdPacket cur = key;
+  cur.ailerons = 120;
+  cur.checksum = proto_checksum((const uint8_t*)&cur, PROTO_CMD_PACKET_SIZE - 1);
+
+  uint8_t frame[PROTO_DELTA_MAX_SIZE];
+  size_t len = proto_delta_encode(&key, &cur, frame);
+  TEST_ASSERT_EQUAL(PROTO_DELTA_HEADER_SIZE + 2, len);
+  TEST_ASSERT_EQUAL_HEX8(PROTO_DELTA_F_AILERONS, frame[PROTO_DELTA_MASK_INDEX]);
+
+  ProtoCmdPacket out;
+  TEST_ASSERT_TRUE(proto_delta_decode(&key, frame, len, &out));
+  TEST_ASSERT_EQUAL_MEMORY(&cur, &out, PROTO_CMD_PACKET_SIZE);
+
+  frame[3] ^= 1;  // Corrupted payload
+  TEST_ASSERT_FALSE(proto_delta_decode(&key, frame, len, &out));
+}
+
+// ✅ One-shots (trim steps, reset flags) are never inherited from the keyframe
+void test_one_shots_not_inherited() {
+  ProtoCmdPacket key = makePacket(90, 90, 100);
+  key.elevatorTrim = 1;
+  key.flags = PROTO_FLAG_RESET_AIL | PROTO_FLAG_AIRBRAKE;
+  key.checksum = proto_checksum((const uint8_t*)&key, PROTO_CMD_PACKET_SIZE - 1);
+
+  ProtoCmdPacket cur = key;
+  cur.elevatorTrim = 0;
+  cur.flags = PROTO_FLAG_AIRBRAKE;
+  cur.checksum = proto_checksum((const uint8_t*)&cur, PROTO_CMD_PACKET_SIZE - 1);
+
+  uint8_t frame[PROTO_DELTA_MAX_SIZE];
+  size_t len = proto_delta_encode(&key, &cur, frame);
+  TEST_ASSERT_EQUAL(PROTO_DELTA_HEADER_SIZE + 1, len);  // Nothing to say
+
+  ProtoCmdPacket out;
+  TEST_ASSERT_TRUE(proto_delta_decode(&key, frame, len, &out));
+  TEST_ASSERT_EQUAL(0, out.elevatorTrim);
+  TEST_ASSERT_EQUAL_HEX8(PROTO_FLAG_AIRBRAKE, out.flags);
+}
+
+// ✅ A delta built on a keyframe the receiver missed is rejected
+void test_missed_keyframe_rejected() {
+  ProtoCmdPacket oldKey = makePacket(90, 90, 100);
+  ProtoCmdPacket newKey = makePacket(10, 170, 140);
+  ProtoCmdPacket cur = newKey;
+  cur.rudder = 100;
+  cur.checksum = proto_checksum((const uint8_t*)&cur, PROTO_CMD_PACKET_SIZE - 1);
+
+  uint8_t frame[PROTO_DELTA_MAX_SIZE];
+  size_t len = proto_delta_encode(&newKey, &cur, frame);
+  ProtoCmdPacket out;
+  TEST_ASSERT_FALSE(proto_delta_decode(&oldKey, frame, len, &out));
+  TEST_ASSERT_TRUE(proto_delta_decode(&newKey, frame, len, &out));
+
+  // Same XOR checksum, different keyframe: the base CRC still tells them apart
+  ProtoCmdPacket nearKey = makePacket(91, 91, 100);
+  TEST_ASSERT_EQUAL_HEX8(oldKey.checksum, nearKey.checksum);
+  cur = nearKey;
+  cur.rudder = 100;
+  cur.checksum = proto_checksum((const uint8_t*)&cur, PROTO_CMD_PACKET_SIZE - 1);
+  len = proto_delta_encode(&nearKey, &cur, frame);
+  TEST_ASSERT_FALSE(proto_delta_decode(&oldKey, frame, len, &out));
+  TEST_ASSERT_TRUE(proto_delta_decode(&nearKey, frame, len, &out));
+}
+
+// ✅ Ground encoder: keyframe first and every PROTO_DELTA_KEYFRAME_INTERVAL frames
+void test_encoder_keyframe_cadence() {
+  ProtoCmdPacket p = makePacket(90, 90, 100);
+  uint8_t frame[PROTO_DELTA_MAX_SIZE];
+  for (int i = 0; i < 3 * PROTO_DELTA_KEYFRAME_INTERVAL; i++) {
+    p.ailerons = (uint8_t)(100 + i);  // Always differs from the keyframe
+    p.checksum = proto_checksum((const uint8_t*)&p, PROTO_CMD_PACKET_SIZE - 1);
+    size_t len = encodeCommandFrame(p, frame);
+    bool key = i % PROTO_DELTA_KEYFRAME_INTERVAL == 0;
+    TEST_ASSERT_EQUAL(key ? PROTO_CMD_MAGIC : PROTO_DELTA_MAGIC, frame[0]);
+    TEST_ASSERT_EQUAL(key ? PROTO_CMD_PACKET_SIZE : PROTO_DELTA_HEADER_SIZE + 2, len);
+    commandFrameSent(frame, len);
+  }
+
+  // Unsent frames don't advance the cadence
+  resetCommandEncoder();
+  TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, encodeCommandFrame(p, frame));
+  TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, encodeCommandFrame(p, frame));
+}
+
+// 📊 Replay benchmark: bytes and airtime per second, full vs delta, 10 % loss
+void test_flight_replay_benchmark() {
+  struct {
+    const char* name;
+    FlightProfile profile;
+  } flights[] = {{"cruise", cruiseFlight}, {"aerobatic", aerobaticFlight}, {"circuit", circuitFlight}};
+
+  for (auto& f : flights) {
+    std::vector<ProtoCmdPacket> flight = record(f.profile);
+    Receiver rx = {};
+    ReplayResult r = replay(flight, 10, rx);
+
+    char msg[192];
+    snprintf(msg, sizeof(msg),
+             "%-9s avg %.2f B/frame (full %u) | %.0f B/s vs %.0f | airtime %.1f ms/s vs %.1f | %u keyframes, %u/%u rebuilt, %u rejected",
+             f.name, (double)r.deltaBytes / flight.size(), (unsigned)PROTO_CMD_PACKET_SIZE,
+             (double)r.deltaBytes / FLIGHT_SECONDS, (double)r.fullBytes / FLIGHT_SECONDS,
+             r.deltaAirUs / 1000.0 / FLIGHT_SECONDS, r.fullAirUs / 1000.0 / FLIGHT_SECONDS, (unsigned)r.keyframes,
+             (unsigned)rx.decoded, (unsigned)flight.size(), (unsigned)rx.rejected);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_LESS_THAN(r.fullBytes, r.deltaBytes);
+    TEST_ASSERT_LESS_OR_EQUAL(r.fullAirUs, r.deltaAirUs);
+    TEST_ASSERT_GREATER_OR_EQUAL(flight.size() / PROTO_DELTA_KEYFRAME_INTERVAL, r.keyframes);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_delta_round_trip);
+  RUN_TEST(test_one_shots_not_inherited);
+  RUN_TEST(test_missed_keyframe_rejected);
+  RUN_TEST(test_encoder_keyframe_cadence);
+  RUN_TEST(test_flight_replay_benchmark);
+
+  return UNITY_END();
+}
@@ -0,0 +1,291 @@
+#include <unity.h>
+
+// 🧩 XOR parity frame tests + channel simulator benchmark
+// The real ground code sends commands (and, with a group size set, one parity
+// frame per K commands) over a bursty lossy link to a simulated flight board
+// that rebuilds single losses from the parity frames.
+
+#include <LoRa.h>
+
+#include <string.h>
+
+#include <vector>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_fec.h"
+#include "protocol_trim.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+void commandFecSetGroup(uint8_t k);
+
+#define SIM_DURATION_MS 30000
+#define SIM_STEP_US 100
+#define TRIM_PRESS_MS 500  // ⚖️ One elevator trim step every half second
+#define AIR_HISTORY 16     // Commands the flight board keeps for parity matching
+
+static ProtoCmdPacket makePacket(uint8_t ail, uint8_t elev, int8_t trim) {
+  ProtoCmdPacket p = {};
+  p.magic = PROTO_CMD_MAGIC;
+  p.engine = 100;
+  p.ailerons = ail;
+  p.rudder = 90;
+  p.elevators = elev;
+  p.elevatorTrim = trim;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_CMD_PACKET_SIZE - 1);
+  return p;
+}
+
+// 📉 Gilbert–Elliott channel: mostly good, occasional fades that eat bursts
+struct BurstyLink {
+  uint32_t rng;
+  bool bad;
+
+  uint32_t next() {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 16) % 1000;
+  }
+  bool lost() {
+    if (bad ? next() < 300 : next() < 50)
+      bad = !bad;
+    return next() < (bad ? 600u : 20u);
+  }
+};
+
+// 🛩️ Flight-board side: commands heard + parity rebuilds
+struct AirSide {
+  ProtoCmdPacket held[AIR_HISTORY];  // Oldest first
+  size_t heldCount;
+  uint32_t fresh;      // Commands heard directly
+  uint32_t recovered;  // Commands rebuilt from parity
+  uint32_t trims;      // Trim steps applied (either way)
+  unsigned long lastFreshUs;
+  unsigned long worstGapUs;
+
+  void hold(const ProtoCmdPacket& p) {
+    if (heldCount == AIR_HISTORY)
+      memmove(held, held + 1, --heldCount * sizeof(held[0]));
+    held[heldCount++] = p;
+  }
+
+  void receive(const uint8_t* frame, size_t len, unsigned long atUs) {
+    ProtoCmdPacket p;
+    if (frame[0] == PROTO_CMD_MAGIC && len == PROTO_CMD_PACKET_SIZE) {
+      memcpy(&p, frame, PROTO_CMD_PACKET_SIZE);
+      fresh++;
+      if (lastFreshUs && atUs - lastFreshUs > worstGapUs)
+        worstGapUs = atUs - lastFreshUs;
+      lastFreshUs = atUs;
+    } else if (proto_fec_recover(frame, len, held, heldCount, &p)) {
+      recovered++;
+    } else {
+      return;
+    }
+    hold(p);
+    trims += p.elevatorTrim != 0;  // One-shot applies exactly once
+  }
+};
+
+struct BenchResult {
+  uint32_t commands;  // Command frames on air
+  uint32_t parity;    // Parity frames on air
+  uint32_t trimsSent;
+  uint64_t airUs;
+  AirSide air;
+};
+
+static BenchResult runChannel(uint8_t k) {
+  commandFecSetGroup(k);
+  BurstyLink link = {12345, false};
+  BenchResult r = {};
+  size_t seen = LoRa.sent.size();
+  const unsigned long startUs = micros();
+  const unsigned long endUs = startUs + SIM_DURATION_MS * 1000UL;
+  unsigned long nextStickUs = startUs, nextTrimUs = startUs + TRIM_PRESS_MS * 1000UL;
+  uint8_t phase = 0;
+  uint32_t presses = 0;
+
+  while (micros() < endUs) {
+    hal_advanceMicros(SIM_STEP_US);
+    if (micros() >= nextStickUs) {  // 🎮 Sticks keep moving, every command differs
+      nextStickUs += 10000;
+      ControlState& cs = controlBeginWrite();
+      cs.aileron = (uint8_t)(64 + phase++ % 128);
+      if (micros() >= nextTrimUs) {
+        nextTrimUs += TRIM_PRESS_MS * 1000UL;
+        cs.elevatorTrim = proto_trim_step(cs.elevatorTrim, presses++ % 2 ? -1 : 1);  // Up / down: never clamped
+      }
+      controlEndWrite();
+    }
+    if (hal_takeNotify(NULL))
+      loraLoop();
+
+    for (; seen < LoRa.sent.size(); seen++) {
+      const FakeLoRaFrame& f = LoRa.sent[seen];
+      r.airUs += protoAirtimeUs(f.data.size());
+      if (f.data[0] == PROTO_FEC_MAGIC) {
+        r.parity++;
+      } else {
+        r.commands++;
+        r.trimsSent += ((const ProtoCmdPacket*)f.data.data())->elevatorTrim != 0;
+      }
+      if (!link.lost())
+        r.air.receive(f.data.data(), f.data.size(), f.atUs + LORA_CMD_AIRTIME_US);
+    }
+  }
+  return r;
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+}
+
+void tearDown(void) {
+  commandFecSetGroup(0);
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ Any single loss in the group is rebuilt bit-exact; 0 or 2+ losses are not
+void test_parity_recovers_single_loss() {
+  const uint8_t k = 4;
+  ProtoCmdPacket group[k];
+  ProtoFecGroup g;
+  proto_fec_reset(&g);
+  for (uint8_t i = 0; i < k; i++) {
+    group[i] = makePacket((uint8_t)(80 + i * 7), (uint8_t)(100 - i), i == 2 ? 1 : 0);
+    proto_fec_add(&g, &group[i]);
+  }
+  uint8_t frame[PROTO_FEC_MAX_SIZE];
+  size_t len = proto_fec_encode(&g, frame);
+  TEST_ASSERT_EQUAL(PROTO_FEC_SIZE(k), len);
+
+  for (uint8_t lost = 0; lost < k; lost++) {
+    ProtoCmdPacket held[k - 1];
+    for (uint8_t i = 0, n = 0; i < k; i++) {
+      if (i != lost)
+        held[n++] = group[i];
+    }
+    ProtoCmdPacket out;
+    TEST_ASSERT_TRUE(proto_fec_recover(frame, len, held, k - 1, &out));
+    TEST_ASSERT_EQUAL_MEMORY(&group[lost], &out, PROTO_CMD_PACKET_SIZE);
+  }
+
+  ProtoCmdPacket out;
+  TEST_ASSERT_FALSE(proto_fec_recover(frame, len, group, k, &out));      // Nothing missing
+  TEST_ASSERT_FALSE(proto_fec_recover(frame, len, group, k - 2, &out));  // Two missing
+  frame[5] ^= 1;
+  TEST_ASSERT_FALSE(proto_fec_recover(frame, len, group, k - 1, &out));  // Corrupted
+}
+
+// ✅ Identical commands in one group (held sticks) still rebuild
+void test_parity_with_duplicate_commands() {
+  ProtoCmdPacket same = makePacket(90, 90, 0);
+  ProtoCmdPacket other = makePacket(91, 90, 0);
+  ProtoFecGroup g;
+  proto_fec_reset(&g);
+  proto_fec_add(&g, &same);
+  proto_fec_add(&g, &same);
+  proto_fec_add(&g, &other);
+  uint8_t frame[PROTO_FEC_MAX_SIZE];
+  size_t len = proto_fec_encode(&g, frame);
+
+  ProtoCmdPacket out;
+  TEST_ASSERT_TRUE(proto_fec_recover(frame, len, &same, 1, &out));
+  TEST_ASSERT_EQUAL_MEMORY(&other, &out, PROTO_CMD_PACKET_SIZE);
+}
+
+// ✅ Real LoRaTask: one parity frame after every K commands, covering exactly them
+void test_ground_parity_cadence() {
+  const uint8_t k = 3;
+  commandFecSetGroup(k);
+  size_t first = LoRa.sent.size();
+  for (int ms = 0; ms < 2000; ms++) {
+    hal_advanceMillis(1);
+    if (ms % 10 == 0) {
+      controlBeginWrite().aileron = (uint8_t)(ms / 10);
+      controlEndWrite();
+    }
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+
+  std::vector<ProtoCmdPacket> group;
+  uint32_t parity = 0;
+  for (size_t i = first; i < LoRa.sent.size(); i++) {
+    const FakeLoRaFrame& f = LoRa.sent[i];
+    if (f.data[0] != PROTO_FEC_MAGIC) {
+      ProtoCmdPacket p;
+      memcpy(&p, f.data.data(), PROTO_CMD_PACKET_SIZE);
+      group.push_back(p);
+      continue;
+    }
+    parity++;
+    TEST_ASSERT_EQUAL(k, group.size());
+    TEST_ASSERT_EQUAL(k, f.data[1]);
+    ProtoCmdPacket out;  // Drop the middle one, the parity brings it back
+    std::vector<ProtoCmdPacket> held = {group[0], group[2]};
+    TEST_ASSERT_TRUE(proto_fec_recover(f.data.data(), f.data.size(), held.data(), held.size(), &out));
+    TEST_ASSERT_EQUAL_MEMORY(&group[1], &out, PROTO_CMD_PACKET_SIZE);
+    group.clear();
+  }
+  TEST_ASSERT_GREATER_THAN(5, parity);
+  TEST_ASSERT_EQUAL(parity, radioStats().parityTx);
+}
+
+// 📊 Channel simulator: delivered updates and trim steps vs airtime, per group size
+void test_channel_benchmark() {
+  const uint8_t groups[] = {0, 8, 4, 2};
+  BenchResult base = {};
+  for (uint8_t k : groups) {
+    BenchResult r = runChannel(k);
+    const double secs = SIM_DURATION_MS / 1000.0;
+    uint32_t delivered = r.air.fresh + r.air.recovered;
+    char msg[256];
+    snprintf(msg, sizeof(msg),
+             "K=%u: airtime %.1f ms/s | %.1f cmd/s on air, %.1f fresh/s + %.1f rebuilt/s at air (%.1f%% of sent) | "
+             "trims %u/%u | worst fresh gap %lu ms",
+             (unsigned)k, r.airUs / 1000.0 / secs, r.commands / secs, r.air.fresh / secs, r.air.recovered / secs,
+             100.0 * delivered / r.commands, (unsigned)r.air.trims, (unsigned)r.trimsSent,
+             (unsigned long)(r.air.worstGapUs / 1000));
+    TEST_MESSAGE(msg);
+
+    if (k == 0) {
+      base = r;
+      TEST_ASSERT_EQUAL(0, r.parity);
+      TEST_ASSERT_EQUAL(0, r.air.recovered);
+      continue;
+    }
+    // Parity takes a command slot: fewer commands, more of them arrive
+    TEST_ASSERT_UINT32_WITHIN(2, r.commands / k, r.parity);
+    TEST_ASSERT_LESS_THAN(base.commands, r.commands);
+    TEST_ASSERT_GREATER_THAN(0, r.air.recovered);
+    TEST_ASSERT_GREATER_THAN(100.0 * (base.air.fresh + base.air.recovered) / base.commands,
+                             100.0 * delivered / r.commands);
+    TEST_ASSERT_GREATER_OR_EQUAL(base.air.trims * r.trimsSent / base.trimsSent, r.air.trims);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_parity_recovers_single_loss);
+  RUN_TEST(test_parity_with_duplicate_commands);
+  RUN_TEST(test_ground_parity_cadence);
+  RUN_TEST(test_channel_benchmark);
+
+  return UNITY_END();
+}
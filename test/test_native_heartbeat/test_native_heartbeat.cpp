@@ -0,0 +1,118 @@
+#include <unity.h>
+
+// 💓 Keepalive heartbeat tests
+// ECO mode with idle sticks: duplicates are suppressed, but the link never
+// goes silent — the air side sees a heartbeat that confirms its held command.
+
+#include <LoRa.h>
+#include <string.h>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "RateControl.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_heartbeat.h"
+
+void setupRadio();
+void loraLoop();
+
+#define IDLE_MS 10000
+
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+static bool isHeartbeat(const FakeLoRaFrame& f) {
+  return f.data.size() == PROTO_HEARTBEAT_SIZE && f.data[0] == PROTO_HEARTBEAT_MAGIC;
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();  // ECO on, sticks centered
+  setupRadio();
+  loraStartScheduler(NULL);
+  LoRa.reset();
+}
+
+void tearDown(void) {
+  Serial.muted = false;
+}
+
+// ✅ Idle ECO link: heartbeats only, never silent past the keepalive interval
+void test_idle_link_sends_heartbeats() {
+  runLoRaTask(IDLE_MS);
+
+  ProtoCmdPacket holding = {};
+  unsigned long lastUs = 0;
+  unsigned long maxGapUs = 0;
+  size_t heartbeats = 0, commands = 0;
+  uint8_t seq = 0;
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    if (lastUs && f.atUs - lastUs > maxGapUs)
+      maxGapUs = f.atUs - lastUs;
+    lastUs = f.atUs;
+    if (isHeartbeat(f)) {
+      TEST_ASSERT_TRUE(proto_heartbeat_check(f.data.data(), f.data.size(), &holding));
+      if (heartbeats++)
+        TEST_ASSERT_EQUAL((uint8_t)(seq + 1), f.data[1]);
+      seq = f.data[1];
+    } else {
+      memcpy(&holding, f.data.data(), PROTO_CMD_PACKET_SIZE);
+      commands++;
+    }
+  }
+
+  uint32_t fixedAirUs = IDLE_MS / PROTO_CMD_INTERVAL_MS * LORA_CMD_AIRTIME_US;
+  uint32_t usedAirUs = commands * LORA_CMD_AIRTIME_US + heartbeats * protoAirtimeUs(PROTO_HEARTBEAT_SIZE);
+  char msg[160];
+  snprintf(msg, sizeof(msg), "idle %u s: %u commands + %u heartbeats, max gap %lu ms, airtime %lu ms vs %lu ms fixed rate",
+           IDLE_MS / 1000, (unsigned)commands, (unsigned)heartbeats, maxGapUs / 1000, (unsigned long)usedAirUs / 1000,
+           (unsigned long)fixedAirUs / 1000);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_GREATER_THAN(IDLE_MS / (HEARTBEAT_INTERVAL_MS + RATE_MAX_INTERVAL_MS / 2), heartbeats);
+  TEST_ASSERT_LESS_OR_EQUAL((HEARTBEAT_INTERVAL_MS + RATE_MAX_INTERVAL_MS / 2) * 1000UL, maxGapUs);
+  TEST_ASSERT_EQUAL(heartbeats, radioStats().heartbeats);
+  TEST_ASSERT_LESS_THAN(fixedAirUs / 5, usedAirUs);
+}
+
+// ✅ A stick move ends the heartbeat phase: the next slot is a full command
+void test_stick_move_resumes_commands() {
+  runLoRaTask(3000);
+  TEST_ASSERT_TRUE(isHeartbeat(LoRa.sent.back()));
+
+  controlBeginWrite().aileron = 200;
+  controlEndWrite();
+  runLoRaTask(RATE_MAX_INTERVAL_MS + 1);
+
+  const FakeLoRaFrame& f = LoRa.sent.back();
+  TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, f.data.size());
+  TEST_ASSERT_EQUAL(PROTO_CMD_MAGIC, f.data[0]);
+}
+
+// ✅ ECO off: every slot carries the full command, no heartbeats
+void test_eco_off_no_heartbeats() {
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  runLoRaTask(2000);
+  TEST_ASSERT_EQUAL(0, radioStats().heartbeats);
+  TEST_ASSERT_UINT32_WITHIN(1, 2000 / PROTO_CMD_INTERVAL_MS, LoRa.sent.size());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_idle_link_sends_heartbeats);
+  RUN_TEST(test_stick_move_resumes_commands);
+  RUN_TEST(test_eco_off_no_heartbeats);
+
+  return UNITY_END();
+}
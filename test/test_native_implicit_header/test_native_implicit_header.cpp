@@ -0,0 +1,189 @@
+#include <unity.h>
+
+// 📏 Implicit-header framing tests
+// Time on air with and without the LoRa header at every SF, then the real
+// send / receive path with implicit header switched on.
+
+#include <LoRa.h>
+
+#include "Airtime.h"
+#include "DataRate.h"
+#include "RadioState.h"
+#include "RateControl.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_implicit.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+void commandFecSetGroup(uint8_t k);
+bool LoRa_sendPacket(const uint8_t* data, size_t len);
+
+#ifdef PROTO_BIDIRECTIONAL
+extern bool tlm_valid;
+#endif
+
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  airtimeReset();
+#ifdef PROTO_BIDIRECTIONAL
+  tlm_valid = false;
+#endif
+}
+
+void tearDown(void) {
+  radioSetImplicitHeader(false);
+  commandFecSetGroup(0);
+  Serial.muted = false;
+}
+
+// 📊 Command frame time on air per SF, explicit vs implicit, and the rate it buys
+void test_airtime_saving_per_sf() {
+  for (int sf = 7; sf <= 12; sf++) {
+    uint32_t exp = loraAirtimeUs(PROTO_CMD_PACKET_SIZE, sf, PROTO_LORA_BANDWIDTH_HZ, PROTO_LORA_CR, PROTO_LORA_PREAMBLE);
+    uint32_t imp = loraAirtimeUs(PROTO_CMD_PACKET_SIZE, sf, PROTO_LORA_BANDWIDTH_HZ, PROTO_LORA_CR,
+                                 PROTO_LORA_PREAMBLE, true, true);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "SF%d %lu Hz, %u B: explicit %lu us, implicit %lu us (-%.1f%%) | back to back %.1f -> %.1f cmd/s",
+             sf, (long)PROTO_LORA_BANDWIDTH_HZ, (unsigned)PROTO_CMD_PACKET_SIZE, (unsigned long)exp,
+             (unsigned long)imp, 100.0 * (exp - imp) / exp, 1e6 / exp, 1e6 / imp);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_OR_EQUAL(exp, imp);  // Never longer; symbol rounding can eat the saving
+  }
+  TEST_ASSERT_LESS_THAN(protoAirtimeUs(PROTO_CMD_PACKET_SIZE), protoAirtimeUs(PROTO_CMD_PACKET_SIZE, true));
+}
+
+// ✅ Default build: explicit header, no revision flag
+void test_explicit_by_default() {
+  setupRadio();
+  loraStartScheduler(NULL);
+  runLoRaTask(200);
+  TEST_ASSERT_FALSE(radioImplicitHeader());
+  TEST_ASSERT_GREATER_THAN(1, LoRa.sent.size());
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    TEST_ASSERT_FALSE(f.implicitHeader);
+    TEST_ASSERT_EQUAL(0, ((const ProtoCmdPacket*)f.data.data())->flags & PROTO_FLAG_IMPLICIT_HDR);
+  }
+}
+
+// ✅ Implicit: every frame fixed-size, headerless, flagged, booked at the shorter airtime
+void test_implicit_send_path() {
+  radioSetImplicitHeader(true);
+  setupRadio();
+  loraStartScheduler(NULL);
+  airtimeReset();
+  runLoRaTask(500);
+
+  TEST_ASSERT_GREATER_THAN(5, LoRa.sent.size());
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    TEST_ASSERT_TRUE(f.implicitHeader);
+    TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, f.data.size());
+    const ProtoCmdPacket* p = (const ProtoCmdPacket*)f.data.data();
+    TEST_ASSERT_EQUAL_HEX8(PROTO_FLAG_IMPLICIT_HDR, p->flags & PROTO_FLAG_IMPLICIT_HDR);
+    TEST_ASSERT_EQUAL_HEX8(proto_checksum(f.data.data(), PROTO_CMD_PACKET_SIZE - 1), p->checksum);
+  }
+  // Init packet went out before the ledger reset
+  TEST_ASSERT_EQUAL((LoRa.sent.size() - 1) * protoAirtimeUs(PROTO_CMD_PACKET_SIZE, true), airtimeUsedUs());
+}
+
+// ✅ Variable-length frames never go out headerless; ECO keepalives are full commands
+void test_fixed_size_enforced() {
+  radioSetImplicitHeader(true);
+  commandFecSetGroup(2);  // Parity frames are longer — paused
+  controlBeginWrite().ecoMode = true;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+  runLoRaTask(5000);
+
+  TEST_ASSERT_EQUAL(0, radioStats().parityTx);
+  TEST_ASSERT_GREATER_THAN(0, radioStats().heartbeats);  // Idle sticks → keepalives
+  uint8_t heartbeat[5] = {};
+  TEST_ASSERT_FALSE(LoRa_sendPacket(heartbeat, sizeof(heartbeat)));  // Last line of defence
+  TEST_ASSERT_EQUAL(1, radioStats().implicitRejected);
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, f.data.size());
+    TEST_ASSERT_EQUAL_HEX8(PROTO_CMD_MAGIC, f.data[0]);
+  }
+}
+
+#ifdef PROTO_BIDIRECTIONAL  // Telemetry RX only exists on a two-way link
+// ✅ RX window listens for exactly one telemetry frame length
+void test_implicit_rx_window() {
+  radioSetImplicitHeader(true);
+  setupRadio();
+  loraStartScheduler(NULL);
+  runLoRaTask(PROTO_CMD_INTERVAL_MS + 1);
+  TEST_ASSERT_TRUE(LoRa.receiving);
+  TEST_ASSERT_EQUAL(PROTO_TLM_PACKET_SIZE, LoRa.rxImplicitSize);
+
+  ProtoTlmPacket p = {};
+  p.magic = PROTO_TLM_MAGIC;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+  uint8_t longer[PROTO_TLM_PACKET_SIZE + 1] = {};
+  memcpy(longer, &p, PROTO_TLM_PACKET_SIZE);
+  LoRa.injectRx(longer, sizeof(longer));  // Another length can't decode
+  runLoRaTask(1);
+  TEST_ASSERT_FALSE(tlm_valid);
+  TEST_ASSERT_EQUAL(1, LoRa.rxCrcErrors);
+
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p));
+  runLoRaTask(1);
+  TEST_ASSERT_TRUE(tlm_valid);
+
+  radioSetImplicitHeader(false);
+  runLoRaTask(PROTO_CMD_INTERVAL_MS);  // Next RX window is explicit again
+  TEST_ASSERT_EQUAL(0, LoRa.rxImplicitSize);
+}
+#endif
+
+// ✅ Slot sizes and the rate floor follow radioSetImplicitHeader(), not the build default
+void test_slots_follow_header_mode() {
+  TEST_ASSERT_EQUAL(TDMA_TURNAROUND_US + protoAirtimeUs(TLM_IMPLICIT_SIZE, true) + TDMA_GUARD_US, tdmaTlmSlotUs(true));
+  TEST_ASSERT_LESS_THAN(tdmaTlmSlotUs(false), tdmaTlmSlotUs(true));  // Exact length, no header symbols
+  TEST_ASSERT_EQUAL(tdmaTlmSlotUs(true), dataRateTlmSlotUs(true));   // Profile 0
+
+  radioSetImplicitHeader(false);
+  setupRadio();
+  loraStartScheduler(NULL);
+  const uint32_t explicitFloor = rateControlFloorMs();
+  radioSetImplicitHeader(true);
+  setupRadio();
+  loraStartScheduler(NULL);
+  const uint32_t implicitFloor = rateControlFloorMs();
+#ifdef PROTO_BIDIRECTIONAL
+  TEST_ASSERT_EQUAL((tdmaCmdSlotUs(PROTO_CMD_PACKET_SIZE, true) + tdmaTlmSlotUs(true) + 999) / 1000, implicitFloor);
+  TEST_ASSERT_EQUAL((tdmaCmdSlotUs(PROTO_CMD_PACKET_SIZE, false) + tdmaTlmSlotUs(false) + 999) / 1000, explicitFloor);
+#endif
+  TEST_ASSERT_LESS_OR_EQUAL(explicitFloor, implicitFloor);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_airtime_saving_per_sf);
+  RUN_TEST(test_explicit_by_default);
+  RUN_TEST(test_implicit_send_path);
+  RUN_TEST(test_slots_follow_header_mode);
+  RUN_TEST(test_fixed_size_enforced);
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_implicit_rx_window);
+#endif
+
+  return UNITY_END();
+}
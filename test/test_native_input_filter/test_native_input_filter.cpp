@@ -0,0 +1,208 @@
+#include <unity.h>
+
+// 🎚️ Noise-aware change detection tests + replay benchmark
+// A 60 s session (bench idle, cruise, maneuvers) with DualSense / slider ADC
+// noise is replayed at the command rate through constructMessage(), raw vs
+// filtered, under the same ECO duplicate rule loraLoop() applies.
+
+#include <LoRa.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "InputFilter.h"
+#include "RadioState.h"
+#include "common.h"
+#include "protocol.h"
+
+const ProtoCmdPacket& constructMessage(const ControlState& cs);
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#define SESSION_TICKS (60000 / PROTO_CMD_INTERVAL_MS)
+
+static uint32_t rng = 1;
+static int noise(int amplitude) {  // Deterministic, roughly triangular
+  rng = rng * 1103515245u + 12345u;
+  int a = (int)((rng >> 16) % (2 * amplitude + 1)) - amplitude;
+  rng = rng * 1103515245u + 12345u;
+  int b = (int)((rng >> 16) % (2 * amplitude + 1)) - amplitude;
+  return (a + b) / 2;
+}
+
+static uint8_t stick(float v) {  // -1..1 → raw 0..255
+  return (uint8_t)constrain((int)lroundf(127.5f + v * 127.5f), 0, 255);
+}
+
+static uint8_t noisy(uint8_t v, int amplitude) {
+  int n = v + noise(amplitude);  // constrain() is a macro: draw once
+  return (uint8_t)constrain(n, 0, 255);
+}
+
+// 🛩️ Noise-free pilot input at tick i: 20 s bench idle, 20 s cruise, 20 s maneuvers
+static ControlState pilotAt(int i) {
+  ControlState cs = {};
+  cs.aileron = cs.elevators = cs.rudder = 128;  // DualSense rests at 0 + 128
+  cs.ecoMode = true;
+  float t = i * PROTO_CMD_INTERVAL_MS / 1000.0f;
+  if (t >= 20 && t < 40) {
+    cs.engine = 2600;
+    cs.elevators = stick(0.12f);
+    cs.aileron = (i % 60 < 6) ? stick(0.3f) : 128;  // A correction every 3 s
+  } else if (t >= 40) {
+    cs.engine = (uint16_t)(2800 + 900 * sinf(t * 0.5f));
+    cs.aileron = stick(0.8f * sinf(t * 2.0f));
+    cs.elevators = stick(0.6f * sinf(t * 1.1f));
+    cs.rudder = stick(0.25f * sinf(t * 2.0f));
+  }
+  return cs;
+}
+
+static ControlState withNoise(ControlState cs) {
+  cs.aileron = noisy(cs.aileron, 2);
+  cs.elevators = noisy(cs.elevators, 2);
+  cs.rudder = noisy(cs.rudder, 2);
+  cs.stabilityAssist = noisy(cs.stabilityAssist, 1);
+  int engine = cs.engine + noise(12);
+  cs.engine = (uint16_t)constrain(engine, 0, PROTO_ENGINE_RAW_MAX);
+  return cs;
+}
+
+struct ReplayResult {
+  uint32_t sent, suppressed;
+  int maxServoError;  // Degrees vs the noise-free input, any surface
+  uint32_t missedMoves;  // Real moves > band that left the packet unchanged
+};
+
+static int servoError(const ProtoCmdPacket& a, const ProtoCmdPacket& b) {
+  int e = abs(a.ailerons - b.ailerons);
+  e = max(e, abs(a.elevators - b.elevators));
+  e = max(e, abs(a.rudder - b.rudder));
+  return max(e, abs(a.engine - b.engine));
+}
+
+// 🌿 Same rule as transmitCommand(): identical packet, run ≥ limit, sticks near center
+static ReplayResult replay(bool filtered) {
+  ReplayResult r = {};
+  ProtoCmdPacket prev = {};
+  int same = 0;
+  rng = 1;
+  inputFilterReset();
+  ControlState lastPilot = pilotAt(0);
+
+  for (int i = 0; i < SESSION_TICKS; i++) {
+    ControlState pilot = pilotAt(i);
+    ControlState cs = withNoise(pilot);
+    if (filtered)
+      inputFilterApply(cs);
+
+    ProtoCmdPacket truth = constructMessage(pilot);
+    ProtoCmdPacket pkt = constructMessage(cs);
+    r.maxServoError = max(r.maxServoError, servoError(truth, pkt));
+
+    int deviation = abs(cs.aileron - PROTO_JOYSTICK_CENTER) + abs(cs.rudder - PROTO_JOYSTICK_CENTER) +
+                    abs(cs.elevators - PROTO_JOYSTICK_CENTER);
+    bool duplicate = memcmp(&pkt, &prev, PROTO_CMD_PACKET_SIZE) == 0;
+
+    bool realMove = abs(pilot.aileron - lastPilot.aileron) > INPUT_DEADBAND + INPUT_HYSTERESIS + 2 ||
+                    abs(pilot.elevators - lastPilot.elevators) > INPUT_DEADBAND + INPUT_HYSTERESIS + 2;
+    if (realMove && duplicate)
+      r.missedMoves++;
+    lastPilot = pilot;
+
+    if (duplicate && same >= PROTO_DUPLICATE_LIMIT && deviation < PROTO_IDLE_THRESHOLD) {
+      r.suppressed++;
+      continue;
+    }
+    same = duplicate ? same + 1 : 0;
+    prev = pkt;
+    r.sent++;
+  }
+  return r;
+}
+
+void setUp(void) {
+  inputFilterReset();
+}
+
+void tearDown(void) {}
+
+// ✅ Center snap, end snap and hysteresis on one axis
+void test_axis_quantization() {
+  ControlState cs = {};
+  cs.aileron = 130;
+  cs.elevators = 254;
+  cs.rudder = 1;
+  cs.engine = PROTO_ENGINE_RAW_MAX - 5;
+  inputFilterApply(cs);
+  TEST_ASSERT_EQUAL(PROTO_JOYSTICK_CENTER, cs.aileron);
+  TEST_ASSERT_EQUAL(255, cs.elevators);
+  TEST_ASSERT_EQUAL(0, cs.rudder);
+  TEST_ASSERT_EQUAL(PROTO_ENGINE_RAW_MAX, cs.engine);
+
+  const uint8_t in[] = {150, 151, 152, 149, 153, 151, 156, 131, 124};
+  const uint8_t out[] = {150, 150, 150, 150, 153, 153, 156, 131, 127};
+  for (size_t i = 0; i < sizeof(in); i++) {
+    cs.aileron = in[i];
+    inputFilterApply(cs);
+    TEST_ASSERT_EQUAL(out[i], cs.aileron);
+  }
+}
+
+// 📊 Replay: many more duplicates suppressed, no real input lost
+void test_replay_benchmark() {
+  ReplayResult raw = replay(false);
+  ReplayResult filt = replay(true);
+
+  char msg[192];
+  snprintf(msg, sizeof(msg), "raw:      %u sent, %u suppressed, max error %d, %u moves missed", (unsigned)raw.sent,
+           (unsigned)raw.suppressed, raw.maxServoError, (unsigned)raw.missedMoves);
+  TEST_MESSAGE(msg);
+  snprintf(msg, sizeof(msg), "filtered: %u sent, %u suppressed, max error %d, %u moves missed (of %u ticks)",
+           (unsigned)filt.sent, (unsigned)filt.suppressed, filt.maxServoError, (unsigned)filt.missedMoves,
+           (unsigned)SESSION_TICKS);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_GREATER_THAN(raw.suppressed * 5 + 100, filt.suppressed);
+  TEST_ASSERT_EQUAL(0, filt.missedMoves);
+  TEST_ASSERT_LESS_OR_EQUAL(6, filt.maxServoError);  // Degrees: deadband / band + noise after expo
+}
+
+// ✅ Real LoRaTask: a noisy idle stick still goes quiet (heartbeats only) in ECO
+void test_noisy_idle_link_goes_quiet() {
+  hal_setMillis(1000);
+  Serial.muted = true;
+  controlInit();
+  setupRadio();
+  loraStartScheduler(NULL);
+  LoRa.reset();
+  rng = 7;
+
+  for (int ms = 0; ms < 5000; ms++) {
+    if (ms % 4 == 0) {  // DualSense report rate
+      ControlState& w = controlBeginWrite();
+      w.aileron = noisy(128, 2);
+      w.elevators = noisy(128, 2);
+      w.rudder = noisy(128, 2);
+      controlEndWrite();
+    }
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+  Serial.muted = false;
+
+  TEST_ASSERT_GREATER_THAN(0, radioStats().heartbeats);
+  TEST_ASSERT_LESS_THAN(LoRa.sent.size() / 2, LoRa.sent.size() - radioStats().heartbeats);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_axis_quantization);
+  RUN_TEST(test_replay_benchmark);
+  RUN_TEST(test_noisy_idle_link_goes_quiet);
+
+  return UNITY_END();
+}
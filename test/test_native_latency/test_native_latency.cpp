@@ -0,0 +1,107 @@
+#include <unity.h>
+
+// ⏱️ Host simulator: stick-to-antenna latency histograms
+// Drives notify() with DualSense-rate reports and runs loraLoop() whenever the
+// TX timer / DIO0 would wake LoRaTask, then prints the same p50/p99/max report the firmware sends over Serial.
+
+#include <LoRa.h>
+
+#include "Latency.h"
+#include "PS5Joystick.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void setupPS5();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#define SIM_DURATION_MS 10000
+#define SIM_REPORT_PERIOD_MS 4   // ~250 Hz DualSense BT report rate
+#define SIM_PARSE_DELAY_US 150   // L2CAP → parser
+#define SIM_EVENT_DELAY_US 50    // parser → event callback
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  latencyReset();
+  loraStartScheduler(NULL);  // ⏰ TX timer phase-locked to the test clock
+  setupPS5();
+  ps5.setConnected(true);
+}
+
+void tearDown(void) {
+  ps5.setConnected(false);
+  Serial.muted = false;
+}
+
+// ✅ Buckets are contiguous, monotonic and at most 25% wide
+void test_bucket_mapping() {
+  uint16_t prev = 0;
+  for (uint32_t us = 0; us < 200000; us++) {
+    uint16_t idx = latencyBucketIndex(us);
+    TEST_ASSERT_TRUE(idx == prev || idx == prev + 1);
+    TEST_ASSERT_GREATER_OR_EQUAL(us, latencyBucketUpperUs(idx));
+    if (us >= 4)
+      TEST_ASSERT_LESS_OR_EQUAL(us + us / 4, latencyBucketUpperUs(idx));
+    prev = idx;
+  }
+  TEST_ASSERT_EQUAL(LAT_BUCKETS - 1, latencyBucketIndex(0xFFFFFFFFu));
+}
+
+// ✅ Percentiles land within one bucket of the exact value
+void test_percentiles() {
+  for (uint32_t us = 1; us <= 1000; us++)
+    latencyRecord(LAT_BUILD_TO_TX, us);
+
+  uint32_t p50 = latencyPercentile(LAT_BUILD_TO_TX, 50);
+  uint32_t p99 = latencyPercentile(LAT_BUILD_TO_TX, 99);
+  TEST_ASSERT_TRUE(p50 >= 500 && p50 <= 625);
+  TEST_ASSERT_TRUE(p99 >= 990 && p99 <= 1000);  // Clamped to the observed max
+  TEST_ASSERT_EQUAL(1000, latencyHistogram(LAT_BUILD_TO_TX).maxUs);
+  TEST_ASSERT_EQUAL(0, latencyPercentile(LAT_STICK_TO_AIR, 50));
+}
+
+// 🛩️ End-to-end: every stick movement reaches the air within one TX interval
+void test_simulated_stick_to_air() {
+  setupRadio();
+  LoRa.reset();
+  latencyReset();
+
+  FakePs5Report r = {};
+  for (int ms = 0; ms < SIM_DURATION_MS; ms++) {
+    uint32_t spent = 0;
+    if (ms % SIM_REPORT_PERIOD_MS == 0) {
+      r.lx = (int8_t)((ms / SIM_REPORT_PERIOD_MS) % 200 - 100);  // Continuous sweep
+      ps5.injectReport(r, SIM_PARSE_DELAY_US, SIM_EVENT_DELAY_US);
+      spent = SIM_PARSE_DELAY_US + SIM_EVENT_DELAY_US;
+    }
+    hal_advanceMicros(1000 - spent);
+    if (hal_takeNotify(NULL))  // 💤 LoRaTask only runs when notified
+      loraLoop();
+  }
+
+  const LatencyHistogram& e2e = latencyHistogram(LAT_STICK_TO_AIR);
+  TEST_ASSERT_GREATER_THAN(SIM_DURATION_MS / PROTO_CMD_INTERVAL_MS / 2, e2e.count);
+  TEST_ASSERT_LESS_OR_EQUAL((PROTO_CMD_INTERVAL_MS + 1) * 1000UL, e2e.maxUs);
+  TEST_ASSERT_EQUAL(SIM_PARSE_DELAY_US, latencyHistogram(LAT_BT_TO_PARSE).maxUs);
+  TEST_ASSERT_EQUAL(SIM_EVENT_DELAY_US, latencyHistogram(LAT_PARSE_TO_EVENT).maxUs);
+  TEST_ASSERT_EQUAL(latencyHistogram(LAT_NOTIFY_TO_BUILD).count, e2e.count);
+
+  Serial.muted = false;
+  latencyPrintReport();
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_bucket_mapping);
+  RUN_TEST(test_percentiles);
+  RUN_TEST(test_simulated_stick_to_air);
+
+  return UNITY_END();
+}
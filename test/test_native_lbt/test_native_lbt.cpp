@@ -0,0 +1,328 @@
+#include <unity.h>
+
+// 👂 Listen before talk (RADIO_LBT): CAD before each uplink frame, bounded
+// backoff, sent at LBT_MAX_DELAY_US at the latest. The fake radio's CAD asks
+// LoRa.channelBusy, here a neighbour bursting on a period out of step with our
+// TX tick — one that itself holds off while we are on air, so every collision
+// is a frame of ours started over its burst. LoRaTask and the neighbour are
+// stepped every 100 µs, so hold times come out close to what the timers asked.
+
+#include <LoRa.h>
+#include <SPI.h>
+
+#include <vector>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "SX1276.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#define STEP_US 100
+
+// 📡 The other 915 MHz user
+#define NEIGHBOUR_PERIOD_US 29000
+#define NEIGHBOUR_ON_AIR_US 8000
+
+struct Burst {
+  unsigned long startUs;
+  unsigned long endUs;
+};
+
+static bool neighbourActive = false;
+static bool neighbourOnAir = false;
+static unsigned long neighbourNextUs = 0;
+static std::vector<Burst> neighbourBursts;
+
+static void neighbourStep(unsigned long now) {
+  if (neighbourOnAir && now >= neighbourBursts.back().endUs) {
+    neighbourOnAir = false;
+    neighbourNextUs += NEIGHBOUR_PERIOD_US;
+  }
+  if (!neighbourOnAir && now >= neighbourNextUs) {
+    if (LoRa.txOnAir)
+      return;  // Polite: waits for our frame to end
+    neighbourOnAir = true;
+    neighbourBursts.push_back({now, now + NEIGHBOUR_ON_AIR_US});
+  }
+}
+
+static bool neighbourBusy(unsigned long us) {
+  return neighbourOnAir;
+}
+
+static void startNeighbour() {
+  neighbourActive = true;
+  neighbourOnAir = false;
+  neighbourNextUs = micros() + NEIGHBOUR_PERIOD_US / 3;
+  neighbourBursts.clear();
+  LoRa.channelBusy = neighbourBusy;
+}
+
+static bool alwaysBusy(unsigned long us) {
+  return true;
+}
+
+// ⏱️ Longest handover → air seen from outside (radio state polled every step)
+static unsigned long holdStartUs = 0;
+static unsigned long longestHoldUs = 0;
+
+static void runLoRaTaskUs(unsigned long us) {
+  for (unsigned long t = 0; t < us; t += STEP_US) {
+    size_t sent = LoRa.sent.size();
+    hal_advanceMicros(STEP_US);
+    if (neighbourActive)
+      neighbourStep(micros());
+    if (hal_takeNotify(NULL))
+      loraLoop();
+    if (radioState() == RadioState::LBT && !holdStartUs)
+      holdStartUs = micros();
+    if (LoRa.sent.size() != sent && holdStartUs) {
+      if (LoRa.sent.back().atUs - holdStartUs > longestHoldUs)
+        longestHoldUs = LoRa.sent.back().atUs - holdStartUs;
+      holdStartUs = 0;
+    }
+  }
+}
+
+// 💥 Frames whose time on air overlaps a neighbour burst
+static size_t collisions(size_t from) {
+  size_t n = 0;
+  for (size_t i = from; i < LoRa.sent.size(); i++) {
+    unsigned long start = LoRa.sent[i].atUs, end = start + LoRa.txDurationUs;
+    for (const Burst& b : neighbourBursts) {
+      if (start < b.endUs && b.startUs < end) {
+        n++;
+        break;
+      }
+    }
+  }
+  return n;
+}
+
+static void startLink() {
+  setupRadio();
+  loraStartScheduler(NULL);
+  holdStartUs = 0;
+  longestHoldUs = 0;
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  LoRa.setPins(LORA_CS, LORA_RST, LORA_DIO0);
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  Serial.muted = true;
+  randomSeed(1);
+  controlInit();
+  controlBeginWrite().ecoMode = false;  // A frame every PROTO_CMD_INTERVAL_MS
+  controlEndWrite();
+  neighbourActive = false;
+  radioSetListenBeforeTalk(true);
+}
+
+void tearDown(void) {
+  neighbourActive = false;
+  LoRa.channelBusy = nullptr;
+  for (int t = 0; t < 100 && (LoRa.txOnAir || radioState() == RadioState::LBT); t++)
+    runLoRaTaskUs(1000);  // Off the air before the next test resets the chip
+  sx1276Flush();
+  radioSetListenBeforeTalk(false);
+  radioSetDirectSpi(false);
+  radioSetSpiDma(false);
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ Clear channel: one CAD per frame, no backoff, nothing held past the CAD itself
+void test_clear_channel_one_cad_per_frame() {
+  startLink();
+  runLoRaTaskUs(1000000);
+
+  const RadioStats& r = radioStats();
+  TEST_ASSERT_GREATER_THAN(15, r.txStarted);
+  TEST_ASSERT_UINT32_WITHIN(1, r.txStarted, r.cadRuns);  // Last one may still be listening
+  TEST_ASSERT_EQUAL(r.cadRuns, LoRa.cadRuns);
+  TEST_ASSERT_EQUAL(0, r.cadBusy);
+  TEST_ASSERT_EQUAL(0, r.lbtHeld);
+  TEST_ASSERT_EQUAL(0, r.lbtForced);
+  TEST_ASSERT_LESS_THAN(LoRa.cadDurationUs + 2 * STEP_US, longestHoldUs);
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+}
+
+// ✅ Busy neighbour: frames back off and go out in its gaps, never later than the deadline
+void test_busy_channel_backs_off_within_deadline() {
+  startLink();
+  startNeighbour();
+  runLoRaTaskUs(2000000);
+
+  const RadioStats& r = radioStats();
+  TEST_ASSERT_GREATER_THAN(30, r.txStarted);
+  TEST_ASSERT_GREATER_THAN(0, r.cadBusy);
+  TEST_ASSERT_GREATER_THAN(0, r.lbtHeld);
+  TEST_ASSERT_LESS_OR_EQUAL(r.lbtHeld * (1 + LBT_MAX_DELAY_US / LBT_BACKOFF_MIN_US), r.cadBusy);
+  TEST_ASSERT_LESS_OR_EQUAL(LBT_MAX_DELAY_US + STEP_US, r.lbtDelayMaxUs);
+  TEST_ASSERT_LESS_OR_EQUAL(LBT_MAX_DELAY_US + 2 * STEP_US, longestHoldUs);
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%u frames: %u CAD, %u busy (%.1f%%), %u held, %u forced, longest hold %u us",
+           (unsigned)r.txStarted, (unsigned)r.cadRuns, (unsigned)r.cadBusy, r.cadBusy * 100.0 / r.cadRuns,
+           (unsigned)r.lbtHeld, (unsigned)r.lbtForced, (unsigned)r.lbtDelayMaxUs);
+  TEST_MESSAGE(msg);
+}
+
+// ✅ Channel never clears: every frame still goes out, at its deadline, cadence kept
+void test_jammed_channel_sends_at_deadline() {
+  LoRa.channelBusy = alwaysBusy;
+  startLink();
+  runLoRaTaskUs(1000000);
+
+  const RadioStats& r = radioStats();
+  TEST_ASSERT_GREATER_THAN(15, r.txStarted);
+  TEST_ASSERT_UINT32_WITHIN(1, r.cadRuns, r.cadBusy);  // Last CAD may still be running
+  TEST_ASSERT_UINT32_WITHIN(1, r.txStarted, r.lbtForced);
+  TEST_ASSERT_UINT32_WITHIN(1, r.txStarted, r.lbtHeld);
+  TEST_ASSERT_LESS_OR_EQUAL(LBT_MAX_DELAY_US + 2 * STEP_US, longestHoldUs);
+  TEST_ASSERT_GREATER_THAN(LBT_MAX_DELAY_US / 2, longestHoldUs);  // It did wait
+  for (size_t i = 2; i < LoRa.sent.size(); i++)  // Held frames don't pile up behind each other
+    TEST_ASSERT_UINT32_WITHIN(LBT_MAX_DELAY_US, PROTO_CMD_INTERVAL_MS * 1000UL,
+                              LoRa.sent[i].atUs - LoRa.sent[i - 1].atUs);
+}
+
+// 🚨 Priority frames don't wait for the channel
+void test_priority_frames_skip_cad() {
+  LoRa.channelBusy = alwaysBusy;
+  startLink();
+  runLoRaTaskUs(200000);
+  while (radioState() == RadioState::LBT || radioState() == RadioState::TX)
+    runLoRaTaskUs(STEP_US);
+
+  uint32_t cadBefore = radioStats().cadRuns;
+  size_t sentBefore = LoRa.sent.size();
+  controlBeginWrite().engine = 0;
+  controlEndWrite();
+  loraRequestPriority();
+  bool held = false;
+  for (int t = 0; t < 1000 && LoRa.sent.size() == sentBefore; t++) {
+    runLoRaTaskUs(STEP_US);
+    held |= radioState() == RadioState::LBT;
+  }
+
+  TEST_ASSERT_EQUAL(sentBefore + 1, LoRa.sent.size());
+  TEST_ASSERT_EQUAL(1, radioStats().priorityTx);
+  TEST_ASSERT_FALSE(held);
+  TEST_ASSERT_EQUAL(cadBefore, radioStats().cadRuns);
+}
+
+// 🚨 A burst starting during a hold doesn't wait out the backoff: held frame now, burst on its TX done
+void test_priority_cuts_hold_short() {
+  LoRa.channelBusy = alwaysBusy;
+  startLink();
+  runLoRaTaskUs(200000);
+  while (radioState() != RadioState::LBT)
+    runLoRaTaskUs(STEP_US);
+  runLoRaTaskUs(LBT_BACKOFF_MIN_US);  // Well into the hold, deadline still ahead
+  TEST_ASSERT_EQUAL(RadioState::LBT, radioState());
+
+  size_t sentBefore = LoRa.sent.size();
+  uint32_t forcedBefore = radioStats().lbtForced;
+  unsigned long requestUs = micros();
+  controlBeginWrite().engine = 0;
+  controlEndWrite();
+  loraRequestPriority();
+  for (int t = 0; t < 1000 && LoRa.sent.size() < sentBefore + 2; t++)
+    runLoRaTaskUs(STEP_US);
+
+  TEST_ASSERT_EQUAL(sentBefore + 2, LoRa.sent.size());
+  TEST_ASSERT_LESS_OR_EQUAL(requestUs + STEP_US, LoRa.sent[sentBefore].atUs);  // Held frame at once
+#ifdef PROTO_BIDIRECTIONAL
+  const unsigned long slotUs = TDMA_TLM_SLOT_US;  // The held frame's telemetry answer still comes first
+#else
+  const unsigned long slotUs = 0;
+#endif
+  TEST_ASSERT_LESS_OR_EQUAL(LoRa.sent[sentBefore].atUs + LORA_CMD_AIRTIME_US + slotUs + 2 * STEP_US,
+                            LoRa.sent[sentBefore + 1].atUs);  // Burst right behind it
+  TEST_ASSERT_EQUAL(1, radioStats().priorityTx);
+  TEST_ASSERT_EQUAL(1, radioStats().lbtCutShort);
+  TEST_ASSERT_EQUAL(forcedBefore, radioStats().lbtForced);
+}
+
+struct LbtSession {
+  size_t frames;
+  size_t collided;
+  RadioStats stats;
+};
+
+static LbtSession runNeighbourSession(bool lbt, bool direct, bool dma) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  randomSeed(1);
+  radioSetListenBeforeTalk(lbt);
+  radioSetDirectSpi(direct);
+  radioSetSpiDma(dma);
+  startLink();
+  startNeighbour();
+  size_t from = LoRa.sent.size();
+  runLoRaTaskUs(3000000);
+
+  LbtSession s = {LoRa.sent.size() - from, collisions(from), radioStats()};
+  neighbourActive = false;
+  LoRa.channelBusy = nullptr;
+  for (int t = 0; t < 100 && (LoRa.txOnAir || radioState() == RadioState::LBT); t++)
+    runLoRaTaskUs(1000);
+  sx1276Flush();
+  return s;
+}
+
+// 📊 Same neighbour, blind vs LBT, on each radio path: collisions, frames kept
+void test_lbt_cuts_collisions() {
+  const struct {
+    const char* name;
+    bool direct;
+    bool dma;
+  } paths[] = {{"library", false, false}, {"direct SPI", true, false}, {"SPI DMA", false, true}};
+
+  for (const auto& p : paths) {
+    LbtSession blind = runNeighbourSession(false, p.direct, p.dma);
+    LbtSession lbt = runNeighbourSession(true, p.direct, p.dma);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "%s: blind %u/%u frames collided | LBT %u/%u (%u ticks merged), %.1f%% CAD busy, %u forced, longest hold %u us",
+             p.name, (unsigned)blind.collided, (unsigned)blind.frames, (unsigned)lbt.collided, (unsigned)lbt.frames,
+             (unsigned)lbt.stats.txMerged,
+             lbt.stats.cadBusy * 100.0 / lbt.stats.cadRuns, (unsigned)lbt.stats.lbtForced,
+             (unsigned)lbt.stats.lbtDelayMaxUs);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_GREATER_THAN(50, blind.frames);
+    // Held, never dropped: a tick that lands behind a held frame + its telemetry slot rides on the next frame
+    TEST_ASSERT_UINT32_WITHIN(1, blind.frames, lbt.frames + lbt.stats.txMerged - blind.stats.txMerged);
+    TEST_ASSERT_EQUAL(0, blind.stats.cadRuns);
+    TEST_ASSERT_GREATER_THAN(blind.frames / 4, blind.collided);
+    TEST_ASSERT_LESS_THAN(blind.collided / 3, lbt.collided);
+    TEST_ASSERT_LESS_OR_EQUAL(LBT_MAX_DELAY_US + STEP_US, lbt.stats.lbtDelayMaxUs);
+    TEST_ASSERT_EQUAL(0, SPI.csErrors);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_clear_channel_one_cad_per_frame);
+  RUN_TEST(test_busy_channel_backs_off_within_deadline);
+  RUN_TEST(test_jammed_channel_sends_at_deadline);
+  RUN_TEST(test_priority_frames_skip_cad);
+  RUN_TEST(test_priority_cuts_hold_short);
+  RUN_TEST(test_lbt_cuts_collisions);
+
+  return UNITY_END();
+}
@@ -0,0 +1,251 @@
+#include <unity.h>
+
+// 📶 Link quality estimator tests
+// Unit checks on hand-made sequence streams, then the real ground code next to
+// a simulated air side that answers each heard command with sequenced
+// telemetry over a link that drops frames in both directions.
+// ⏱️ The echo age trailer byte gives round-trip samples without clock sync.
+
+#include <LoRa.h>
+
+#include <string>
+
+#include "Airtime.h"
+#include "Display.h"
+#include "Latency.h"
+#include "LinkQuality.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#define SIM_DURATION_MS 20000
+#define SIM_STEP_US 100
+#define UP_DROP_EVERY 7    // Every 7th command never reaches the air
+#define DOWN_DROP_EVERY 5  // Every 5th telemetry frame never reaches the ground
+
+struct TlmFrame {
+  uint8_t bytes[PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE];
+};
+
+static TlmFrame makeTelemetry(uint8_t seq, uint8_t echo, uint8_t echoAgeMs) {
+  TlmFrame f = {};  // 🔁 No reliable acks
+  ProtoTlmPacket p = {};
+  p.magic = PROTO_TLM_MAGIC;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+  memcpy(f.bytes, &p, PROTO_TLM_PACKET_SIZE);
+  f.bytes[PROTO_TLM_PACKET_SIZE] = seq;
+  f.bytes[PROTO_TLM_PACKET_SIZE + 1] = echo;
+  f.bytes[PROTO_TLM_PACKET_SIZE + 2] = echoAgeMs;
+  return f;
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  linkQualityReset();
+  latencyReset();
+}
+
+void tearDown(void) {
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+  Serial.capture = false;
+  Serial.captured.clear();
+}
+
+// ✅ Telemetry gaps → downlink losses / bursts, echo gaps → uplink losses
+void test_estimator_counts_both_directions() {
+  uint32_t t = 0;
+  uint8_t echo = 0;
+  for (uint8_t seq = 0; seq < 20; seq++) {
+    echo += (seq == 10) ? 3 : 1;  // Two commands lost before tlm 10
+    t += 50000;
+    if (seq == 5 || seq == 6 || seq == 7)
+      continue;  // Downlink burst of 3
+    linkOnTelemetry(t, true, seq, echo, LINK_ECHO_AGE_UNKNOWN);
+  }
+
+  const LinkQuality& q = linkQuality();
+  TEST_ASSERT_EQUAL(17, q.down.received);
+  TEST_ASSERT_EQUAL(3, q.down.lost);
+  TEST_ASSERT_EQUAL(3, q.down.maxBurst);
+  TEST_ASSERT_EQUAL(0, q.down.burst);
+  TEST_ASSERT_EQUAL(2, q.up.lost);
+  TEST_ASSERT_EQUAL(2, q.up.maxBurst);
+  TEST_ASSERT_TRUE(q.sequenced);
+  TEST_ASSERT_GREATER_THAN(0.0f, q.down.lossEwma);
+  TEST_ASSERT_UINT32_WITHIN(100, 50000, q.meanIntervalUs);  // Gaps count as several intervals
+  TEST_ASSERT_LESS_THAN(1000, q.jitterUs);
+}
+
+// ✅ Inter-arrival jitter tracks the spread, also without the trailer
+void test_jitter_without_sequence() {
+  uint32_t t = 0;
+  for (int i = 0; i < 200; i++) {
+    t += (i & 1) ? 48000 : 52000;
+    linkOnTelemetry(t, false, 0, 0, 0);
+  }
+  const LinkQuality& q = linkQuality();
+  TEST_ASSERT_FALSE(q.sequenced);
+  TEST_ASSERT_EQUAL(200, q.down.received);
+  TEST_ASSERT_EQUAL(0, q.down.lost);
+  TEST_ASSERT_UINT32_WITHIN(300, 50000, q.meanIntervalUs);
+  TEST_ASSERT_UINT32_WITHIN(600, 2000, q.jitterUs);
+}
+
+// ✅ RTT = arrival − send time of the echoed upSeq − air hold time
+void test_round_trip_from_echo_age() {
+  uint32_t sentUs[40];
+  for (uint8_t i = 0; i < 40; i++) {
+    sentUs[i] = micros();
+    linkUplinkSent();  // upSeq i
+    hal_advanceMicros(50000);
+  }
+
+  linkOnTelemetry(sentUs[39] + 12000, true, 0, 39, 5);  // Held 5 ms on the air
+  TEST_ASSERT_EQUAL(7000, linkQuality().lastRttUs);
+  TEST_ASSERT_EQUAL(5, linkQuality().lastEchoAgeMs);
+
+  linkOnTelemetry(sentUs[39] + 62000, true, 1, 39, 55);  // Same echo again → no new sample
+  linkOnTelemetry(sentUs[39] + 99000, true, 2, 40, LINK_ECHO_AGE_UNKNOWN);  // Air can't tell
+  linkOnTelemetry(sentUs[39] + 120000, true, 3, 41, 200);  // Never sent by us
+  linkOnTelemetry(sentUs[39] + 140000, true, 4, 7, 1);     // Evicted from the send history
+
+  const LatencyHistogram& h = latencyHistogram(LAT_ROUND_TRIP);
+  TEST_ASSERT_EQUAL(1, h.count);
+  TEST_ASSERT_EQUAL(7000, h.maxUs);
+}
+
+// 📄 CSV dump: one row per non-empty bucket, counts add up per stage
+void test_csv_dump() {
+  for (uint32_t us = 5000; us < 15000; us += 250)
+    latencyRecord(LAT_ROUND_TRIP, us);
+  latencyRecord(LAT_STICK_TO_AIR, 1234);
+
+  Serial.capture = true;
+  latencyPrintCsv();
+  Serial.capture = false;
+
+  const std::string& csv = Serial.captured;
+  TEST_ASSERT_EQUAL(0, csv.find("stage,bucket_upper_us,count\n"));
+  uint32_t rttRows = 0, rttCount = 0, stickCount = 0;
+  size_t pos = csv.find('\n') + 1;
+  while (pos < csv.size()) {
+    size_t eol = csv.find('\n', pos);
+    std::string row = csv.substr(pos, eol - pos);
+    pos = eol + 1;
+    size_t c1 = row.find(','), c2 = row.rfind(',');
+    TEST_ASSERT_TRUE(c1 != std::string::npos && c2 > c1);
+    uint32_t count = (uint32_t)atoi(row.c_str() + c2 + 1);
+    if (row.compare(0, c1, "cmd>air>gnd") == 0) {
+      rttRows++;
+      rttCount += count;
+    } else if (row.compare(0, c1, "stick>air") == 0) {
+      stickCount += count;
+      TEST_ASSERT_GREATER_OR_EQUAL(1234, atoi(row.c_str() + c1 + 1));
+    }
+  }
+  TEST_ASSERT_EQUAL(40, rttCount);
+  TEST_ASSERT_GREATER_THAN(1, rttRows);
+  TEST_ASSERT_EQUAL(1, stickCount);
+}
+
+#ifdef PROTO_BIDIRECTIONAL  // Telemetry RX only exists on a two-way link
+// 🛩️ Ground + simulated air over a lossy link: the estimate matches the truth
+void test_simulated_lossy_link() {
+  setupRadio();  // Init packet is uplink seq 0
+  loraStartScheduler(NULL);
+
+  size_t seenCommands = 0;
+  uint32_t airHeard = 0, airSent = 0, upLost = 0, downLost = 0;
+  uint8_t tlmSeq = 0, echo = 0;
+  unsigned long heardUs = 0, replyAtUs = 0;
+  bool replyPending = false;
+  const unsigned long endUs = micros() + SIM_DURATION_MS * 1000UL;
+
+  while (micros() < endUs) {
+    hal_advanceMicros(SIM_STEP_US);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+
+    for (; seenCommands < LoRa.sent.size(); seenCommands++) {
+      if (seenCommands % UP_DROP_EVERY == UP_DROP_EVERY - 1) {
+        upLost++;
+        continue;
+      }
+      airHeard++;
+      echo = (uint8_t)seenCommands;  // Ground stamps frame n with upSeq n
+      heardUs = LoRa.sent[seenCommands].atUs + LORA_CMD_AIRTIME_US;
+      replyAtUs = heardUs + TDMA_TURNAROUND_US;
+      replyPending = true;
+    }
+
+    if (replyPending && micros() >= replyAtUs + LORA_TLM_AIRTIME_US) {
+      replyPending = false;
+      TlmFrame f = makeTelemetry(tlmSeq++, echo, (uint8_t)((replyAtUs - heardUs) / 1000));
+      if (airSent++ % DOWN_DROP_EVERY == DOWN_DROP_EVERY - 1)
+        downLost++;
+      else
+        LoRa.injectRx(f.bytes, sizeof(f.bytes));
+    }
+  }
+
+  const LinkQuality& q = linkQuality();
+  char msg[160];
+  snprintf(msg, sizeof(msg), "down %u/%u lost (truth %u, EWMA %.1f%%) | up %u lost (truth %u, EWMA %.1f%%) | jitter %u us",
+           (unsigned)q.down.lost, (unsigned)(q.down.lost + q.down.received), (unsigned)downLost,
+           q.down.lossEwma * 100.0f, (unsigned)q.up.lost, (unsigned)upLost, q.up.lossEwma * 100.0f, (unsigned)q.jitterUs);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_UINT32_WITHIN(1, downLost, q.down.lost);
+  TEST_ASSERT_UINT32_WITHIN(2, upLost, q.up.lost);
+  TEST_ASSERT_FLOAT_WITHIN(0.08f, 1.0f / DOWN_DROP_EVERY, q.down.lossEwma);
+  TEST_ASSERT_FLOAT_WITHIN(0.08f, 1.0f / UP_DROP_EVERY, q.up.lossEwma);
+
+  // ⏱️ One RTT per delivered telemetry frame: both airtimes + the sub-ms part
+  // of the turnaround the 1 ms age can't express + the 100 µs sim step
+  const LatencyHistogram& rtt = latencyHistogram(LAT_ROUND_TRIP);
+  snprintf(msg, sizeof(msg), "RTT n=%u p50 %u us p99 %u us max %u us (airtime both ways %u us)", (unsigned)rtt.count,
+           (unsigned)latencyPercentile(LAT_ROUND_TRIP, 50), (unsigned)latencyPercentile(LAT_ROUND_TRIP, 99),
+           (unsigned)rtt.maxUs, (unsigned)(LORA_CMD_AIRTIME_US + LORA_TLM_AIRTIME_US));
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(airSent - downLost, rtt.count);
+  TEST_ASSERT_GREATER_OR_EQUAL(LORA_CMD_AIRTIME_US + LORA_TLM_AIRTIME_US, q.lastRttUs);
+  TEST_ASSERT_LESS_OR_EQUAL(LORA_CMD_AIRTIME_US + LORA_TLM_AIRTIME_US + 1000 + 2 * SIM_STEP_US, rtt.maxUs);
+
+  // 🖥️ Frame 2 swaps the static rate row for link quality
+  SSD1306Wire hud(0x3c);
+  OLEDDisplayUiState state;
+  drawFrame2(&hud, &state, 0, 0);
+  TEST_ASSERT_TRUE(hud.hasText("Loss D"));
+
+  // 🩺 Frame 3 shows the round trip
+  SSD1306Wire diag(0x3c);
+  drawFrame3(&diag, &state, 0, 0);
+  TEST_ASSERT_TRUE(diag.hasText("RTT "));
+  TEST_ASSERT_FALSE(diag.hasText("RTT --"));
+}
+#endif
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_estimator_counts_both_directions);
+  RUN_TEST(test_jitter_without_sequence);
+  RUN_TEST(test_round_trip_from_echo_age);
+  RUN_TEST(test_csv_dump);
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_simulated_lossy_link);
+#endif
+
+  return UNITY_END();
+}
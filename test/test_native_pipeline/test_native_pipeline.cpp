@@ -0,0 +1,274 @@
+#include <unity.h>
+
+// 💻 Host-native pipeline tests — builds the real src/*.cpp against lib/NativeHAL
+// (fake LoRa, ps5Controller, SSD1306Wire and a simulated millis()).
+// Run with: pio test -e native
+
+#include <LoRa.h>
+
+#include <chrono>
+
+#include "Display.h"
+#include "TxScheduler.h"
+#include "PS5Joystick.h"
+#include "common.h"
+#include "protocol.h"
+
+// Production entry points (declared in main.h, which also defines globals)
+void setupRadio();
+void setupPS5();
+void setupDisplay();
+void hudServicePaging(OLEDDisplayUi& ui, uint8_t& shownPage);
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+const ProtoCmdPacket& constructMessage(const ControlState& cs);
+extern bool lora_initialized;
+
+static FakePs5Report idleReport() {
+  FakePs5Report r = {};
+  r.lx = -1;  // 127 after +128 offset → stick centered
+  r.rx = -1;
+  r.ry = -1;
+  return r;
+}
+
+// 🧮 Average wall-clock nanoseconds of fn() over n calls
+template <typename Fn>
+static double nsPerCall(int n, Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++)
+    fn();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+static void report(const char* name, double ns) {
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%s: %.0f ns/call", name, ns);
+  TEST_MESSAGE(msg);
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.beginOk = true;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  loraStartScheduler(NULL);  // ⏰ TX timer phase-locked to the test clock
+  setupPS5();
+  ps5.setConnected(true);
+  ps5.injectReport(idleReport());
+}
+
+void tearDown(void) {
+  ps5.setConnected(false);
+  Serial.muted = false;
+}
+
+// ✅ setupRadio() applies the shared protocol radio config and sends the init packet
+void test_setup_radio_applies_protocol_config() {
+  setupRadio();
+
+  TEST_ASSERT_TRUE(lora_initialized);
+  TEST_ASSERT_EQUAL(PROTO_LORA_FREQUENCY_HZ, LoRa.frequency);
+  TEST_ASSERT_EQUAL(PROTO_LORA_SF, LoRa.spreadingFactor);
+  TEST_ASSERT_EQUAL(PROTO_LORA_BANDWIDTH_HZ, LoRa.bandwidth);
+  TEST_ASSERT_EQUAL(PROTO_LORA_CR, LoRa.codingRate);
+  TEST_ASSERT_EQUAL(PROTO_LORA_TX_POWER, LoRa.txPower);
+  TEST_ASSERT_TRUE(LoRa.crc);
+
+  TEST_ASSERT_EQUAL(1, LoRa.sent.size());
+  TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, LoRa.sent[0].data.size());
+  TEST_ASSERT_EQUAL(PROTO_CMD_MAGIC, LoRa.sent[0].data[0]);
+}
+
+// ✅ A failed radio init leaves the TX path disabled
+void test_setup_radio_failure_disables_tx() {
+  LoRa.beginOk = false;
+  setupRadio();
+  TEST_ASSERT_FALSE(lora_initialized);
+
+  hal_advanceMillis(PROTO_CMD_INTERVAL_MS * 4);
+  loraLoop();
+  TEST_ASSERT_EQUAL(0, LoRa.sent.size());
+}
+
+// ✅ notify() maps controller reports onto the control globals
+void test_notify_maps_controller_report() {
+  FakePs5Report r = idleReport();
+  r.lx = 127;  // full right aileron
+  r.cross = true;
+  hal_advanceMillis(25);  // past the 20 ms notify gate
+  ps5.injectReport(r);
+
+  ControlState cs = controlSnapshot();
+  TEST_ASSERT_EQUAL(255, cs.aileron);
+  TEST_ASSERT_EQUAL(127, cs.rudder);
+  TEST_ASSERT_FALSE(cs.emergencyStop);
+
+  r.cross = false;
+  r.circle = true;
+  hal_advanceMillis(25);
+  ps5.injectReport(r);
+  TEST_ASSERT_TRUE(controlSnapshot().emergencyStop);
+}
+
+// ✅ loraLoop() transmits valid binary frames at PROTO_CMD_INTERVAL_MS
+void test_lora_loop_cadence_and_checksum() {
+  setupRadio();
+  LoRa.reset();
+
+  for (int ms = 0; ms < 1000; ms++) {
+    hal_advanceMillis(1);
+    loraLoop();
+  }
+
+  TEST_ASSERT_EQUAL(1000 / PROTO_CMD_INTERVAL_MS, LoRa.sent.size());
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, f.data.size());
+    TEST_ASSERT_EQUAL(PROTO_CMD_MAGIC, f.data[0]);
+    TEST_ASSERT_EQUAL(proto_checksum(f.data.data(), PROTO_CMD_PACKET_SIZE - 1), f.data[PROTO_CMD_PACKET_SIZE - 1]);
+  }
+}
+
+// 🧮 Run LoRaTask for ms of simulated time; polled = old 1 ms vTaskDelayUntil loop,
+// otherwise wake only on a notification (TX timer / DIO0)
+static void runLoRaTask(int ms, bool polled) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL) > 0 || polled)
+      loraLoop();
+  }
+}
+
+static void reportScheduler(const char* name) {
+  const TxSchedulerStats& s = txSchedulerStats();
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: %u wakeups/%u ms, %u slots, %u TX-done, jitter max %u us", name,
+           (unsigned)s.wakeups, (unsigned)s.windowMs, (unsigned)s.slots, (unsigned)s.txDone,
+           (unsigned)s.jitterMaxUs);
+  TEST_MESSAGE(msg);
+}
+
+// ⏰ Timer + DIO0 notifications replace the 1 ms poll: same TX cadence, a
+// fraction of the wakeups
+void test_event_driven_scheduler_wakeups() {
+  setupRadio();
+  LoRa.txDurationUs = 20000;  // DIO0 TX-done ~20 ms after each endPacket()
+
+  loraStartScheduler(NULL);
+  runLoRaTask(2 * TX_SCHED_WINDOW_MS + PROTO_CMD_INTERVAL_MS, true);
+  reportScheduler("1 ms poll");
+  TEST_ASSERT_GREATER_OR_EQUAL(TX_SCHED_WINDOW_MS, txSchedulerStats().wakeups);
+
+  LoRa.reset();
+  loraStartScheduler(NULL);
+  runLoRaTask(2 * TX_SCHED_WINDOW_MS + PROTO_CMD_INTERVAL_MS, false);
+  reportScheduler("event-driven");
+
+  const TxSchedulerStats& s = txSchedulerStats();
+  const uint32_t slots = TX_SCHED_WINDOW_MS / PROTO_CMD_INTERVAL_MS;
+  TEST_ASSERT_UINT32_WITHIN(1, slots, s.slots);
+  TEST_ASSERT_UINT32_WITHIN(1, slots, s.txDone);
+  TEST_ASSERT_LESS_OR_EQUAL(2 * (slots + 1), s.wakeups);
+  TEST_ASSERT_EQUAL(0, s.jitterMaxUs);  // Slots serviced exactly on the timer deadline
+  TEST_ASSERT_EQUAL(2 * slots + 1, LoRa.sent.size());
+  LoRa.txDurationUs = 0;
+}
+
+// ✅ drawFrame1() renders the arm state pill from the control globals
+void test_draw_frame1_shows_arm_state() {
+  SSD1306Wire hud(0x3c);
+  OLEDDisplayUiState state;
+
+  controlBeginWrite().emergencyStop = true;
+  controlEndWrite();
+  drawFrame1(&hud, &state, 0, 0);
+  TEST_ASSERT_TRUE(hud.hasText("STOP"));
+
+  hud.clear();
+  controlBeginWrite().emergencyStop = false;
+  controlEndWrite();
+  drawFrame1(&hud, &state, 0, 0);
+  TEST_ASSERT_TRUE(hud.hasText("ARM"));
+}
+
+// ✅ Options pages the HUD: one frame per press, wrapping at the last one
+void test_options_pages_hud_frames() {
+  setupDisplay();
+  display.switchToFrame(0);
+  const uint8_t before = controlSnapshot().hudPageCount;
+  uint8_t shownPage = before;  // DisplayTask's copy
+
+  FakePs5Report r = idleReport();
+  r.options = true;
+  for (int t = 0; t < 250; t += 25) {  // Held for 250 ms: a single press
+    hal_advanceMillis(25);
+    ps5.injectReport(r);
+  }
+  TEST_ASSERT_EQUAL((uint8_t)(before + 1), controlSnapshot().hudPageCount);
+  hudServicePaging(display, shownPage);
+  TEST_ASSERT_EQUAL(1, display.state.currentFrame);
+  TEST_ASSERT_EQUAL((uint8_t)(before + 1), shownPage);
+  hudServicePaging(display, shownPage);  // No new press
+  TEST_ASSERT_EQUAL(1, display.state.currentFrame);
+
+  for (int i = 0; i < 2; i++) {
+    hal_advanceMillis(400);
+    ps5.injectReport(r);
+    hudServicePaging(display, shownPage);
+  }
+  TEST_ASSERT_EQUAL((uint8_t)(before + 3), controlSnapshot().hudPageCount);
+  TEST_ASSERT_EQUAL(0, display.state.currentFrame);  // 3 frames: wrapped
+}
+
+// ⏱️ Hot-path profile: wall-clock ns/call are reported only (a loaded host
+// makes them noisy); the asserts check the work done on the simulated clock
+void test_profile_hot_paths() {
+  setupRadio();
+  LoRa.reset();
+  SSD1306Wire hud(0x3c);
+  OLEDDisplayUiState state;
+  FakePs5Report r = idleReport();
+
+  double loopNs = nsPerCall(20000, [] {
+    hal_advanceMillis(1);
+    loraLoop();
+  });
+  const ControlState cs = controlSnapshot();
+  double constructNs = nsPerCall(20000, [&cs] { constructMessage(cs); });
+  double notifyNs = nsPerCall(20000, [&r] {
+    hal_advanceMillis(21);
+    r.lx = (int8_t)(r.lx + 3);
+    ps5.injectReport(r);
+  });
+  double drawNs = nsPerCall(5000, [&hud, &state] {
+    hud.clear();
+    drawFrame1(&hud, &state, 0, 0);
+  });
+
+  report("loraLoop", loopNs);
+  report("constructMessage", constructNs);
+  report("notify", notifyNs);
+  report("drawFrame1", drawNs);
+
+  TEST_ASSERT_EQUAL(20000 / PROTO_CMD_INTERVAL_MS, LoRa.sent.size());  // One frame per slot, no extra work
+  TEST_ASSERT_EQUAL((uint8_t)(-1 + 3 * 20000), (uint8_t)(controlSnapshot().aileron - 128));  // Every report published
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_setup_radio_applies_protocol_config);
+  RUN_TEST(test_setup_radio_failure_disables_tx);
+  RUN_TEST(test_notify_maps_controller_report);
+  RUN_TEST(test_lora_loop_cadence_and_checksum);
+  RUN_TEST(test_event_driven_scheduler_wakeups);
+  RUN_TEST(test_draw_frame1_shows_arm_state);
+  RUN_TEST(test_options_pages_hud_frames);
+  RUN_TEST(test_profile_hot_paths);
+
+  return UNITY_END();
+}
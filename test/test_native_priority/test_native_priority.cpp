@@ -0,0 +1,152 @@
+#include <unity.h>
+
+// 🚨 Priority lane tests (e-stop / disarm)
+// Circle presses go through the real notify() → LoRaTask path against the fake
+// SX1276 with realistic time on air; press-to-air lands in LAT_ESTOP_TO_AIR.
+
+#include <LoRa.h>
+
+#include "Airtime.h"
+#include "Latency.h"
+#include "PS5Joystick.h"
+#include "RadioState.h"
+#include "RateControl.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void setupPS5();
+void loraLoop();
+
+#define NOTIFY_GAP_MS 25  // notify() ignores reports closer than 20 ms
+
+// 💤 LoRaTask: run only when the timer / DIO0 / priority request notified it
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+static void press(bool cross, bool circle) {
+  FakePs5Report r = {};
+  r.cross = cross;
+  r.circle = circle;
+  ps5.injectReport(r);
+  if (hal_takeNotify(NULL))  // BT task gave the notification: LoRaTask runs next
+    loraLoop();
+  runLoRaTask(NOTIFY_GAP_MS);
+}
+
+static bool isStopFrame(const FakeLoRaFrame& f) {
+  return f.data.size() == PROTO_CMD_PACKET_SIZE && f.data[0] == PROTO_CMD_MAGIC && f.data[1] == 0;
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  Serial.muted = true;
+  controlInit();  // ECO on: idle sticks go silent
+  controlBeginWrite().engine = 3000;
+  controlEndWrite();
+  latencyReset();
+  setupPS5();
+  ps5.setConnected(true);
+  setupRadio();
+  loraStartScheduler(NULL);
+  press(true, false);  // ❌ Arm
+  press(false, false);
+}
+
+void tearDown(void) {
+  ps5.setConnected(false);
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ ECO-silent idle link: the stop goes out at once, PRIORITY_REPEAT_COUNT times
+void test_estop_bypasses_eco_and_tick() {
+  runLoRaTask(3000);  // Idle sticks: duplicates suppressed, rate stretched to cruise
+  size_t before = LoRa.sent.size();
+  unsigned long pressUs = micros();
+  press(false, true);  // ⭕
+  runLoRaTask(200);
+
+  size_t stops = 0;
+  unsigned long firstUs = 0;
+  for (size_t i = before; i < LoRa.sent.size(); i++) {
+    if (!isStopFrame(LoRa.sent[i]))
+      continue;
+    if (!stops++)
+      firstUs = LoRa.sent[i].atUs;
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(PRIORITY_REPEAT_COUNT, stops);
+  TEST_ASSERT_EQUAL(PRIORITY_REPEAT_COUNT, radioStats().priorityTx);
+  TEST_ASSERT_LESS_THAN(1000, firstUs - pressUs);  // No wait for the (stretched) TX tick
+  TEST_ASSERT_EQUAL(1, latencyHistogram(LAT_ESTOP_TO_AIR).count);
+}
+
+// ✅ An on-air TX is never aborted: the stop follows its TX done (and telemetry slot)
+void test_estop_waits_for_tx_on_air() {
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  runLoRaTask(PROTO_CMD_INTERVAL_MS - NOTIFY_GAP_MS);
+  while (radioState() != RadioState::TX)
+    runLoRaTask(1);
+  unsigned long txEndUs = LoRa.sent.back().atUs + LoRa.txDurationUs;
+  size_t i = LoRa.sent.size();
+
+  press(false, true);
+  runLoRaTask(200);
+
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  while (i < LoRa.sent.size() && !isStopFrame(LoRa.sent[i]))
+    i++;
+  TEST_ASSERT_LESS_THAN(LoRa.sent.size(), i);
+  TEST_ASSERT_GREATER_OR_EQUAL(txEndUs, LoRa.sent[i].atUs);
+#ifdef PROTO_BIDIRECTIONAL
+  TEST_ASSERT_GREATER_OR_EQUAL(txEndUs + TDMA_TLM_SLOT_US, LoRa.sent[i].atUs);
+#endif
+}
+
+// 📊 Press-to-air at every phase of the schedule vs the regular slot path
+void test_estop_latency_histogram() {
+  for (int n = 0; n < 40; n++) {
+    runLoRaTask(37 + n * 7 % RATE_MAX_INTERVAL_MS);  // Walk the press across the schedule
+    press(false, true);   // ⭕ Stop
+    runLoRaTask(150);
+    press(true, false);   // ❌ Re-arm
+    press(false, false);
+  }
+
+  const LatencyHistogram& h = latencyHistogram(LAT_ESTOP_TO_AIR);
+  char msg[128];
+  snprintf(msg, sizeof(msg), "estop>air n=%u p50 %u us p99 %u us max %u us (cruise tick %u ms)", (unsigned)h.count,
+           (unsigned)latencyPercentile(LAT_ESTOP_TO_AIR, 50), (unsigned)latencyPercentile(LAT_ESTOP_TO_AIR, 99),
+           (unsigned)h.maxUs, (unsigned)RATE_MAX_INTERVAL_MS);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_EQUAL(40, h.count);
+#ifdef PROTO_BIDIRECTIONAL
+  TEST_ASSERT_LESS_OR_EQUAL(TDMA_CMD_SLOT_US + TDMA_TLM_SLOT_US + 1000, h.maxUs);  // At most one frame + slot
+#else
+  TEST_ASSERT_LESS_OR_EQUAL(LORA_CMD_AIRTIME_US + 1000, h.maxUs);
+#endif
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+
+  Serial.muted = false;
+  latencyPrintReport();
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_estop_bypasses_eco_and_tick);
+  RUN_TEST(test_estop_waits_for_tx_on_air);
+  RUN_TEST(test_estop_latency_histogram);
+
+  return UNITY_END();
+}
@@ -0,0 +1,103 @@
+#include <unity.h>
+
+// 📡 Radio state machine tests (IDLE / TX / RX_WINDOW)
+// The fake SX1276 counts every mode change that cuts an on-air TX short
+// (LoRa.txAborts) — the state machine must keep it at zero under any load.
+
+#include <LoRa.h>
+
+#include "RadioState.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+// 💤 LoRaTask: run only when the timer / DIO0 notified it
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = 0;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+}
+
+void tearDown(void) {
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ TX longer than the command interval: slots are deferred, never aborted
+void test_long_tx_never_aborted() {
+  LoRa.txDurationUs = (PROTO_CMD_INTERVAL_MS + 20) * 1000UL;
+  runLoRaTask(2000);
+
+  const RadioStats& r = radioStats();
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  TEST_ASSERT_GREATER_THAN(0, r.txDeferred);
+  TEST_ASSERT_EQUAL(0, r.txTimeouts);
+  TEST_ASSERT_EQUAL(0, r.spuriousTxDone);
+  TEST_ASSERT_UINT32_WITHIN(1, r.txStarted, r.txCompleted);
+  TEST_ASSERT_EQUAL(r.txStarted, LoRa.sent.size());
+}
+
+// ✅ The RX window opens only once TX done arrives
+void test_rx_window_after_tx_done() {
+  LoRa.txDurationUs = 20000;
+  runLoRaTask(PROTO_CMD_INTERVAL_MS);  // Slot fires → TX on air
+  TEST_ASSERT_EQUAL(RadioState::TX, radioState());
+  TEST_ASSERT_FALSE(LoRa.receiving);
+
+  runLoRaTask(21);
+#ifdef PROTO_BIDIRECTIONAL
+  TEST_ASSERT_EQUAL(RadioState::RX_WINDOW, radioState());
+  TEST_ASSERT_TRUE(LoRa.receiving);
+#else
+  TEST_ASSERT_EQUAL(RadioState::IDLE, radioState());  // One-way link: nothing to listen for
+  TEST_ASSERT_FALSE(LoRa.receiving);
+#endif
+
+  runLoRaTask(PROTO_CMD_INTERVAL_MS);  // Next slot closes the window
+#ifdef PROTO_BIDIRECTIONAL
+  TEST_ASSERT_GREATER_THAN(0, radioStats().rxPreempted);
+#endif
+  TEST_ASSERT_EQUAL(0, radioStats().rxOutsideWindow);
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+}
+
+// ✅ A lost DIO0 edge recovers after RADIO_TX_TIMEOUT_MS instead of going deaf
+void test_lost_tx_done_recovers() {
+  runLoRaTask(PROTO_CMD_INTERVAL_MS + 1);
+  LoRa.txDoneIrq = false;
+  runLoRaTask(PROTO_CMD_INTERVAL_MS);  // TX whose done edge never comes
+  TEST_ASSERT_EQUAL(RadioState::TX, radioState());
+  size_t sentBefore = LoRa.sent.size();
+
+  LoRa.txDoneIrq = true;
+  runLoRaTask(RADIO_TX_TIMEOUT_MS + PROTO_CMD_INTERVAL_MS);
+  TEST_ASSERT_EQUAL(1, radioStats().txTimeouts);
+  TEST_ASSERT_GREATER_THAN(sentBefore, LoRa.sent.size());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_long_tx_never_aborted);
+  RUN_TEST(test_rx_window_after_tx_done);
+  RUN_TEST(test_lost_tx_done_recovers);
+
+  return UNITY_END();
+}
@@ -0,0 +1,168 @@
+#include <unity.h>
+
+// 🌿 Adaptive command rate tests
+// The controller on its own (period vs stick activity / airtime headroom), then
+// the real LoRaTask over a cruise → maneuver flight against the fixed rate.
+
+#include <LoRa.h>
+#include <math.h>
+
+#include "Airtime.h"
+#include "RateControl.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+static const uint32_t fastestMs = RATE_MIN_INTERVAL_MS > rateControlFloorMs() ? RATE_MIN_INTERVAL_MS : rateControlFloorMs();
+
+static ControlState cruiseState() {
+  ControlState cs = {};
+  cs.aileron = 200;  // Held off-center: ECO duplicate suppression stays out of the way
+  cs.elevators = 127;
+  cs.rudder = 127;
+  cs.engine = 2000;
+  cs.ecoMode = true;
+  return cs;
+}
+
+// ⏰ Feed the controller the same way LoRaTask does: one update per period
+static uint32_t settle(ControlState cs, uint32_t& nowMs, uint32_t forMs) {
+  uint32_t endMs = nowMs + forMs;
+  uint32_t period = rateControlIntervalMs();
+  while (nowMs < endMs) {
+    nowMs += period;
+    period = rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US);
+  }
+  return period;
+}
+
+// 📡 Run LoRaTask for ms, moving the aileron with stick(t)
+static size_t fly(uint32_t ms, uint8_t (*stick)(uint32_t)) {
+  size_t before = LoRa.sent.size();
+  for (uint32_t t = 0; t < ms; t++) {
+    controlBeginWrite().aileron = stick(t);
+    controlEndWrite();
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+  return LoRa.sent.size() - before;
+}
+
+static uint8_t holdStick(uint32_t t) {
+  return 200;
+}
+
+static uint8_t sweepStick(uint32_t t) {  // ±100 at 1 Hz
+  return (uint8_t)(127 + 100 * sinf(2.0f * 3.14159265f * t / 1000.0f));
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  Serial.muted = true;
+  controlInit();
+  airtimeReset();
+  rateControlReset(millis());
+}
+
+void tearDown(void) {
+  Serial.muted = false;
+}
+
+// ✅ Settled sticks: the period grows step by step (≤ RATE_GROW_PERCENT) to the cruise rate
+void test_rest_slows_down_smoothly() {
+  ControlState cs = cruiseState();
+  uint32_t nowMs = 1000;
+  uint32_t prev = rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US);
+  for (int i = 0; i < 60; i++) {
+    nowMs += prev;
+    uint32_t next = rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US);
+    TEST_ASSERT_GREATER_OR_EQUAL(prev, next);
+    TEST_ASSERT_LESS_OR_EQUAL(prev + prev * RATE_GROW_PERCENT / 100 + 1, next);
+    prev = next;
+  }
+  TEST_ASSERT_EQUAL(RATE_MAX_INTERVAL_MS, prev);
+}
+
+// ✅ A fast stick move gets the fastest rate on the very next tick
+void test_stick_motion_speeds_up_immediately() {
+  ControlState cs = cruiseState();
+  uint32_t nowMs = 1000;
+  TEST_ASSERT_EQUAL(RATE_MAX_INTERVAL_MS, settle(cs, nowMs, 5000));
+
+  cs.aileron = 127;  // 73 units in one cruise period
+  cs.elevators = 60;
+  nowMs += RATE_MAX_INTERVAL_MS;
+  TEST_ASSERT_EQUAL(fastestMs, rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US));
+  TEST_ASSERT_GREATER_OR_EQUAL(rateControlFloorMs(), fastestMs);
+}
+
+// ✅ Trim / flaps / switches go out at the fast rate too
+void test_discrete_command_is_fast() {
+  ControlState cs = cruiseState();
+  uint32_t nowMs = 1000;
+  settle(cs, nowMs, 5000);
+
+  cs.elevatorTrim++;
+  nowMs += RATE_MAX_INTERVAL_MS;
+  TEST_ASSERT_EQUAL(fastestMs, rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US));
+}
+
+// ✅ Ledger nearly spent: back off even while maneuvering; ECO off: fixed rate
+void test_budget_backoff_and_eco_off() {
+  ControlState cs = cruiseState();
+  uint32_t nowMs = 1000;
+  uint32_t period = rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US);
+  for (int i = 0; i < 5; i++) {
+    cs.aileron ^= 0x40;  // Keep the sticks busy
+    nowMs += period;
+    uint32_t next = rateControlUpdate(cs, nowMs, 0);
+    TEST_ASSERT_GREATER_THAN(period, next);
+    period = next;
+  }
+
+  cs.ecoMode = false;
+  nowMs += period;
+  TEST_ASSERT_EQUAL(PROTO_CMD_INTERVAL_MS, rateControlUpdate(cs, nowMs, LORA_AIRTIME_BUDGET_US));
+}
+
+// 📊 Cruise → maneuver through the real LoRaTask, adaptive vs fixed rate
+void test_cruise_and_maneuver_frames() {
+  ControlState& w = controlBeginWrite();
+  w = cruiseState();
+  w.ecoMode = true;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+
+  fly(2000, holdStick);  // Let the rate settle
+  size_t cruise = fly(2000, holdStick);
+  size_t maneuver = fly(2000, sweepStick);
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "cruise %u frames/2 s, maneuver %u frames/2 s (fixed rate: %u) — floor %u ms",
+           (unsigned)cruise, (unsigned)maneuver, (unsigned)(2000 / PROTO_CMD_INTERVAL_MS), (unsigned)rateControlFloorMs());
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_UINT32_WITHIN(1, 2000 / RATE_MAX_INTERVAL_MS, cruise);
+  TEST_ASSERT_GREATER_THAN(cruise * 3, maneuver);
+  TEST_ASSERT_GREATER_OR_EQUAL(2000 * 3 / 4 / PROTO_CMD_INTERVAL_MS, maneuver);  // Sweep reversals ease off
+  TEST_ASSERT_LESS_OR_EQUAL(2000 / rateControlFloorMs() + 1, maneuver);
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_rest_slows_down_smoothly);
+  RUN_TEST(test_stick_motion_speeds_up_immediately);
+  RUN_TEST(test_discrete_command_is_fast);
+  RUN_TEST(test_budget_backoff_and_eco_off);
+  RUN_TEST(test_cruise_and_maneuver_frames);
+
+  return UNITY_END();
+}
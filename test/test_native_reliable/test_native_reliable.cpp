@@ -0,0 +1,408 @@
+#include <unity.h>
+
+// 🔁 Reliable discrete-command tests + lossy session benchmark
+// Queue unit checks, then the real LoRaTask next to a simulated flight board
+// that acks reliable trailers in its telemetry, over a link that drops frames
+// both ways. Best effort (one-shot steps / flags) vs the acked queue.
+
+#include <LoRa.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Airtime.h"
+#include "LinkQuality.h"
+#include "RateControl.h"
+#include "ReliableQueue.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+#include "protocol_reliable.h"
+#include "protocol_trim.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+void commandSetReliable(bool on);
+
+#define SESSION_MS 60000
+#define SIM_STEP_US 100
+#define EVENT_EVERY_MS 250  // 🎮 One discrete input (trim, reset, switch, flaps)
+#define LOSS_PERCENT 30     // Each way
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  reliableReset();
+}
+
+void tearDown(void) {
+  commandSetReliable(false);
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// 🛩️ Flight-board view of the discrete state, fed by either channel
+struct AirState {
+  int elevatorTrim;
+  int aileronTrim;
+  uint8_t resetAileronCount;
+  uint8_t resetElevatorCount;
+  bool airbrake;
+  bool acsEngage;
+  uint8_t flaps;
+  uint8_t ackId;
+  uint8_t ackMask;
+
+  // 📦 Best effort: state fields every frame, trim steps / reset flags once
+  void applyFrame(const ProtoCmdPacket& p) {
+    if (p.flags & PROTO_FLAG_RESET_ELEV) {
+      elevatorTrim = 0;
+      resetElevatorCount++;
+    }
+    if (p.flags & PROTO_FLAG_RESET_AIL) {
+      aileronTrim = 0;
+      resetAileronCount++;
+    }
+    elevatorTrim = proto_trim_step((int8_t)elevatorTrim, p.elevatorTrim);
+    aileronTrim = proto_trim_step((int8_t)aileronTrim, p.aileronTrim);
+    airbrake = p.flags & PROTO_FLAG_AIRBRAKE;
+    acsEngage = p.flags & PROTO_FLAG_ACS;
+    flaps = p.flaps;
+  }
+
+  // 🔁 Reliable: absolute value per op, each id applied once
+  void applyTrailer(const uint8_t* t, size_t len) {
+    uint8_t id, op, arg;
+    if (!proto_rel_decode(t, len, &id, &op, &arg) || !proto_rel_ack_window_add(&ackId, &ackMask, id))
+      return;
+    switch (op) {
+      case PROTO_REL_OP_RESET_AIL:  resetAileronCount = arg; break;
+      case PROTO_REL_OP_RESET_ELEV: resetElevatorCount = arg; break;
+      case PROTO_REL_OP_TRIM_AIL:   aileronTrim = (int8_t)arg; break;
+      case PROTO_REL_OP_TRIM_ELEV:  elevatorTrim = (int8_t)arg; break;
+      case PROTO_REL_OP_AIRBRAKE:   airbrake = arg; break;
+      case PROTO_REL_OP_ACS:        acsEngage = arg; break;
+      case PROTO_REL_OP_FLAPS:      flaps = arg; break;
+    }
+  }
+
+  // Fields that differ from the ground's controller state
+  int mismatches(const ControlState& cs) const {
+    return abs(elevatorTrim - cs.elevatorTrim) + abs(aileronTrim - cs.aileronTrim) +
+           (resetAileronCount != cs.resetAileronCount) + (resetElevatorCount != cs.resetElevatorCount) +
+           (airbrake != cs.airbrake) + (acsEngage != cs.acsEngage) + (flaps != cs.flaps);
+  }
+};
+
+// 🎮 Discrete inputs as PS5Joystick::notify() records them
+static void inputEvent(uint32_t n) {
+  ControlState& cs = controlBeginWrite();
+  switch (n % 8) {
+    case 0: cs.elevatorTrim = proto_trim_step(cs.elevatorTrim, 1); break;
+    case 1: cs.aileronTrim = proto_trim_step(cs.aileronTrim, -1); break;
+    case 2: cs.airbrake = !cs.airbrake; break;
+    case 3: cs.elevatorTrim = proto_trim_step(cs.elevatorTrim, 1); break;
+    case 4: cs.flaps = (uint8_t)((cs.flaps + 1) % 5); break;
+    case 5: cs.resetElevatorCount++; cs.elevatorTrim = 0; break;
+    case 6: cs.acsEngage = !cs.acsEngage; break;
+    case 7: cs.resetAileronCount++; cs.aileronTrim = 0; break;
+  }
+  controlEndWrite();
+}
+
+struct SessionResult {
+  uint32_t frames;       // Command frames on air
+  uint32_t trailers;     // ...of them carrying a reliable trailer
+  uint32_t mismatchMs;   // Time the air state differed from the ground's
+  int finalMismatch;
+  ReliableStats stats;
+};
+
+// 📡 SESSION_MS of discrete inputs through LoRaTask, LOSS_PERCENT dropped each way
+static SessionResult runSession(bool reliable) {
+  commandSetReliable(reliable);
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+
+  SessionResult r = {};
+  AirState air = {};
+  size_t seen = LoRa.sent.size();
+  uint32_t rng = 4242, events = 0;
+  uint8_t tlmSeq = 0, echo = 0;
+  unsigned long replyAtUs = 0;
+  bool replyPending = false;
+  const unsigned long startUs = micros();
+  const unsigned long endUs = startUs + SESSION_MS * 1000UL;
+  unsigned long nextEventUs = startUs + EVENT_EVERY_MS * 1000UL;
+
+  while (micros() < endUs) {
+    hal_advanceMicros(SIM_STEP_US);
+    if (micros() >= nextEventUs && micros() < endUs - 2000000UL) {  // Last 2 s: let the queue drain
+      nextEventUs += EVENT_EVERY_MS * 1000UL;
+      inputEvent(events++);
+    }
+    if (hal_takeNotify(NULL))
+      loraLoop();
+
+    for (; seen < LoRa.sent.size(); seen++) {
+      const FakeLoRaFrame& f = LoRa.sent[seen];
+      if (f.data[0] != PROTO_CMD_MAGIC)
+        continue;
+      r.frames++;
+      r.trailers += f.data.size() == PROTO_CMD_PACKET_SIZE + PROTO_REL_TRAILER_SIZE;
+      rng = rng * 1103515245u + 12345u;
+      if ((rng >> 16) % 100 < LOSS_PERCENT)
+        continue;
+      air.applyFrame(*(const ProtoCmdPacket*)f.data.data());
+      air.applyTrailer(f.data.data() + PROTO_CMD_PACKET_SIZE, f.data.size() - PROTO_CMD_PACKET_SIZE);
+      echo = (uint8_t)seen;
+      replyAtUs = f.atUs + LORA_CMD_AIRTIME_US + TDMA_TURNAROUND_US;
+      replyPending = true;
+    }
+
+    if (replyPending && micros() >= replyAtUs + LORA_TLM_AIRTIME_US) {
+      replyPending = false;
+      rng = rng * 1103515245u + 12345u;
+      if ((rng >> 16) % 100 >= LOSS_PERCENT) {
+        uint8_t tlm[PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE] = {};
+        ProtoTlmPacket p = {};
+        p.magic = PROTO_TLM_MAGIC;
+        p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+        memcpy(tlm, &p, PROTO_TLM_PACKET_SIZE);
+        uint8_t* trailer = tlm + PROTO_TLM_PACKET_SIZE;
+        trailer[0] = tlmSeq++;
+        trailer[1] = echo;
+        trailer[2] = LINK_ECHO_AGE_UNKNOWN;
+        trailer[3] = air.ackId;
+        trailer[4] = air.ackMask;
+        LoRa.injectRx(tlm, sizeof(tlm));
+      }
+    }
+
+    int m = air.mismatches(controlSnapshot());
+    if (m)
+      r.mismatchMs += SIM_STEP_US;
+    r.finalMismatch = m;
+  }
+  r.mismatchMs /= 1000;
+  r.stats = reliableStats();
+  return r;
+}
+
+// ✅ One slot per op: repeated changes coalesce, the queue never exceeds the op count
+void test_queue_coalesces_per_op() {
+  ControlState cs = {};
+  reliableTrack(cs, 0);  // Baseline
+  TEST_ASSERT_EQUAL(0, reliablePendingCount());
+  TEST_ASSERT_FALSE(reliableDue(0));
+
+  for (uint8_t f = 1; f <= 3; f++) {
+    cs.flaps = f;
+    reliableTrack(cs, f);
+  }
+  TEST_ASSERT_EQUAL(1, reliablePendingCount());
+  TEST_ASSERT_EQUAL(3, reliableStats().queued);
+
+  uint8_t t[PROTO_REL_TRAILER_SIZE], id, op, arg;
+  TEST_ASSERT_EQUAL(PROTO_REL_TRAILER_SIZE, reliableTrailer(t, 10));
+  TEST_ASSERT_TRUE(proto_rel_decode(t, sizeof(t), &id, &op, &arg));
+  TEST_ASSERT_EQUAL(PROTO_REL_OP_FLAPS, op);
+  TEST_ASSERT_EQUAL(3, arg);  // Latest value only
+
+  for (int i = 0; i < 200; i++) {
+    cs.resetAileronCount++;
+    cs.resetElevatorCount++;
+    cs.aileronTrim = (int8_t)(i % 20);
+    cs.elevatorTrim = (int8_t)-(i % 20);
+    cs.airbrake = !cs.airbrake;
+    cs.acsEngage = !cs.acsEngage;
+    cs.flaps = (uint8_t)(i % 5);
+    reliableTrack(cs, 20 + i);
+  }
+  TEST_ASSERT_EQUAL(RELIABLE_STATE_OPS, reliablePendingCount());
+}
+
+// ✅ Unsent ops go first; a sent op comes back only after the ack timeout, with a new id
+void test_resend_after_timeout() {
+  ControlState cs = {};
+  reliableTrack(cs, 0);
+  cs.airbrake = true;
+  reliableTrack(cs, 0);
+  cs.flaps = 2;
+  reliableTrack(cs, 5);
+
+  uint8_t t[PROTO_REL_TRAILER_SIZE], id, op, arg, firstId;
+  reliableTrailer(t, 10);
+  reliableTrailerSent(10);
+  TEST_ASSERT_TRUE(proto_rel_decode(t, sizeof(t), &firstId, &op, &arg));
+  TEST_ASSERT_EQUAL(PROTO_REL_OP_AIRBRAKE, op);  // Queued first
+
+  reliableTrailer(t, 20);
+  reliableTrailerSent(20);
+  TEST_ASSERT_TRUE(proto_rel_decode(t, sizeof(t), &id, &op, &arg));
+  TEST_ASSERT_EQUAL(PROTO_REL_OP_FLAPS, op);
+  TEST_ASSERT_FALSE(reliableDue(10 + RELIABLE_ACK_TIMEOUT_MS - 1));
+  TEST_ASSERT_EQUAL(0, reliableTrailer(t, 10 + RELIABLE_ACK_TIMEOUT_MS - 1));
+
+  TEST_ASSERT_TRUE(reliableDue(10 + RELIABLE_ACK_TIMEOUT_MS));
+  reliableTrailer(t, 10 + RELIABLE_ACK_TIMEOUT_MS);
+  reliableTrailerSent(10 + RELIABLE_ACK_TIMEOUT_MS);
+  TEST_ASSERT_TRUE(proto_rel_decode(t, sizeof(t), &id, &op, &arg));
+  TEST_ASSERT_EQUAL(PROTO_REL_OP_AIRBRAKE, op);
+  TEST_ASSERT_NOT_EQUAL(firstId, id);
+  TEST_ASSERT_EQUAL(2, reliableStats().sent);
+  TEST_ASSERT_EQUAL(1, reliableStats().resent);
+
+  reliableTrailer(t, 500);  // Handed out but never on air: no change
+  TEST_ASSERT_EQUAL(1, reliableStats().resent);
+}
+
+// ✅ An ack only retires the op if it carried the latest value
+void test_ack_for_superseded_value() {
+  ControlState cs = {};
+  reliableTrack(cs, 0);
+  cs.flaps = 1;
+  reliableTrack(cs, 0);
+  uint8_t t[PROTO_REL_TRAILER_SIZE], id1 = 0, id2 = 0, op, arg;
+  reliableTrailer(t, 0);
+  reliableTrailerSent(0);
+  proto_rel_decode(t, sizeof(t), &id1, &op, &arg);
+
+  cs.flaps = 2;  // Changed while flaps = 1 was in flight
+  reliableTrack(cs, 10);
+  reliableOnAck(id1, 1, 30);
+  TEST_ASSERT_EQUAL(1, reliablePendingCount());
+  TEST_ASSERT_TRUE(reliableDue(30));  // New value goes out right away
+
+  reliableTrailer(t, 40);
+  reliableTrailerSent(40);
+  proto_rel_decode(t, sizeof(t), &id2, &op, &arg);
+  TEST_ASSERT_EQUAL(2, arg);
+  reliableOnAck(id2, 0x03, 80);  // id2 plus id1 again
+  TEST_ASSERT_EQUAL(0, reliablePendingCount());
+  TEST_ASSERT_EQUAL(1, reliableStats().acked);
+  TEST_ASSERT_EQUAL(80, reliableStats().maxAckMs);  // Queued at 0, still pending at 10
+}
+
+// ✅ Air-side ack window: new ids apply once, in any order within 8
+void test_ack_window() {
+  uint8_t ackId = 0, ackMask = 0;
+  TEST_ASSERT_TRUE(proto_rel_ack_window_add(&ackId, &ackMask, 254));
+  TEST_ASSERT_TRUE(proto_rel_ack_window_add(&ackId, &ackMask, 1));  // Wraps, 255 and 0 lost
+  TEST_ASSERT_EQUAL(1, ackId);
+  TEST_ASSERT_EQUAL_HEX8(0x09, ackMask);
+  TEST_ASSERT_FALSE(proto_rel_ack_window_add(&ackId, &ackMask, 254));  // Duplicate
+  TEST_ASSERT_TRUE(proto_rel_ack_window_add(&ackId, &ackMask, 0));     // Late, still new
+  TEST_ASSERT_FALSE(proto_rel_ack_window_add(&ackId, &ackMask, 0));
+  TEST_ASSERT_FALSE(proto_rel_ack_window_add(&ackId, &ackMask, 240));  // Too old
+
+  TEST_ASSERT_TRUE(proto_rel_acked(ackId, ackMask, 1));
+  TEST_ASSERT_TRUE(proto_rel_acked(ackId, ackMask, 0));
+  TEST_ASSERT_FALSE(proto_rel_acked(ackId, ackMask, 255));
+  TEST_ASSERT_TRUE(proto_rel_acked(ackId, ackMask, 254));
+  TEST_ASSERT_FALSE(proto_rel_acked(ackId, ackMask, 2));
+
+  uint8_t t[PROTO_REL_TRAILER_SIZE], id, op, arg;
+  proto_rel_encode(7, PROTO_REL_OP_ACS, 1, t);
+  TEST_ASSERT_TRUE(proto_rel_decode(t, sizeof(t), &id, &op, &arg));
+  t[2] ^= 1;
+  TEST_ASSERT_FALSE(proto_rel_decode(t, sizeof(t), &id, &op, &arg));  // Corrupted
+}
+
+#ifdef PROTO_BIDIRECTIONAL  // Acks ride in telemetry
+// ✅ ECO keeps sending while an op is unacked, then goes quiet once it is
+void test_eco_resends_until_acked() {
+  commandSetReliable(true);
+  controlBeginWrite().ecoMode = true;
+  controlEndWrite();
+  setupRadio();
+  loraStartScheduler(NULL);
+  for (int ms = 0; ms < 3000; ms++) {  // Settle into duplicate suppression
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+
+  controlBeginWrite().airbrake = true;
+  controlEndWrite();
+  size_t first = LoRa.sent.size();
+  for (int ms = 0; ms < 1000; ms++) {  // No telemetry: nothing is acked
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+  uint32_t trailers = 0;
+  uint8_t lastId = 0, op = 0, arg = 0;
+  for (size_t i = first; i < LoRa.sent.size(); i++) {
+    const FakeLoRaFrame& f = LoRa.sent[i];
+    if (f.data.size() != PROTO_CMD_PACKET_SIZE + PROTO_REL_TRAILER_SIZE)
+      continue;
+    trailers++;
+    TEST_ASSERT_TRUE(proto_rel_decode(f.data.data() + PROTO_CMD_PACKET_SIZE, PROTO_REL_TRAILER_SIZE, &lastId, &op, &arg));
+    TEST_ASSERT_EQUAL(PROTO_REL_OP_AIRBRAKE, op);
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(1000 / RATE_MAX_INTERVAL_MS, trailers);  // Every ECO tick past the timeout
+  TEST_ASSERT_EQUAL(1, reliablePendingCount());
+
+  reliableOnAck(lastId, 1, millis());
+  first = LoRa.sent.size();
+  for (int ms = 0; ms < 1000; ms++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+  TEST_ASSERT_EQUAL(0, reliablePendingCount());
+  for (size_t i = first; i < LoRa.sent.size(); i++) {
+    if (LoRa.sent[i].data[0] == PROTO_CMD_MAGIC)  // Heartbeats aside
+      TEST_ASSERT_EQUAL(PROTO_CMD_PACKET_SIZE, LoRa.sent[i].data.size());
+  }
+}
+
+// 📊 Lossy session: discrete state at the air, best effort vs acked queue
+void test_lossy_session_benchmark() {
+  SessionResult best = runSession(false);
+  SessionResult rel = runSession(true);
+
+  char msg[320];
+  snprintf(msg, sizeof(msg),
+           "%d%% loss each way, %d s, input every %d ms | best effort: %u frames, final mismatch %d, wrong %.1f%% | "
+           "reliable: %u frames (%u with trailer), final mismatch %d, wrong %.1f%%, %u queued, %u sent + %u resent, "
+           "%u acked, max ack %u ms",
+           LOSS_PERCENT, SESSION_MS / 1000, EVENT_EVERY_MS, (unsigned)best.frames, best.finalMismatch,
+           best.mismatchMs * 100.0 / SESSION_MS, (unsigned)rel.frames, (unsigned)rel.trailers, rel.finalMismatch,
+           rel.mismatchMs * 100.0 / SESSION_MS, (unsigned)rel.stats.queued, (unsigned)rel.stats.sent,
+           (unsigned)rel.stats.resent, (unsigned)rel.stats.acked, (unsigned)rel.stats.maxAckMs);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_GREATER_THAN(0, best.finalMismatch);  // Lost one-shots never come back
+  TEST_ASSERT_EQUAL(0, rel.finalMismatch);
+  TEST_ASSERT_EQUAL(0, reliablePendingCount());
+  TEST_ASSERT_LESS_THAN(best.mismatchMs, rel.mismatchMs);
+  TEST_ASSERT_GREATER_THAN(0, rel.stats.resent);
+  TEST_ASSERT_UINT32_WITHIN(best.frames / 100 + 2, best.frames, rel.frames);  // Stick cadence unchanged
+}
+#endif
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_queue_coalesces_per_op);
+  RUN_TEST(test_resend_after_timeout);
+  RUN_TEST(test_ack_for_superseded_value);
+  RUN_TEST(test_ack_window);
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_eco_resends_until_acked);
+  RUN_TEST(test_lossy_session_benchmark);
+#endif
+
+  return UNITY_END();
+}
@@ -0,0 +1,251 @@
+#include <unity.h>
+
+// ⚡ SX1276 driver on the ESP-IDF spi_master (RADIO_SPI_DMA) against the mock
+// bus (NativeHAL driver/spi_master.h): bus time runs on the simulated clock,
+// so time the caller spends blocked is measurable. The polled path (Arduino
+// SPI) spins for the whole transfer — its cost is its bus time.
+
+#include <LoRa.h>
+#include <SPI.h>
+
+#include <vector>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "SX1276.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#ifdef PROTO_BIDIRECTIONAL
+extern bool tlm_valid;
+extern float tlm_altitude;
+extern int tlm_linkRssi;
+extern float tlm_linkSnr;
+#endif
+
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+// 🔁 Bus time of a polled transfer at SX1276_SPI_HZ
+static double busUs(unsigned long bytes) {
+  return bytes * 8 * 1e6 / SX1276_SPI_HZ;
+}
+
+static std::vector<uint8_t> doneOps;
+static std::vector<unsigned long> doneUs;
+
+static void recordSpiDone(uint8_t op) {
+  doneOps.push_back(op);
+  doneUs.push_back(micros());
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  SPI.csPin = LORA_CS;
+  LoRa.setPins(LORA_CS, LORA_RST, LORA_DIO0);
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+  doneOps.clear();
+  doneUs.clear();
+}
+
+void tearDown(void) {
+  for (int t = 0; t < 100 && LoRa.txOnAir; t++)
+    runLoRaTask(1);  // Off the air before the next test resets the chip
+  sx1276Flush();     // Nothing queued across the clock reset
+  radioSetDirectSpi(false);
+  SPI.csPin = -1;
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ sx1276Transmit() returns at once; the frame reaches the air a bus time later
+void test_transmit_returns_before_fifo_load() {
+  radioSetSpiDma(true);
+  setupRadio();
+  TEST_ASSERT_TRUE(radioDirectSpi());
+  runLoRaTask(5);
+  sx1276Flush();
+  sx1276OnSpiDone(recordSpiDone);
+
+  const uint8_t frame[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  const uint8_t tail = 0x42;
+  size_t sent = LoRa.sent.size();
+  sx1276ResetStats();
+  unsigned long t0 = micros();
+  sx1276Transmit(frame, sizeof(frame), &tail, 1, false);
+  const Sx1276Stats& s = sx1276Stats();
+  TEST_ASSERT_EQUAL(t0, micros());  // Nothing waited on
+  TEST_ASSERT_EQUAL(0, s.blockedUs);
+  TEST_ASSERT_EQUAL(s.transactions, s.queued);
+  TEST_ASSERT_EQUAL(s.bytes, s.queuedBytes);
+  TEST_ASSERT_EQUAL(sent, LoRa.sent.size());  // Not loaded yet
+
+  hal_advanceMicros((unsigned long)busUs(s.bytes) + s.transactions);
+  TEST_ASSERT_EQUAL(sent + 1, LoRa.sent.size());
+  TEST_ASSERT_EQUAL(sizeof(frame) + 1, LoRa.sent.back().data.size());
+  TEST_ASSERT_EQUAL_MEMORY(frame, LoRa.sent.back().data.data(), sizeof(frame));
+  TEST_ASSERT_EQUAL_HEX8(tail, LoRa.sent.back().data.back());
+  TEST_ASSERT_EQUAL(1, doneOps.size());
+  TEST_ASSERT_EQUAL(SX1276_OP_TX_LOADED, doneOps[0]);
+  TEST_ASSERT_EQUAL(LoRa.sent.back().atUs, doneUs[0]);
+  TEST_ASSERT_EQUAL(0, SPI.csErrors);
+}
+
+// ✅ DIO0 belongs to the driver: TX done arrives through the flag read, flags are cleared
+void test_dio0_serviced_by_driver() {
+  radioSetSpiDma(true);
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  setupRadio();
+  loraStartScheduler(NULL);
+  runLoRaTask(200);
+
+  const RadioStats& r = radioStats();
+  TEST_ASSERT_GREATER_THAN(3, r.txStarted);
+  TEST_ASSERT_UINT32_WITHIN(1, r.txStarted, r.txCompleted);
+  TEST_ASSERT_EQUAL(0, r.txTimeouts);
+  TEST_ASSERT_EQUAL(0, r.spuriousTxDone);
+  TEST_ASSERT_EQUAL_HEX8(0, SPI.regs[SX1276_REG_IRQ_FLAGS] & SX1276_IRQ_TX_DONE);
+}
+
+#ifdef PROTO_BIDIRECTIONAL
+static void injectTelemetry(float altitude, int rssi, float snr) {
+  ProtoTlmPacket p = {};
+  p.magic = PROTO_TLM_MAGIC;
+  p.altitude_dm = (int16_t)lroundf(altitude * 10);
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p), rssi, snr);
+}
+
+// ✅ Telemetry drain is queued; the ring entry is committed once the status bytes are in
+void test_rx_drain_completes_async() {
+  radioSetSpiDma(true);
+  setupRadio();
+  runLoRaTask(5);
+  TEST_ASSERT_TRUE(LoRa.receiving);
+
+  tlm_valid = false;
+  sx1276ResetStats();
+  injectTelemetry(123.5f, -97, -6.25f);
+  TEST_ASSERT_TRUE(hal_takeNotify(NULL));
+  loraLoop();  // Flags read (polled), FIFO read queued
+  TEST_ASSERT_FALSE(tlm_valid);
+  const Sx1276Stats& s = sx1276Stats();
+  TEST_ASSERT_GREATER_OR_EQUAL(1 + PROTO_TLM_PACKET_SIZE, s.queuedBytes);
+  TEST_ASSERT_LESS_THAN(busUs(s.bytes), s.blockedUs);
+
+  runLoRaTask(1);  // SPI done → commit → decode
+  TEST_ASSERT_TRUE(tlm_valid);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 123.5f, tlm_altitude);
+  TEST_ASSERT_EQUAL(-97, tlm_linkRssi);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -6.25f, tlm_linkSnr);
+  TEST_ASSERT_EQUAL(0, SPI.csErrors);
+}
+#endif
+
+struct SessionResult {
+  std::vector<FakeLoRaFrame> sent;
+  Sx1276Stats spi;
+  uint32_t tlmSent;
+  uint32_t tlmDecoded;
+};
+
+static SessionResult runSession(bool dma) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  radioSetDirectSpi(true);
+  radioSetSpiDma(dma);
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  setupRadio();
+  loraStartScheduler(NULL);
+  sx1276ResetStats();
+
+  SessionResult r = {};
+  for (int t = 0; t < 2000; t++) {
+    ControlState& cs = controlBeginWrite();
+    cs.aileron = (uint8_t)(t / 10 % 200 + 28);
+    controlEndWrite();
+    runLoRaTask(1);
+#ifdef PROTO_BIDIRECTIONAL
+    if (t % 50 != 25)
+      continue;
+    hal_advanceMicros(100);  // Queued writes reach the chip before anything lands in its FIFO
+    if (LoRa.receiving) {
+      float altitude = (float)(t / 50);
+      injectTelemetry(altitude, -80, 7.0f);
+      r.tlmSent++;
+      runLoRaTask(2);  // DMA: decoded on the SPI-done wakeup after the RX-done one
+      if (tlm_altitude == altitude)
+        r.tlmDecoded++;
+    }
+#endif
+  }
+  r.sent = LoRa.sent;
+  r.spi = sx1276Stats();
+  for (int t = 0; t < 100 && LoRa.txOnAir; t++)
+    runLoRaTask(1);
+  sx1276Flush();
+  return r;
+}
+
+// 📊 Real LoRaTask, polled vs DMA: same frames, CPU time blocked on the bus
+void test_lora_task_blocked_time() {
+  SessionResult polled = runSession(false);
+  SessionResult dma = runSession(true);
+
+  TEST_ASSERT_GREATER_THAN(20, dma.sent.size());
+  TEST_ASSERT_UINT32_WITHIN(1, polled.sent.size(), dma.sent.size());  // Last one may fall either side of the end
+  const size_t common = polled.sent.size() < dma.sent.size() ? polled.sent.size() : dma.sent.size();
+  for (size_t i = 0; i < common; i++) {
+    TEST_ASSERT_EQUAL(polled.sent[i].data.size(), dma.sent[i].data.size());
+    TEST_ASSERT_EQUAL_MEMORY(polled.sent[i].data.data(), dma.sent[i].data.data(), polled.sent[i].data.size());
+    if (i > 0)  // Same cadence; the tick re-arms from when LoRaTask ran, so µs of bus wait can cross a 1 ms step
+      TEST_ASSERT_UINT32_WITHIN(1100, polled.sent[i].atUs - polled.sent[i - 1].atUs,
+                                dma.sent[i].atUs - dma.sent[i - 1].atUs);
+  }
+  TEST_ASSERT_EQUAL(polled.tlmSent, polled.tlmDecoded);
+  TEST_ASSERT_EQUAL(dma.tlmSent, dma.tlmDecoded);
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  TEST_ASSERT_EQUAL(0, SPI.csErrors);
+
+  const size_t frames = dma.sent.size() - 1;  // Init packet went out before the count started
+  const double polledUs = busUs(polled.spi.bytes);
+  char msg[256];
+  snprintf(msg, sizeof(msg),
+           "%u frames, %u TLM: polled %lu transactions / %lu bytes = %.0f us spinning (%.1f us/frame) | DMA %lu "
+           "queued (%lu bytes), %lu us blocked (%.1f us/frame)",
+           (unsigned)frames, (unsigned)dma.tlmSent, (unsigned long)polled.spi.transactions,
+           (unsigned long)polled.spi.bytes, polledUs, polledUs / frames, (unsigned long)dma.spi.queued,
+           (unsigned long)dma.spi.queuedBytes, (unsigned long)dma.spi.blockedUs, (double)dma.spi.blockedUs / frames);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_GREATER_THAN(dma.spi.transactions / 2, dma.spi.queued);
+  TEST_ASSERT_LESS_THAN(polledUs / 2, dma.spi.blockedUs);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_transmit_returns_before_fifo_load);
+  RUN_TEST(test_dio0_serviced_by_driver);
+#ifdef PROTO_BIDIRECTIONAL  // Telemetry RX only exists on a two-way link
+  RUN_TEST(test_rx_drain_completes_async);
+#endif
+  RUN_TEST(test_lora_task_blocked_time);
+
+  return UNITY_END();
+}
@@ -0,0 +1,366 @@
+#include <unity.h>
+
+// 🔌 Direct SX1276 driver tests against the mock SPI bus (NativeHAL SPI.h)
+// The library's register sequences (sandeepmistry LoRa 0.8: beginPacket /
+// write / endPacket, available / read, setters) are replayed transaction by
+// transaction on the same mock chip, so both paths are counted the same way.
+
+#include <LoRa.h>
+#include <SPI.h>
+
+#include <vector>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "SX1276.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#ifdef PROTO_BIDIRECTIONAL
+extern bool tlm_valid;
+extern int tlm_linkRssi;
+extern float tlm_linkSnr;
+#endif
+
+static const Sx1276Config protoConfig = {PROTO_LORA_FREQUENCY_HZ, PROTO_LORA_SF,       PROTO_LORA_BANDWIDTH_HZ,
+                                         PROTO_LORA_CR,           PROTO_LORA_PREAMBLE, PROTO_LORA_SYNC_WORD,
+                                         PROTO_LORA_TX_POWER,     true};
+
+// 📜 One library register access: one transaction
+static uint8_t libReg(uint8_t addr, uint8_t value = 0) {
+  SPI.beginTransaction(SPISettings(SX1276_SPI_HZ, MSBFIRST, SPI_MODE0));
+  digitalWrite(LORA_CS, LOW);
+  SPI.transfer(addr);
+  uint8_t in = SPI.transfer(value);
+  digitalWrite(LORA_CS, HIGH);
+  SPI.endTransaction();
+  return in;
+}
+
+static uint8_t libRead(uint8_t reg) {
+  return libReg(reg & 0x7F);
+}
+
+static void libWrite(uint8_t reg, uint8_t value) {
+  libReg(reg | 0x80, value);
+}
+
+// 📜 setLdoFlag(): bandwidth and SF read back from the chip every time
+static void libLdo() {
+  static const long bw[] = {7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000};
+  long hz = bw[libRead(SX1276_REG_MODEM_CONFIG_1) >> 4];
+  int sf = libRead(SX1276_REG_MODEM_CONFIG_2) >> 4;
+  uint8_t mc3 = libRead(SX1276_REG_MODEM_CONFIG_3);
+  libWrite(SX1276_REG_MODEM_CONFIG_3, 1000 / (hz / (1L << sf)) > 16 ? (mc3 | 0x08) : (mc3 & ~0x08));
+}
+
+// 📜 setupRadio() through the library (plus begin()'s setFrequency)
+static void libConfigure() {
+  uint64_t frf = ((uint64_t)PROTO_LORA_FREQUENCY_HZ << 19) / 32000000;
+  libWrite(SX1276_REG_FRF_MSB, (uint8_t)(frf >> 16));
+  libWrite(SX1276_REG_FRF_MSB + 1, (uint8_t)(frf >> 8));
+  libWrite(SX1276_REG_FRF_MSB + 2, (uint8_t)frf);
+  libWrite(SX1276_REG_DETECTION_OPTIMIZE, PROTO_LORA_SF == 6 ? 0xC5 : 0xC3);  // setSpreadingFactor
+  libWrite(SX1276_REG_DETECTION_THRESHOLD, PROTO_LORA_SF == 6 ? 0x0C : 0x0A);
+  libWrite(SX1276_REG_MODEM_CONFIG_2, (libRead(SX1276_REG_MODEM_CONFIG_2) & 0x0F) | (PROTO_LORA_SF << 4));
+  libLdo();
+  static const long bw[] = {7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000};
+  int bwIdx = 9;
+  for (int i = 8; i >= 0; i--)
+    if (PROTO_LORA_BANDWIDTH_HZ <= bw[i])
+      bwIdx = i;
+  libWrite(SX1276_REG_MODEM_CONFIG_1, (libRead(SX1276_REG_MODEM_CONFIG_1) & 0x0F) | (bwIdx << 4));  // setSignalBandwidth
+  libLdo();
+  libWrite(SX1276_REG_MODEM_CONFIG_1, (libRead(SX1276_REG_MODEM_CONFIG_1) & 0xF1) | ((PROTO_LORA_CR - 4) << 1));
+  libWrite(SX1276_REG_SYNC_WORD, PROTO_LORA_SYNC_WORD);
+  int level = PROTO_LORA_TX_POWER;  // setTxPower (PA_BOOST)
+  uint8_t ocp = 0x20 | ((100 - 45) / 5);
+  uint8_t dac = 0x84;
+  if (level > 17) {
+    level = (level > 20 ? 20 : level) - 3;
+    ocp = 0x20 | ((140 + 30) / 10);
+    dac = 0x87;
+  }
+  libWrite(SX1276_REG_PA_DAC, dac);
+  libWrite(SX1276_REG_OCP, ocp);
+  libWrite(SX1276_REG_PA_CONFIG, 0x80 | (level - 2));
+  libWrite(SX1276_REG_PREAMBLE_MSB, (uint8_t)(PROTO_LORA_PREAMBLE >> 8));  // setPreambleLength
+  libWrite(SX1276_REG_PREAMBLE_MSB + 1, (uint8_t)PROTO_LORA_PREAMBLE);
+  libWrite(SX1276_REG_MODEM_CONFIG_2, libRead(SX1276_REG_MODEM_CONFIG_2) | 0x04);  // enableCrc
+}
+
+// 📜 beginPacket() / write(frame) / write(trailer) / endPacket(true)
+static void libSend(const uint8_t* frame, size_t len, uint8_t trailer) {
+  libRead(SX1276_REG_OP_MODE);  // isTransmitting()
+  libRead(SX1276_REG_IRQ_FLAGS);
+  libWrite(SX1276_REG_OP_MODE, SX1276_MODE_LONG_RANGE | SX1276_MODE_STDBY);
+  libWrite(SX1276_REG_MODEM_CONFIG_1, libRead(SX1276_REG_MODEM_CONFIG_1) & 0xFE);
+  libWrite(SX1276_REG_FIFO_ADDR_PTR, 0);
+  libWrite(SX1276_REG_PAYLOAD_LENGTH, 0);
+  uint8_t n = libRead(SX1276_REG_PAYLOAD_LENGTH);
+  for (size_t i = 0; i < len; i++)
+    libWrite(SX1276_REG_FIFO, frame[i]);
+  libWrite(SX1276_REG_PAYLOAD_LENGTH, n + len);
+  n = libRead(SX1276_REG_PAYLOAD_LENGTH);
+  libWrite(SX1276_REG_FIFO, trailer);
+  libWrite(SX1276_REG_PAYLOAD_LENGTH, n + 1);
+  libWrite(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_TX_DONE);
+  libWrite(SX1276_REG_OP_MODE, SX1276_MODE_LONG_RANGE | SX1276_MODE_TX);
+}
+
+// 📜 drainRxFifo() through the library: available() + read() per byte, RSSI, SNR
+static void libDrain(uint8_t* out, int size, int16_t* rssi, float* snr) {
+  int idx = 0;
+  while (idx < size && libRead(SX1276_REG_RX_NB_BYTES) > idx) {
+    libRead(SX1276_REG_RX_NB_BYTES);  // read() checks available() again
+    out[idx++] = libRead(SX1276_REG_FIFO);
+  }
+  *rssi = (int16_t)(libRead(SX1276_REG_PKT_RSSI_VALUE) - 157);
+  *snr = (int8_t)libRead(SX1276_REG_PKT_SNR_VALUE) * 0.25f;
+}
+
+static int rxDoneSize = 0;
+static void onRx(int size) {
+  rxDoneSize = size;
+}
+
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  SPI.csPin = LORA_CS;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+}
+
+void tearDown(void) {
+  radioSetDirectSpi(false);
+  SPI.csPin = -1;
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ Same registers as the library's setup, fewer transactions; unchanged values are never rewritten
+void test_configure_cached() {
+  TEST_ASSERT_TRUE(sx1276Begin(LORA_CS, LORA_RST));
+  unsigned long t0 = SPI.transactions;
+  libConfigure();
+  const unsigned long libTx = SPI.transactions - t0;
+  uint8_t libRegs[0x80];
+  memcpy(libRegs, SPI.regs, sizeof(libRegs));
+
+  SPI.reset();
+  SPI.csPin = LORA_CS;
+  TEST_ASSERT_TRUE(sx1276Begin(LORA_CS, LORA_RST));
+  t0 = SPI.transactions;
+  sx1276Configure(protoConfig);
+  const unsigned long directTx = SPI.transactions - t0;
+  const uint8_t checked[] = {SX1276_REG_OP_MODE,        SX1276_REG_FRF_MSB,        SX1276_REG_FRF_MSB + 1,
+                             SX1276_REG_FRF_MSB + 2,    SX1276_REG_PA_CONFIG,      SX1276_REG_OCP,
+                             SX1276_REG_MODEM_CONFIG_1, SX1276_REG_MODEM_CONFIG_2, SX1276_REG_MODEM_CONFIG_3,
+                             SX1276_REG_PREAMBLE_MSB,   SX1276_REG_PREAMBLE_MSB + 1, SX1276_REG_SYNC_WORD,
+                             SX1276_REG_PA_DAC,         SX1276_REG_DETECTION_OPTIMIZE};
+  for (uint8_t reg : checked)
+    TEST_ASSERT_EQUAL_HEX8(libRegs[reg], SPI.regs[reg]);
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "setupRadio config: library %lu transactions, direct %lu", libTx, directTx);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(libTx, directTx);
+
+  t0 = SPI.transactions;
+  sx1276Configure(protoConfig);  // Nothing changed
+  TEST_ASSERT_EQUAL(0, SPI.transactions - t0);
+  TEST_ASSERT_GREATER_THAN(0, sx1276Stats().writesSkipped);
+
+  const uint8_t sf = PROTO_LORA_SF == 8 ? 9 : 8;
+  sx1276SetSpreadingFactor(sf);  // One register changes, no reads
+  TEST_ASSERT_EQUAL(1, SPI.transactions - t0);
+  TEST_ASSERT_EQUAL(sf, SPI.regs[SX1276_REG_MODEM_CONFIG_2] >> 4);
+  TEST_ASSERT_EQUAL_HEX8(0x04, SPI.regs[SX1276_REG_MODEM_CONFIG_2] & 0x04);  // CRC kept
+  sx1276SetSpreadingFactor(12);
+  sx1276SetBandwidth(125000);  // SF12 / 125 kHz: 32 ms symbols → low data rate optimize
+  TEST_ASSERT_EQUAL_HEX8(0x08, SPI.regs[SX1276_REG_MODEM_CONFIG_3] & 0x08);
+  TEST_ASSERT_EQUAL(0, SPI.csErrors);
+}
+
+// ✅ One FIFO burst per frame, identical bytes on air
+void test_tx_burst_vs_library() {
+  TEST_ASSERT_TRUE(sx1276Begin(LORA_CS, LORA_RST));
+  sx1276Configure(protoConfig);
+  uint8_t frame[PROTO_CMD_PACKET_SIZE];
+  for (uint8_t i = 0; i < sizeof(frame); i++)
+    frame[i] = (uint8_t)(0xA0 + i);
+  const uint8_t trailer = 0x42;
+
+  unsigned long t0 = SPI.transactions, b0 = SPI.bytes;
+  libSend(frame, sizeof(frame), trailer);
+  const unsigned long libTx = SPI.transactions - t0, libBytes = SPI.bytes - b0;
+
+  t0 = SPI.transactions;
+  b0 = SPI.bytes;
+  sx1276Transmit(frame, sizeof(frame), &trailer, 1, false);
+  const unsigned long coldTx = SPI.transactions - t0, directBytes = SPI.bytes - b0;
+  t0 = SPI.transactions;
+  sx1276Transmit(frame, sizeof(frame), &trailer, 1, false);  // Steady state: config cached
+  const unsigned long warmTx = SPI.transactions - t0;
+
+  TEST_ASSERT_EQUAL(3, LoRa.sent.size());
+  for (const FakeLoRaFrame& f : LoRa.sent) {
+    TEST_ASSERT_EQUAL(sizeof(frame) + 1, f.data.size());
+    TEST_ASSERT_EQUAL_MEMORY(frame, f.data.data(), sizeof(frame));
+    TEST_ASSERT_EQUAL_HEX8(trailer, f.data[sizeof(frame)]);
+    TEST_ASSERT_FALSE(f.implicitHeader);
+  }
+  TEST_ASSERT_EQUAL_HEX8(SX1276_DIO0_TX_DONE, SPI.regs[SX1276_REG_DIO_MAPPING_1]);
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "TX %u B: library %lu transactions / %lu bus bytes, direct %lu (then %lu) / %lu bus bytes",
+           (unsigned)sizeof(frame) + 1, libTx, libBytes, coldTx, warmTx, directBytes);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(25, libTx);
+  TEST_ASSERT_LESS_OR_EQUAL(5, coldTx);
+  TEST_ASSERT_LESS_OR_EQUAL(4, warmTx);
+  TEST_ASSERT_EQUAL(0, SPI.csErrors);
+}
+
+// ✅ Telemetry drain: one FIFO burst + one status burst
+void test_rx_burst_vs_library() {
+  TEST_ASSERT_TRUE(sx1276Begin(LORA_CS, LORA_RST));
+  sx1276Configure(protoConfig);
+  LoRa.onReceive(onRx);
+  sx1276Receive(0);
+  TEST_ASSERT_TRUE(LoRa.receiving);
+  TEST_ASSERT_EQUAL_HEX8(SX1276_DIO0_RX_DONE, SPI.regs[SX1276_REG_DIO_MAPPING_1]);
+
+  uint8_t frame[PROTO_RX_BUF_SIZE];
+  const int len = PROTO_TLM_PACKET_SIZE + 5;
+  for (int i = 0; i < len; i++)
+    frame[i] = (uint8_t)(i * 7 + 1);
+  LoRa.injectRx(frame, len, -72, 6.25f);
+  TEST_ASSERT_EQUAL(len, rxDoneSize);
+
+  uint8_t lib[PROTO_RX_BUF_SIZE], direct[PROTO_RX_BUF_SIZE];
+  int16_t libRssi, rssi;
+  float libSnr, snr;
+  unsigned long t0 = SPI.transactions;
+  libDrain(lib, len, &libRssi, &libSnr);
+  const unsigned long libTx = SPI.transactions - t0;
+
+  SPI.regs[SX1276_REG_FIFO_ADDR_PTR] = 0;  // Back to the frame, as the ISR left it
+  t0 = SPI.transactions;
+  TEST_ASSERT_TRUE(sx1276ReadPacket(direct, len));  // Polled backend: in place on return
+  sx1276PacketStatus(&rssi, &snr);
+  const unsigned long directTx = SPI.transactions - t0;
+
+  TEST_ASSERT_EQUAL_MEMORY(frame, lib, len);
+  TEST_ASSERT_EQUAL_MEMORY(frame, direct, len);
+  TEST_ASSERT_EQUAL(-72, libRssi);
+  TEST_ASSERT_EQUAL(-72, rssi);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.25f, snr);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, libSnr, snr);
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "RX %d B: library %lu transactions, direct %lu", len, libTx, directTx);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(3 * len + 2, libTx);
+  TEST_ASSERT_EQUAL(2, directTx);
+}
+
+static std::vector<FakeLoRaFrame> runSession(bool direct, unsigned long* transactions) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  SPI.reset();
+  SPI.csPin = LORA_CS;
+  radioSetDirectSpi(direct);
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  setupRadio();
+  loraStartScheduler(NULL);
+  unsigned long t0 = SPI.transactions;
+  for (int t = 0; t < 1000; t++) {
+    ControlState& cs = controlBeginWrite();
+    cs.aileron = (uint8_t)(t / 10 % 200 + 28);  // Same sweep on both paths (the probe's reset pulse shifts the clock)
+    controlEndWrite();
+    runLoRaTask(1);
+  }
+  *transactions = SPI.transactions - t0;
+  std::vector<FakeLoRaFrame> sent = LoRa.sent;
+  for (int t = 0; t < 100 && LoRa.txOnAir; t++)
+    runLoRaTask(1);  // Last frame off the air before the next session resets the chip
+  return sent;
+}
+
+// ✅ Real LoRaTask on the direct path: same frames as the library path, a handful of transactions each
+void test_lora_task_direct() {
+  unsigned long libTx, directTx;
+  std::vector<FakeLoRaFrame> lib = runSession(false, &libTx);
+  std::vector<FakeLoRaFrame> direct = runSession(true, &directTx);
+
+  TEST_ASSERT_TRUE(radioDirectSpi());
+  TEST_ASSERT_EQUAL(0, libTx);  // Library path never touches the driver
+  TEST_ASSERT_GREATER_THAN(10, direct.size());
+  TEST_ASSERT_EQUAL(lib.size(), direct.size());
+  for (size_t i = 0; i < lib.size(); i++) {
+    TEST_ASSERT_EQUAL(lib[i].atUs - lib[0].atUs, direct[i].atUs - direct[0].atUs);
+    TEST_ASSERT_EQUAL(lib[i].data.size(), direct[i].data.size());
+    TEST_ASSERT_EQUAL_MEMORY(lib[i].data.data(), direct[i].data.data(), lib[i].data.size());
+  }
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  TEST_ASSERT_EQUAL(0, SPI.csErrors);
+
+  const size_t frames = direct.size() - 1;  // Init packet went out before the count started
+  char msg[128];
+  snprintf(msg, sizeof(msg), "LoRaTask: %lu transactions for %u frames (%.1f per frame incl. RX arming)", directTx,
+           (unsigned)frames, (double)directTx / frames);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_OR_EQUAL(7 * frames, directTx);
+
+#ifdef PROTO_BIDIRECTIONAL
+  tlm_valid = false;
+  TEST_ASSERT_TRUE(LoRa.receiving);  // Back in the RX window after the last TX done
+  ProtoTlmPacket p = {};
+  p.magic = PROTO_TLM_MAGIC;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p), -91, -3.5f);
+  runLoRaTask(1);
+  TEST_ASSERT_TRUE(tlm_valid);
+  TEST_ASSERT_EQUAL(-91, tlm_linkRssi);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -3.5f, tlm_linkSnr);
+#endif
+}
+
+// ✅ No chip answering → setupRadio() reports failure, nothing is sent
+void test_probe_fails_without_chip() {
+  SPI.regs[SX1276_REG_VERSION] = 0x00;
+  radioSetDirectSpi(true);
+  setupRadio();
+  TEST_ASSERT_EQUAL(0, LoRa.sent.size());
+  TEST_ASSERT_EQUAL(1, SPI.transactions);  // Version read only
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_configure_cached);
+  RUN_TEST(test_tx_burst_vs_library);
+  RUN_TEST(test_rx_burst_vs_library);
+  RUN_TEST(test_lora_task_direct);
+  RUN_TEST(test_probe_fails_without_chip);
+
+  return UNITY_END();
+}
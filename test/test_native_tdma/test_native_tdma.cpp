@@ -0,0 +1,193 @@
+#include <unity.h>
+
+// 🗓️ TDMA channel simulator
+// The real ground code runs against the fake SX1276 (time on air from the
+// PROTO_LORA_* airtime model) next to a simulated air node. Any overlap
+// between a ground command and an air telemetry frame is a collision.
+
+#include <LoRa.h>
+
+#include <vector>
+
+#include "Airtime.h"
+#include "RadioState.h"
+#include "TxScheduler.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#ifdef PROTO_BIDIRECTIONAL
+extern bool tlm_valid;
+#endif
+
+#define SIM_DURATION_MS 10000
+#define SIM_STEP_US 100  // LoRaTask wakeup resolution
+#define AIR_FREE_RUN_PERIOD_US (2 * PROTO_CMD_INTERVAL_MS * 1000UL + 3100)  // Old air side: own timer, drifting phase
+
+struct AirFrame {
+  unsigned long startUs;
+  bool done;
+};
+
+struct SimResult {
+  uint32_t airFrames;
+  uint32_t collisions;
+  uint32_t delivered;
+  size_t commands;
+};
+
+static ProtoTlmPacket makeTelemetry() {
+  ProtoTlmPacket p = {};
+  p.magic = PROTO_TLM_MAGIC;
+  p.altitude_dm = 100;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+  return p;
+}
+
+static bool overlapsGroundTx(unsigned long a0, unsigned long a1) {
+  for (const FakeLoRaFrame& g : LoRa.sent) {
+    if (g.atUs < a1 && g.atUs + LORA_CMD_AIRTIME_US > a0)
+      return true;
+  }
+  return false;
+}
+
+// 🛩️ slotted = air answers each command in the telemetry slot, else free-running
+static SimResult simulate(bool slotted) {
+  std::vector<AirFrame> air;
+  SimResult r = {};
+  const ProtoTlmPacket tlm = makeTelemetry();
+  const unsigned long endUs = micros() + SIM_DURATION_MS * 1000UL;
+  size_t seenCommands = LoRa.sent.size();
+
+  if (!slotted) {
+    for (unsigned long t = micros() + 7000; t + LORA_TLM_AIRTIME_US < endUs; t += AIR_FREE_RUN_PERIOD_US)
+      air.push_back({t, false});
+  }
+
+  while (micros() < endUs) {
+    hal_advanceMicros(SIM_STEP_US);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+
+    for (; slotted && seenCommands < LoRa.sent.size(); seenCommands++) {
+      unsigned long heardUs = LoRa.sent[seenCommands].atUs + LORA_CMD_AIRTIME_US;
+      air.push_back({heardUs + TDMA_TURNAROUND_US, false});
+    }
+
+    for (AirFrame& a : air) {
+      unsigned long a1 = a.startUs + LORA_TLM_AIRTIME_US;
+      if (a.done || a1 > micros())
+        continue;
+      a.done = true;
+      r.airFrames++;
+      if (overlapsGroundTx(a.startUs, a1)) {
+        r.collisions++;
+        continue;
+      }
+      unsigned long missedBefore = LoRa.missedRx;
+      LoRa.injectRx((const uint8_t*)&tlm, sizeof(tlm));
+      if (LoRa.missedRx == missedBefore)
+        r.delivered++;
+    }
+  }
+  r.commands = LoRa.sent.size();
+  return r;
+}
+
+static void report(const char* name, const SimResult& r) {
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: %u TLM frames, %u collisions (%.1f%%), %u delivered, %u commands", name,
+           (unsigned)r.airFrames, (unsigned)r.collisions, r.airFrames ? 100.0 * r.collisions / r.airFrames : 0.0,
+           (unsigned)r.delivered, (unsigned)r.commands);
+  TEST_MESSAGE(msg);
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = LORA_CMD_AIRTIME_US;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;
+  controlEndWrite();
+#ifdef PROTO_BIDIRECTIONAL
+  tlm_valid = false;
+#endif
+  setupRadio();
+  loraStartScheduler(NULL);
+  LoRa.reset();  // Count from here; the init packet is still on air
+}
+
+void tearDown(void) {
+  LoRa.txDurationUs = 0;
+  Serial.muted = false;
+}
+
+// ✅ Slot sizes come from the airtime model and fit the command interval
+void test_slot_layout() {
+  char msg[96];
+  snprintf(msg, sizeof(msg), "cmd slot %u us + TLM slot %u us / %u ms frame", (unsigned)TDMA_CMD_SLOT_US,
+           (unsigned)TDMA_TLM_SLOT_US, (unsigned)PROTO_CMD_INTERVAL_MS);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(LORA_CMD_AIRTIME_US, TDMA_CMD_SLOT_US);
+  TEST_ASSERT_GREATER_THAN(LORA_TLM_AIRTIME_US, TDMA_TLM_SLOT_US);
+  // 📶 Room for telemetry with the link trailer, not just the bare frame
+  TEST_ASSERT_GREATER_OR_EQUAL(TDMA_TURNAROUND_US + protoAirtimeUs(PROTO_TLM_PACKET_SIZE + LINK_TLM_TRAILER_SIZE,
+                                                                   CMD_IMPLICIT_HEADER),
+                               TDMA_TLM_SLOT_US);
+  TEST_ASSERT_TRUE(TDMA_FITS_INTERVAL);
+}
+
+// 🚨 Baseline: a free-running air side collides with the command stream
+void test_free_running_air_collides() {
+  SimResult r = simulate(false);
+  report("free-running", r);
+  TEST_ASSERT_GREATER_THAN(0, r.collisions);
+}
+
+#ifdef PROTO_BIDIRECTIONAL  // The telemetry slot only exists on a two-way link
+// ✅ Air answering in the telemetry slot: zero collisions, every frame heard
+void test_slotted_air_never_collides() {
+  SimResult r = simulate(true);
+  report("slotted", r);
+  TEST_ASSERT_EQUAL(0, r.collisions);
+  TEST_ASSERT_EQUAL(r.airFrames, r.delivered);
+  TEST_ASSERT_UINT32_WITHIN(2, SIM_DURATION_MS / PROTO_CMD_INTERVAL_MS, r.commands);
+  TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  TEST_ASSERT_TRUE(tlm_valid);
+}
+
+// ✅ A command slot that lands inside the telemetry slot waits for it to close
+void test_command_waits_for_telemetry_slot() {
+  LoRa.txDurationUs = PROTO_CMD_INTERVAL_MS * 1000UL - 1000;  // TX done 1 ms before the next tick
+  for (int i = 0; i < 3 * PROTO_CMD_INTERVAL_MS * 10; i++) {
+    hal_advanceMicros(SIM_STEP_US);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+
+  TEST_ASSERT_GREATER_THAN(0, radioStats().slotDeferred);
+  TEST_ASSERT_GREATER_OR_EQUAL(2, LoRa.sent.size());
+  for (size_t i = 1; i < LoRa.sent.size(); i++) {
+    unsigned long prevDoneUs = LoRa.sent[i - 1].atUs + LoRa.txDurationUs;
+    TEST_ASSERT_GREATER_OR_EQUAL(prevDoneUs + TDMA_TLM_SLOT_US, LoRa.sent[i].atUs);
+  }
+}
+#endif
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_slot_layout);
+  RUN_TEST(test_free_running_air_collides);
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_slotted_air_never_collides);
+  RUN_TEST(test_command_waits_for_telemetry_slot);
+#endif
+
+  return UNITY_END();
+}
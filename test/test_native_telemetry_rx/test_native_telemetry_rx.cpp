@@ -0,0 +1,149 @@
+#include <unity.h>
+
+// 📥 Interrupt-driven telemetry RX tests
+// Frames reach Lora.cpp only through the fake DIO0 RX-done callback; LoRaTask
+// runs only when notified, exactly like the firmware.
+
+#include <LoRa.h>
+
+#include "TelemetryRing.h"
+#include "common.h"
+#include "protocol.h"
+
+void setupRadio();
+void loraLoop();
+void loraStartScheduler(TaskHandle_t task);
+
+#ifdef PROTO_BIDIRECTIONAL  // Telemetry RX only exists on a two-way link
+extern float tlm_altitude;
+extern int tlm_rssi;
+extern bool tlm_valid;
+extern unsigned long tlm_lastReceived;
+extern int tlm_linkRssi;
+extern float tlm_linkSnr;
+
+static ProtoTlmPacket makeTelemetry(int16_t altitude_dm) {
+  ProtoTlmPacket p = {};
+  p.magic = PROTO_TLM_MAGIC;
+  p.altitude_dm = altitude_dm;
+  p.rssi = -70;
+  p.checksum = proto_checksum((const uint8_t*)&p, PROTO_TLM_PACKET_SIZE - 1);
+  return p;
+}
+
+// 💤 LoRaTask: run only when the timer / DIO0 notified it
+static void runLoRaTask(int ms) {
+  for (int t = 0; t < ms; t++) {
+    hal_advanceMillis(1);
+    if (hal_takeNotify(NULL))
+      loraLoop();
+  }
+}
+
+void setUp(void) {
+  hal_setMillis(1000);
+  LoRa.reset();
+  LoRa.txDurationUs = 0;
+  Serial.muted = true;
+  controlInit();
+  controlBeginWrite().ecoMode = false;  // Fixed PROTO_CMD_INTERVAL_MS slots
+  controlEndWrite();
+  tlm_valid = false;
+  setupRadio();
+  loraStartScheduler(NULL);
+  runLoRaTask(PROTO_CMD_INTERVAL_MS + 1);  // First TX done → radio back in receive()
+}
+
+void tearDown(void) {
+  Serial.muted = false;
+}
+
+// ✅ A frame is decoded from the ring without a single parsePacket() poll
+void test_rx_done_fills_ring_and_decodes() {
+  TEST_ASSERT_TRUE(LoRa.receiving);
+
+  ProtoTlmPacket p = makeTelemetry(1234);
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p), -88, 6.5f);
+  unsigned long arrivalMs = millis();
+  runLoRaTask(3);
+
+  TEST_ASSERT_TRUE(tlm_valid);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 123.4f, tlm_altitude);
+  TEST_ASSERT_EQUAL(-70, tlm_rssi);      // Air-side report
+  TEST_ASSERT_EQUAL(-88, tlm_linkRssi);  // Ground-side stamp
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.5f, tlm_linkSnr);
+  TEST_ASSERT_EQUAL(arrivalMs, tlm_lastReceived);  // Arrival time, not decode time
+  TEST_ASSERT_EQUAL(0, LoRa.parseCalls);
+  TEST_ASSERT_NULL(tlmRingPeek());
+}
+
+// ✅ Wrong size / bad checksum frames are consumed but rejected
+void test_corrupt_frames_rejected() {
+  ProtoTlmPacket p = makeTelemetry(50);
+  p.checksum ^= 0xFF;
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p));
+  runLoRaTask(1);
+  TEST_ASSERT_FALSE(tlm_valid);
+
+  p = makeTelemetry(50);
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p) - 1);
+  runLoRaTask(1);
+  TEST_ASSERT_FALSE(tlm_valid);
+  TEST_ASSERT_NULL(tlmRingPeek());
+}
+
+// ✅ Half duplex: frames arriving during our own TX are missed, then RX resumes
+void test_rx_resumes_after_tx_done() {
+  LoRa.txDurationUs = 20000;
+  runLoRaTask(PROTO_CMD_INTERVAL_MS);  // Next slot → TX on air for 20 ms
+  TEST_ASSERT_FALSE(LoRa.receiving);
+
+  ProtoTlmPacket p = makeTelemetry(10);
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p));
+  TEST_ASSERT_EQUAL(1, LoRa.missedRx);
+
+  runLoRaTask(25);  // TX done → receive()
+  TEST_ASSERT_TRUE(LoRa.receiving);
+  LoRa.injectRx((const uint8_t*)&p, sizeof(p));
+  runLoRaTask(1);
+  TEST_ASSERT_TRUE(tlm_valid);
+}
+
+#else
+void setUp(void) {}
+void tearDown(void) {}
+#endif
+
+// ✅ Ring keeps the oldest frames and counts drops when the consumer stalls
+void test_ring_bounded_in_order() {
+  tlmRingReset();
+  for (int i = 0; i < TLM_RING_SIZE; i++) {
+    TlmRxEntry* e = tlmRingReserve();
+    TEST_ASSERT_NOT_NULL(e);
+    e->len = (uint8_t)i;
+    tlmRingCommit();
+  }
+  TEST_ASSERT_NULL(tlmRingReserve());
+  TEST_ASSERT_EQUAL(1, tlmRingDropped());
+
+  for (int i = 0; i < TLM_RING_SIZE; i++) {
+    const TlmRxEntry* e = tlmRingPeek();
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL(i, e->len);
+    tlmRingPop();
+  }
+  TEST_ASSERT_NULL(tlmRingPeek());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_rx_done_fills_ring_and_decodes);
+  RUN_TEST(test_corrupt_frames_rejected);
+  RUN_TEST(test_rx_resumes_after_tx_done);
+#endif
+  RUN_TEST(test_ring_bounded_in_order);
+
+  return UNITY_END();
+}
@@ -0,0 +1,183 @@
+#include <unity.h>
+
+// 🔋 Closed-loop TX power (TxPower.h) in the channel simulator
+// The real LoRaTask next to a simulated flight board (ChannelSim.h): the air
+// hears an uplink frame only if the power it went out with
+// (LoRa.sent[].txPower) minus the path loss, ± fading, clears the receiver
+// sensitivity, and answers it with trailered telemetry carrying that RSSI.
+// The air always transmits at PROTO_LORA_TX_POWER.
+
+#include <ChannelSim.h>
+
+#include "DataRate.h"
+#include "TxPower.h"
+#include "protocol.h"
+
+#ifdef PROTO_BIDIRECTIONAL  // Margin comes from telemetry
+static float sensitivityDbm() {
+  return dataRateSensitivityDbm(proto_rate_profile(0));
+}
+
+void setUp(void) {
+  channelSimSetUp();
+  txPowerSetControl(true);
+}
+
+void tearDown(void) {
+  channelSimTearDown();
+  txPowerSetControl(false);
+}
+
+// ✅ Plane next to the ground station: power walks down to the floor, nothing lost
+void test_close_range_steps_down() {
+  for (int direct = 0; direct < 2; direct++) {
+    startSession(direct);
+    pathLossDb = 60.0f;
+    runFor(6000);
+
+    const TxPowerStats& s = txPowerStats();
+    TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, txPowerDbm());
+    TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, LoRa.txPower);  // Library / PA_CONFIG
+    TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, LoRa.sent.back().txPower);
+    TEST_ASSERT_EQUAL(0, s.stepsUp);
+    TEST_ASSERT_EQUAL(0, s.clamps);
+    TEST_ASSERT_EQUAL(0, sim.cmdLost);
+    TEST_ASSERT_GREATER_OR_EQUAL(TX_POWER_TARGET_MARGIN_DB, txPowerMarginDb());
+    TEST_ASSERT_EQUAL(0, LoRa.txAborts);
+  }
+}
+
+// ✅ Range grows: power follows, the uplink margin is held, nothing lost
+void test_holds_margin_as_range_grows() {
+  startSession(false);
+  pathLossDb = 95.0f;
+  runFor(6000);
+  const int8_t nearDbm = txPowerDbm();
+  TEST_ASSERT_LESS_THAN(TX_POWER_MAX_DBM, nearDbm);
+
+  float worstMargin = 100.0f;
+  for (int i = 0; i < 200; i++) {  // 95 → 135 dB over 20 s
+    pathLossDb += 0.2f;
+    runFor(100);
+    float m = txPowerDbm() - pathLossDb - sensitivityDbm();  // Uplink margin without fading
+    if (txPowerDbm() < TX_POWER_MAX_DBM && m < worstMargin)
+      worstMargin = m;
+  }
+
+  const TxPowerStats& s = txPowerStats();
+  TEST_ASSERT_EQUAL(TX_POWER_MAX_DBM, txPowerDbm());
+  TEST_ASSERT_GREATER_OR_EQUAL((uint32_t)(TX_POWER_MAX_DBM - nearDbm) / TX_POWER_STEP_DB, s.stepsUp);
+  TEST_ASSERT_GREATER_OR_EQUAL(TX_POWER_TARGET_MARGIN_DB - TX_POWER_STEP_DB, worstMargin);
+  TEST_ASSERT_EQUAL(0, s.clamps);
+  TEST_ASSERT_EQUAL(0, sim.cmdLost);
+}
+
+// 🚨 Sudden fade while at low power: loss burst → straight to max
+void test_fade_clamps_to_max() {
+  startSession(false);
+  pathLossDb = 60.0f;
+  runFor(6000);
+  TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, txPowerDbm());
+
+  pathLossDb = 125.0f;  // Lost at the floor, 13.5 dB of margin at max
+  const uint32_t lostBefore = sim.cmdLost;
+  runFor((TX_POWER_LOSS_BURST + 2) * PROTO_CMD_INTERVAL_MS);
+  TEST_ASSERT_EQUAL(TX_POWER_MAX_DBM, txPowerDbm());
+  TEST_ASSERT_EQUAL(1, txPowerStats().clamps);
+  TEST_ASSERT_LESS_OR_EQUAL(TX_POWER_LOSS_BURST + 1, sim.cmdLost - lostBefore);
+
+  const uint32_t lostAfterClamp = sim.cmdLost;
+  runFor(5000);  // Settles back into the band without losing anything
+  TEST_ASSERT_EQUAL(1, txPowerStats().clamps);
+  TEST_ASSERT_EQUAL(lostAfterClamp, sim.cmdLost);
+}
+
+// ✅ Flight board that doesn't report RSSI: downlink reciprocity alone still steps down
+void test_reciprocal_only() {
+  startSession(false);
+  air.reportsRssi = false;
+  pathLossDb = 60.0f;
+  runFor(6000);
+  TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, txPowerDbm());
+  TEST_ASSERT_EQUAL(0, sim.cmdLost);
+}
+
+// ✅ Control off: every frame at PROTO_LORA_TX_POWER
+void test_off_keeps_fixed_power() {
+  txPowerSetControl(false);
+  startSession(false);
+  pathLossDb = 60.0f;
+  runFor(3000);
+  TEST_ASSERT_EQUAL(PROTO_LORA_TX_POWER, txPowerDbm());
+  for (size_t i = 0; i < LoRa.sent.size(); i++)
+    TEST_ASSERT_EQUAL(PROTO_LORA_TX_POWER, LoRa.sent[i].txPower);
+  TEST_ASSERT_EQUAL(0, txPowerStats().stepsDown);
+}
+
+// 📊 Out-and-back flight: fixed power vs closed loop
+void test_flight_benchmark() {
+  struct Run {
+    SimStats sim;
+    TxPowerStats power;
+  } runs[2];
+  for (int controlled = 0; controlled < 2; controlled++) {
+    txPowerSetControl(controlled);
+    rng = 7;
+    startSession(false);
+    for (int i = 0; i < 600; i++) {  // 60 s: 60 dB → 130 dB at 30 s → back
+      float x = i < 300 ? i / 300.0f : (600 - i) / 300.0f;
+      pathLossDb = 60.0f + 70.0f * x;
+      runFor(100);
+    }
+    runs[controlled] = {sim, txPowerStats()};
+  }
+
+  const Run& fixed = runs[0];
+  const Run& loop = runs[1];
+  const float fixedMw = fixed.power.mwSum / fixed.power.frames;
+  const float loopMw = loop.power.mwSum / loop.power.frames;
+  char msg[256];
+  snprintf(msg, sizeof(msg),
+           "60 s flight: fixed %.1f mW mean, %u/%u uplink lost | closed loop %.1f mW mean (min %d dBm), %u/%u lost, "
+           "%u down / %u up / %u clamps",
+           fixedMw, (unsigned)fixed.sim.cmdLost, (unsigned)fixed.sim.cmdSent, loopMw, (int)loop.power.minDbm,
+           (unsigned)loop.sim.cmdLost, (unsigned)loop.sim.cmdSent, (unsigned)loop.power.stepsDown,
+           (unsigned)loop.power.stepsUp, (unsigned)loop.power.clamps);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_LESS_THAN(fixedMw / 4, loopMw);
+  TEST_ASSERT_LESS_OR_EQUAL(fixed.sim.cmdLost + TX_POWER_LOSS_BURST, loop.sim.cmdLost);
+  TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, loop.power.minDbm);
+}
+#else
+void setUp(void) {}
+void tearDown(void) {}
+
+// ✅ No telemetry to close the loop on: stays at PROTO_LORA_TX_POWER
+void test_without_telemetry_stays_at_max() {
+  txPowerReset();
+  txPowerSetControl(true);
+  for (int i = 0; i < 100; i++)
+    txPowerOnUplink();
+  TEST_ASSERT_EQUAL(-1, txPowerPendingDbm());
+  TEST_ASSERT_EQUAL(PROTO_LORA_TX_POWER, txPowerDbm());
+  txPowerSetControl(false);
+}
+#endif
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+
+#ifdef PROTO_BIDIRECTIONAL
+  RUN_TEST(test_close_range_steps_down);
+  RUN_TEST(test_holds_margin_as_range_grows);
+  RUN_TEST(test_fade_clamps_to_max);
+  RUN_TEST(test_reciprocal_only);
+  RUN_TEST(test_off_keeps_fixed_power);
+  RUN_TEST(test_flight_benchmark);
+#else
+  RUN_TEST(test_without_telemetry_stays_at_max);
+#endif
+
+  return UNITY_END();
+}